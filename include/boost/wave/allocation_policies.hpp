@@ -0,0 +1,97 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Definition of the token allocation policies
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_WAVE_ALLOCATION_POLICIES_HPP_3C7E5A92_8B14_4D6F_9E20_B1A4C6D8E2F3_INCLUDED)
+#define BOOST_WAVE_ALLOCATION_POLICIES_HPP_3C7E5A92_8B14_4D6F_9E20_B1A4C6D8E2F3_INCLUDED
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/token_arena.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace allocation_policies {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  global_pool
+//
+//      The default allocation policy: the context doesn't own any memory
+//      for its tokens, these are taken from the place selected by the token
+//      type, usually the process wide (and in threaded builds synchronized)
+//      memory pools, which keep the memory for reuse until the end of the
+//      program.
+//
+///////////////////////////////////////////////////////////////////////////////
+struct global_pool
+{
+    //  installed while the context is working, nothing to do
+    class scope
+    {
+    public:
+        explicit scope(global_pool &) {}
+    };
+
+    boost::wave::util::token_arena* get_arena() { return 0; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  context_arena
+//
+//      Tokens and token sequence nodes created while the context is working
+//      are taken from an arena owned by the context. No locks are involved,
+//      and all memory is released at once when the context is destroyed.
+//
+//      This applies to the token types allocating from the arena only, i.e.
+//      cpplexer::lex_token<PositionT, util::token_arena>, all other tokens
+//      are allocated as with the global_pool policy.
+//
+//      Note: tokens obtained from a context using this policy must not be
+//            used after the context has been destroyed.
+//
+///////////////////////////////////////////////////////////////////////////////
+class context_arena
+{
+public:
+    //  installs the arena for the current thread while the context is
+    //  working
+    class scope : public boost::wave::util::token_arena_scope
+    {
+    public:
+        explicit scope(context_arena &policy)
+        :   boost::wave::util::token_arena_scope(policy.get_arena())
+        {}
+    };
+
+    boost::wave::util::token_arena* get_arena() { return &arena; }
+
+private:
+    boost::wave::util::token_arena arena;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace allocation_policies
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_WAVE_ALLOCATION_POLICIES_HPP_3C7E5A92_8B14_4D6F_9E20_B1A4C6D8E2F3_INCLUDED)
@@ -16,12 +16,12 @@
 #include <vector>
 #include <stack>
 
+#include <boost/assert.hpp>
 #include <boost/concept_check.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/mpl/if.hpp>
 #include <boost/type_traits/is_same.hpp>
-#include <boost/pool/pool_alloc.hpp>
 
 #include <boost/wave/wave_config.hpp>
 #if BOOST_WAVE_SERIALIZATION != 0
@@ -31,16 +31,22 @@
 #include <boost/wave/token_ids.hpp>
 
 #include <boost/wave/util/unput_queue_iterator.hpp>
+#include <boost/wave/util/chunked_token_sequence.hpp>
 #include <boost/wave/util/cpp_ifblock.hpp>
 #include <boost/wave/util/cpp_include_paths.hpp>
 #include <boost/wave/util/iteration_context.hpp>
 #include <boost/wave/util/cpp_iterator.hpp>
 #include <boost/wave/util/cpp_macromap.hpp>
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+#include <boost/wave/util/cpp_expression_cache.hpp>
+#endif
 
 #include <boost/wave/preprocessing_hooks.hpp>
 #include <boost/wave/whitespace_handling.hpp>
 #include <boost/wave/cpp_iteration_context.hpp>
+#include <boost/wave/cpp_shared_resources.hpp>
 #include <boost/wave/language_support.hpp>
+#include <boost/wave/allocation_policies.hpp>
 
 // this must occur after all of the includes and before any code appears
 #ifdef BOOST_HAS_ABI_HEADERS
@@ -76,17 +82,52 @@ namespace wave {
 //                      type (if any). This template parameter is optional and
 //                      defaults to 'this_type', which means that the context
 //                      type will be used assuming no derived type exists.
+//      AllocationPolicyT
+//                      The policy deciding where tokens and token sequences
+//                      are allocated, if the token type allocates from the
+//                      util::token_arena. This template parameter is optional
+//                      and defaults to the
+//                          allocation_policies::global_pool
+//                      type.
+//
+//      Token lifetime: with the allocation policy
+//      allocation_policies::context_arena the memory of the tokens (and of
+//      the token sequences) generated by a context is owned by this context.
+//      These tokens (including all copies of them) become invalid when the
+//      context is destroyed and must not outlive it. Tokens allocated from
+//      the global pools aren't restricted this way.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
 struct this_type {};
 
+namespace impl {
+
+    // passes the text of the generated tokens to a sink (see
+    // context::preprocess_to())
+    template <typename SinkT>
+    struct sink_writer
+    {
+        explicit sink_writer(SinkT &sink_) : sink(sink_) {}
+
+        template <typename TokenT>
+        void operator()(TokenT const &token) const
+        {
+            typename TokenT::string_type const &value = token.get_value();
+            sink.write(value.data(), value.size());
+        }
+
+        SinkT &sink;
+    };
+}
+
 template <
     typename IteratorT,
     typename LexIteratorT,
     typename InputPolicyT = iteration_context_policies::load_file_to_string,
     typename HooksT = context_policies::eat_whitespace<typename LexIteratorT::token_type>,
-    typename DerivedT = this_type
+    typename DerivedT = this_type,
+    typename AllocationPolicyT = allocation_policies::global_pool
 >
 class context : private boost::noncopyable
 {
@@ -112,10 +153,11 @@ public:
     typedef typename token_type::position_type      position_type;
 
     // type of a token sequence
-    typedef std::list<token_type, boost::fast_pool_allocator<token_type> >
+    typedef typename boost::wave::util::default_token_sequence<token_type>::type
         token_sequence_type;
     // type of the policies
     typedef HooksT                                  hook_policy_type;
+    typedef AllocationPolicyT                       allocation_policy_type;
 
 private:
     // stack of shared_ptr's to the pending iteration contexts
@@ -150,7 +192,9 @@ public:
                     | support_option_insert_whitespace
                    ))
       , hooks(hooks_)
+      , resources(0)
     {
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
         macros.init_predefined_macros(fname);
     }
 
@@ -161,35 +205,89 @@ public:
     // iterator interface
     iterator_type begin()
     {
-        std::string fname(filename);
-        if (filename != "<Unknown>" && filename != "<stdin>") {
-            using namespace boost::filesystem;
-            path fpath(util::complete_path(path(filename)));
-            fname = fpath.string();
-        }
-        return iterator_type(*this, first, last, position_type(fname.c_str()));
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
+        return iterator_type(*this, first, last, get_initial_position());
     }
     iterator_type begin(
         target_iterator_type const &first_,
         target_iterator_type const &last_)
     {
-        std::string fname(filename);
-        if (filename != "<Unknown>" && filename != "<stdin>") {
-            using namespace boost::filesystem;
-            path fpath(util::complete_path(path(filename)));
-            fname = fpath.string();
-        }
-        return iterator_type(*this, first_, last_, position_type(fname.c_str()));
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
+        return iterator_type(*this, first_, last_, get_initial_position());
     }
     iterator_type end() const
         { return iterator_type(); }
 
+    // push interface: preprocess the whole input given to the constructor,
+    // passing every generated token to consumer(token), without the overhead
+    // of the iterators (see also pp_iterator::run())
+    template <typename ConsumerT>
+    void run(ConsumerT &&consumer)
+    {
+        typedef typename iterator_type::input_policy_type functor_type;
+
+        functor_type functor(make_functor());
+        for (;;) {
+            token_type const &token = functor();
+            if (token == functor_type::eof)
+                break;
+            consumer(token);
+        }
+    }
+
+    // the same, passing the tokens in batches of (up to) batch_size tokens
+    // to consumer(std::vector<token_type> const &)
+    template <typename ConsumerT>
+    void run_batched(ConsumerT &&consumer, std::size_t batch_size = 1024)
+    {
+        typedef typename iterator_type::input_policy_type functor_type;
+
+        BOOST_ASSERT(batch_size > 0);
+        std::vector<token_type> batch;
+        std::vector<token_type> const &tokens = batch;
+        batch.reserve(batch_size);
+
+        functor_type functor(make_functor());
+        for (;;) {
+            token_type const &token = functor();
+            if (token == functor_type::eof)
+                break;
+            batch.push_back(token);
+            if (batch.size() == batch_size) {
+                consumer(tokens);
+                batch.clear();
+            }
+        }
+        if (!batch.empty())
+            consumer(tokens);
+    }
+
+    // preprocess the whole input, passing the text of all generated tokens to
+    // the given sink, which has to provide a member function
+    // 'write(char const *, std::size_t)' (f.e. util::output_sink)
+    template <typename SinkT>
+    void preprocess_to(SinkT &sink)
+    {
+        run(impl::sink_writer<SinkT>(sink));
+    }
+
     // maintain include paths
     bool add_include_path(char const *path_)
         { return includes.add_include_path(path_, false);}
     bool add_sysinclude_path(char const *path_)
         { return includes.add_include_path(path_, true);}
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+    bool add_header_map(char const *file_, bool is_system = false)
+        { return includes.add_header_map(file_, is_system);}
+#endif
     void set_sysinclude_delimiter() { includes.set_sys_include_delimiter(); }
+    // the directory relative paths (of the main file and of the include
+    // paths added afterwards) are completed against, defaults to the initial
+    // directory of the program
+    void set_base_directory(boost::filesystem::path const &dir)
+        { includes.set_base_directory(dir); }
+    boost::filesystem::path const &get_base_directory() const
+        { return includes.get_base_directory(); }
     typename iteration_context_stack_type::size_type get_iteration_depth() const
         { return iter_ctxs.size(); }
 
@@ -198,6 +296,7 @@ public:
     template <typename StringT>
     bool add_macro_definition(StringT macrostring, bool is_predefined = false)
     {
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
         return boost::wave::util::add_macro_definition(*this,
             util::to_string<std::string>(macrostring), is_predefined,
             get_language());
@@ -209,6 +308,7 @@ public:
         bool has_params, std::vector<token_type> &parameters,
         token_sequence_type &definition, bool is_predefined = false)
     {
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
         return macros.add_macro(
             token_type(T_IDENTIFIER, util::to_string<string_type>(name), pos),
             has_params, parameters, definition, is_predefined);
@@ -243,10 +343,24 @@ public:
         includes.remove_pragma_once_header(
             util::to_string<std::string>(name));
 #endif
+        // the directives only mode passes the macros undefined before
+        // preprocessing started (as on the command line) through
+        if (!has_been_initialized)
+            undefined_macros.push_back(name);
         return macros.remove_macro(name, macros.get_main_pos(), even_predefined);
     }
     void reset_macro_definitions()
-        { macros.reset_macromap(); macros.init_predefined_macros(); }
+    {
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
+        undefined_macros.clear();
+        macros.reset_macromap();
+
+        // the memory of the token arena (if any) is reused, if none of the
+        // tokens allocated from it is referenced anymore
+        if (boost::wave::util::token_arena* arena = get_token_arena())
+            arena->rewind();
+        macros.init_predefined_macros();
+    }
 
     // Iterate over names of defined macros
     typedef boost::wave::util::macromap<context> macromap_type;
@@ -264,6 +378,7 @@ public:
         std::vector<token_type> &parameters, token_sequence_type &definition,
         bool is_predefined = false)
     {
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
         return macros.add_macro(name, has_params, parameters, definition,
             is_predefined);
     }
@@ -302,6 +417,12 @@ public:
     // access the policies
     hook_policy_type &get_hooks() { return hooks; }
     hook_policy_type const &get_hooks() const { return hooks; }
+    allocation_policy_type &get_allocation_policy() { return allocation_policy; }
+
+    // the arena tokens are allocated from while this context is working
+    // (if any)
+    boost::wave::util::token_arena* get_token_arena()
+        { return allocation_policy.get_arena(); }
 
     // return type of actually used context type (might be the derived type)
     actual_context_type& derived()
@@ -327,13 +448,40 @@ protected:
             std::string fname(filename);
             if (filename != "<Unknown>" && filename != "<stdin>") {
                 using namespace boost::filesystem;
-                path fpath(util::complete_path(path(filename)));
+                path fpath(util::complete_path(path(filename),
+                    includes.get_base_directory()));
                 fname = fpath.string();
                 includes.set_current_directory(fname.c_str());
             }
             has_been_initialized = true;  // execute once
         }
     }
+    bool is_initialized() const { return has_been_initialized; }
+
+    // the names of the macros undefined before preprocessing started
+    std::vector<string_type> const &get_undefined_macros() const
+        { return undefined_macros; }
+
+    // the position at the beginning of the main file
+    position_type get_initial_position() const
+    {
+        std::string fname(filename);
+        if (filename != "<Unknown>" && filename != "<stdin>") {
+            using namespace boost::filesystem;
+            path fpath(util::complete_path(path(filename),
+                includes.get_base_directory()));
+            fname = fpath.string();
+        }
+        return position_type(fname.c_str());
+    }
+
+    // the functor generating the tokens (wrapped by the iterators)
+    typename iterator_type::input_policy_type make_functor()
+    {
+        typename allocation_policy_type::scope arena_scope(allocation_policy);
+        return typename iterator_type::input_policy_type(*this, first, last,
+            get_initial_position());
+    }
 
     template <typename IteratorT2>
     bool is_defined_macro(IteratorT2 const &begin, IteratorT2 const &end) const
@@ -434,6 +582,50 @@ public:
         char const *current_file) const
     { return includes.find_include_file(s, d, is_system, current_file); }
 
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+    // access the cache of evaluated #if/#elif expressions (f.e. to disable it
+    // or to retrieve its hit rate)
+    boost::wave::util::conditional_expression_cache &
+        get_conditional_expression_cache() { return condexpr_cache; }
+    boost::wave::util::conditional_expression_cache const &
+        get_conditional_expression_cache() const { return condexpr_cache; }
+#endif
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    // access the cache of the include file lookups (also used for
+    // __has_include)
+    boost::wave::util::include_lookup_cache &
+        get_include_lookup_cache() { return includes.get_lookup_cache(); }
+    boost::wave::util::include_lookup_cache const &
+        get_include_lookup_cache() const { return includes.get_lookup_cache(); }
+
+    // keep the include file lookups across runs in the given database
+    void set_include_database(boost::wave::util::include_database *database_)
+        { includes.set_include_database(database_); }
+    boost::wave::util::include_database *get_include_database() const
+        { return includes.get_include_database(); }
+#endif
+
+    // use the caches of the given object, which may be shared with other
+    // (concurrently running) contexts, the object isn't owned by the context
+    void set_shared_resources(boost::wave::shared_resources *resources_)
+    {
+        resources = resources_;
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        includes.set_shared_resources(resources_);
+#endif
+    }
+    boost::wave::shared_resources *get_shared_resources() const
+        { return resources; }
+
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+    // access the snapshots of the contents of the include directories
+    boost::wave::util::directory_snapshots &
+        get_directory_snapshots() { return includes.get_directory_snapshots(); }
+    boost::wave::util::directory_snapshots const &
+        get_directory_snapshots() const { return includes.get_directory_snapshots(); }
+#endif
+
 #if BOOST_WAVE_SERIALIZATION != 0
 public:
     BOOST_STATIC_CONSTANT(unsigned int, version = 0x10);
@@ -511,11 +703,16 @@ private:
 #endif
 
 private:
+    // must be declared first, as it may own the memory of the tokens held by
+    // all the members below
+    allocation_policy_type allocation_policy;
+
     // the main input stream
     target_iterator_type first;         // underlying input stream
     target_iterator_type last;
     std::string filename;               // associated main filename
     bool has_been_initialized;          // set cwd once
+    std::vector<string_type> undefined_macros;    // before preprocessing started
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
     std::string current_filename;       // real name of current preprocessed file
 #endif
@@ -527,6 +724,10 @@ private:
     macromap_type macros;                         // map of defined macros
     boost::wave::language_support language;       // supported language/extensions
     hook_policy_type hooks;                       // hook policy instance
+    boost::wave::shared_resources *resources;     // caches shared with other contexts
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+    boost::wave::util::conditional_expression_cache condexpr_cache; // results of #if/#elif
+#endif
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -22,6 +22,8 @@
 #include <boost/wave/cpp_exceptions.hpp>
 #include <boost/wave/language_support.hpp>
 #include <boost/wave/util/file_position.hpp>
+#include <boost/wave/util/cpp_directive_minimizer.hpp>
+#include <boost/wave/cpp_shared_resources.hpp>
 // #include <boost/spirit/include/iterator/classic_multi_pass.hpp> // make_multi_pass
 
 // this must occur after all of the includes and before any code appears
@@ -63,18 +65,99 @@ namespace iteration_context_policies {
             {
                 typedef typename IterContextT::iterator_type iterator_type;
 
-                // read in the file
-                boost::filesystem::ifstream instream(iter_ctx.filename.c_str());
-                if (!instream.is_open()) {
+                // read in the file (or take it from the shared file cache)
+                shared_resources *resources =
+                    iter_ctx.ctx.get_shared_resources();
+                if (0 != resources) {
+                    if (!resources->load_file(iter_ctx.filename.c_str(),
+                        iter_ctx.instring))
+                    {
+                        BOOST_WAVE_THROW_CTX(iter_ctx.ctx, preprocess_exception,
+                            bad_include_file, iter_ctx.filename.c_str(),
+                            act_pos);
+                        return;
+                    }
+                }
+                else {
+                    boost::filesystem::ifstream instream(
+                        iter_ctx.filename.c_str());
+                    if (!instream.is_open()) {
+                        BOOST_WAVE_THROW_CTX(iter_ctx.ctx, preprocess_exception,
+                            bad_include_file, iter_ctx.filename.c_str(),
+                            act_pos);
+                        return;
+                    }
+                    instream.unsetf(std::ios::skipws);
+
+                    iter_ctx.instring.assign(
+                        std::istreambuf_iterator<char>(instream.rdbuf()),
+                        std::istreambuf_iterator<char>());
+                }
+
+                iter_ctx.first = iterator_type(
+                    iter_ctx.instring.begin(), iter_ctx.instring.end(),
+                    PositionT(iter_ctx.filename), language);
+                iter_ctx.last = iterator_type();
+            }
+
+        private:
+            std::string instring;
+        };
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //
+    //  load_minimized_file_to_string
+    //
+    //      Loads a file into a string as load_file_to_string does. While
+    //      scanning for the dependencies (see support_option_scan_dependencies)
+    //      the string holds the minimized file instead, which contains its
+    //      directives only (see util::minimize_directives). The minimized
+    //      files are cached by the shared_resources of the context, if any.
+    //
+    ///////////////////////////////////////////////////////////////////////////
+    struct load_minimized_file_to_string
+    {
+        template <typename IterContextT>
+        class inner
+        {
+        public:
+            template <typename PositionT>
+            static void init_iterators(IterContextT &iter_ctx,
+                PositionT const &act_pos, language_support language)
+            {
+                typedef typename IterContextT::iterator_type iterator_type;
+
+                // read in the file (or take it from the shared file cache)
+                shared_resources *resources =
+                    iter_ctx.ctx.get_shared_resources();
+                bool loaded = false;
+                if (!need_scan_dependencies(language)) {
+                    loaded = (0 != resources) ?
+                        resources->load_file(iter_ctx.filename.c_str(),
+                            iter_ctx.instring) :
+                        shared_resources::read_file(iter_ctx.filename.c_str(),
+                            iter_ctx.instring);
+                }
+                else if (0 != resources) {
+                    loaded = resources->load_minimized_file(
+                        iter_ctx.filename.c_str(), iter_ctx.instring,
+                        util::need_raw_string_literals(language));
+                }
+                else {
+                    std::string original;
+                    loaded = shared_resources::read_file(
+                        iter_ctx.filename.c_str(), original);
+                    if (loaded) {
+                        util::minimize_directives(original, iter_ctx.instring,
+                            util::need_raw_string_literals(language));
+                    }
+                }
+                if (!loaded) {
                     BOOST_WAVE_THROW_CTX(iter_ctx.ctx, preprocess_exception,
                         bad_include_file, iter_ctx.filename.c_str(), act_pos);
                     return;
                 }
-                instream.unsetf(std::ios::skipws);
-
-                iter_ctx.instring.assign(
-                    std::istreambuf_iterator<char>(instream.rdbuf()),
-                    std::istreambuf_iterator<char>());
 
                 iter_ctx.first = iterator_type(
                     iter_ctx.instring.begin(), iter_ctx.instring.end(),
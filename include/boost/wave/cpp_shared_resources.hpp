@@ -0,0 +1,670 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Caches shared between (concurrently running) preprocessing contexts
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_SHARED_RESOURCES_HPP_7A2E5C91_D03B_4E86_A1F4_6B58C2E9D730_INCLUDED)
+#define BOOST_CPP_SHARED_RESOURCES_HPP_7A2E5C91_D03B_4E86_A1F4_6B58C2E9D730_INCLUDED
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <atomic>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/cpp_include_lookup_cache.hpp>
+#include <boost/wave/util/cpp_directive_minimizer.hpp>
+#include <boost/wave/util/binary_file_io.hpp>
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+#endif
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The class shared_resources holds the caches, which may be shared between
+//  several contexts preprocessing different translation units, possibly in
+//  parallel on different threads (if BOOST_WAVE_SUPPORT_THREADING is defined
+//  to something != 0). A context uses these after a call to its function
+//  'set_shared_resources()':
+//
+//      - the contents of the included files, which are read from disk once
+//        (if the context uses the load_file_to_string input policy),
+//      - the minimized contents of the included files (see the function
+//        minimize_directives) used while scanning for the dependencies (if
+//        the context uses the load_minimized_file_to_string input policy),
+//      - the results of the include file lookups, kept separately for every
+//        list of include directories (if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS is
+//        defined to something != 0) and the results of the checks, whether a
+//        candidate file exists.
+//
+//      All of the cached data is stored as std::string, which doesn't share
+//      its buffer between copies, so the contexts never share any data
+//      through these caches. Everything else a context uses is either owned
+//      by the context or safe to use from several threads at once:
+//
+//      - the token data and the token sequences are allocated from pools
+//        protected by a mutex (or from the token_arena of the context, if
+//        the token type allocates from it),
+//      - the Spirit.Classic grammars used by Wave protect their definitions
+//        by locks (BOOST_SPIRIT_THREADSAFE is defined by wave_config.hpp),
+//      - the re2c lexer builds the cache of the constant token values once
+//        per thread.
+//
+//      Every context itself must be used by one thread at a time only.
+//
+//      As the contexts, the caches assume, that the files and directories
+//      don't change while being used. A long running process (f.e. a
+//      preprocessing server) calls the function 'revalidate()' between its
+//      tasks: afterwards, every cached item is checked once before it's used
+//      again. A file is read again, if its modification time or its size
+//      changed, the include file lookups and the checks for the candidate
+//      files are repeated, if one of the directories (or header maps) these
+//      depend on was modified. As the modification times have a resolution
+//      of one second only, an item read during the second its file or
+//      directory was modified isn't trusted.
+//
+//      By default the caches grow without limit. The function
+//      'set_max_size()' bounds the memory used by every one of them: if a
+//      cache exceeds the limit, the items used least recently are removed
+//      until it is down to 90% of it.
+//      The function 'clear()' drops all of the cached items at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+class shared_resources : private boost::noncopyable
+{
+public:
+    typedef boost::wave::util::include_lookup_cache::resolution resolution;
+
+    shared_resources()
+    :   generation(0), ticks(0), max_size(0),
+        files_bytes(0), minimized_bytes(0), resolutions_bytes(0),
+        probes_bytes(0),
+        file_hits(0), file_misses(0), minimized_hits(0), minimized_misses(0),
+        resolution_hits(0),
+        resolution_misses(0), probe_hits(0), probe_misses(0), invalidated(0),
+        evicted(0)
+    {}
+
+    ///////////////////////////////////////////////////////////////////////////
+    // limit the (approximate) memory used by every one of the caches to the
+    // given number of bytes (0: no limit, the default), must be called before
+    // the object is used
+    void set_max_size(std::size_t max_size_)
+    {
+        max_size = max_size_;
+    }
+    std::size_t get_max_size() const { return max_size; }
+
+    // remove all of the cached items (the contexts running meanwhile may or
+    // may not find the items cached before the call)
+    void clear()
+    {
+        clear_map(files, files_mtx, files_bytes);
+        clear_map(minimized, minimized_mtx, minimized_bytes);
+        clear_map(resolutions, resolutions_mtx, resolutions_bytes);
+        clear_map(probes, probes_mtx, probes_bytes);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // check all of the cached items against the file system before these are
+    // used the next time (the contexts running meanwhile may or may not see
+    // the modifications made before the call)
+    void revalidate()
+    {
+        ++generation;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // retrieve the contents of the given (normalized) file, read it if it's
+    // not cached yet, returns false if the file can't be read
+    bool load_file(std::string const &filename, std::string &content)
+    {
+        if (find_file(files, files_mtx, files_bytes, filename, filename,
+                content))
+        {
+            ++file_hits;
+            return true;
+        }
+        ++file_misses;
+
+        // read the file without holding the lock
+        cached_file loaded(filename);
+        boost::shared_ptr<std::string> loaded_content(new std::string);
+        if (!read_file(filename, *loaded_content))
+            return false;
+        loaded.content = loaded_content;
+        loaded.generation = generation;
+        loaded.used.touch(ticks);
+
+        write_lock_type lock(files_mtx);
+        content = *insert_entry(files, files_bytes, filename, loaded).content;
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // retrieve the minimized contents of the given (normalized) file, these
+    // are made from the cached contents, if available, or from the file
+    // (which isn't cached then), returns false if the file can't be read
+    bool load_minimized_file(std::string const &filename,
+        std::string &content, bool raw_strings)
+    {
+        std::string key(filename);
+        key += raw_strings ? "\2R" : "\2";
+        if (find_file(minimized, minimized_mtx, minimized_bytes, key,
+                filename, content))
+        {
+            ++minimized_hits;
+            return true;
+        }
+        ++minimized_misses;
+
+        // the stamp of the original file is valid for the minimized contents
+        cached_file result;
+        std::string original;
+        bool found = false;
+        {
+            read_lock_type lock(files_mtx);
+            file_map_type::const_iterator it = files.find(filename);
+            if (it != files.end() && (*it).second.generation == generation) {
+                original = *(*it).second.content;
+                result = (*it).second;
+                found = true;
+            }
+        }
+        if (!found) {
+            result = cached_file(filename);
+            if (!read_file(filename, original))
+                return false;
+        }
+
+        boost::shared_ptr<std::string> minimized_content(new std::string);
+        boost::wave::util::minimize_directives(original, *minimized_content,
+            raw_strings);
+        result.content = minimized_content;
+        result.generation = generation;
+        result.used.touch(ticks);
+
+        write_lock_type lock(minimized_mtx);
+        content = *insert_entry(minimized, minimized_bytes, key, result).content;
+        return true;
+    }
+
+    // read the contents of the given file, returns false if the file can't
+    // be read
+    static bool read_file(std::string const &filename, std::string &content)
+    {
+        boost::filesystem::ifstream instream(filename.c_str());
+        if (!instream.is_open())
+            return false;
+        instream.unsetf(std::ios::skipws);
+
+        content.assign(std::istreambuf_iterator<char>(instream.rdbuf()),
+            std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // look up the result of the include file lookup with the given key (see
+    // include_lookup_cache) for the given include directories (see
+    // include_paths)
+    bool find_resolution(std::string const &configuration,
+        std::string const &key, resolution &result)
+    {
+        std::string full_key(make_key(configuration, key));
+        if (!find_entry(resolutions, resolutions_mtx, resolutions_bytes,
+                full_key, result))
+        {
+            ++resolution_misses;
+            return false;
+        }
+        ++resolution_hits;
+        return true;
+    }
+
+    // the result depends on the contents of the given directories (or header
+    // maps)
+    void insert_resolution(std::string const &configuration,
+        std::string const &key, resolution const &result,
+        std::vector<std::string> const &dependencies)
+    {
+        std::string full_key(make_key(configuration, key));
+        resolution_entry entry(result, generation);
+        entry.used.touch(ticks);
+        for (std::size_t i = 0; i < dependencies.size(); ++i)
+            entry.dependencies.push_back(get_dependency(dependencies[i]));
+
+        write_lock_type lock(resolutions_mtx);
+        insert_entry(resolutions, resolutions_bytes, full_key, entry);
+    }
+
+    // look up, whether the given candidate file was found to be includable
+    bool find_probe(std::string const &candidate, bool &includable)
+    {
+        if (!find_entry(probes, probes_mtx, probes_bytes, candidate,
+                includable))
+        {
+            ++probe_misses;
+            return false;
+        }
+        ++probe_hits;
+        return true;
+    }
+    void insert_probe(std::string const &candidate, bool includable)
+    {
+        namespace fs = boost::filesystem;
+
+        // the result depends on the contents of the innermost existing
+        // directory containing the candidate file
+        probe_entry entry(includable, generation);
+        entry.used.touch(ticks);
+        boost::system::error_code ec;
+        fs::path dir(fs::path(candidate).parent_path());
+        while (!dir.empty() && !fs::is_directory(dir, ec))
+            dir = dir.parent_path();
+        if (!dir.empty())
+            entry.dependencies.push_back(get_dependency(dir.string()));
+
+        write_lock_type lock(probes_mtx);
+        insert_entry(probes, probes_bytes, candidate, entry);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // statistics, the sizes must not be queried while the object is in use
+    std::size_t files_size() const { return files.size(); }
+    std::size_t get_file_hits() const { return file_hits; }
+    std::size_t get_file_misses() const { return file_misses; }
+    std::size_t minimized_size() const { return minimized.size(); }
+    std::size_t get_minimized_hits() const { return minimized_hits; }
+    std::size_t get_minimized_misses() const { return minimized_misses; }
+    std::size_t resolutions_size() const { return resolutions.size(); }
+    std::size_t get_resolution_hits() const { return resolution_hits; }
+    std::size_t get_resolution_misses() const { return resolution_misses; }
+    std::size_t probes_size() const { return probes.size(); }
+    std::size_t get_probe_hits() const { return probe_hits; }
+    std::size_t get_probe_misses() const { return probe_misses; }
+    // the number of items found to be outdated by the revalidation
+    std::size_t get_invalidated() const { return invalidated; }
+    // the number of items removed to keep the caches within their limit
+    std::size_t get_evicted() const { return evicted; }
+    // the (approximate) memory used by all of the caches
+    std::size_t cached_bytes() const
+    {
+        return files_bytes + minimized_bytes + resolutions_bytes +
+            probes_bytes;
+    }
+
+private:
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    typedef boost::shared_mutex mutex_type;
+    typedef boost::shared_lock<mutex_type> read_lock_type;
+    typedef boost::unique_lock<mutex_type> write_lock_type;
+#else
+    struct mutex_type {};
+    struct read_lock_type { explicit read_lock_type(mutex_type &) {} };
+    typedef read_lock_type write_lock_type;
+#endif
+
+    // the lookups are valid for the same include directories only
+    static std::string make_key(std::string const &configuration,
+        std::string const &key)
+    {
+        std::string full_key(configuration);
+        full_key += '\2';
+        full_key += key;
+        return full_key;
+    }
+
+    // the tick of the last access to a cached item, updated by the lookups
+    // holding a read lock only
+    class access_tick
+    {
+    public:
+        access_tick() : tick(0) {}
+        access_tick(access_tick const &rhs) : tick(rhs.get()) {}
+        access_tick &operator=(access_tick const &rhs)
+        {
+            tick.store(rhs.get(), std::memory_order_relaxed);
+            return *this;
+        }
+
+        void touch(boost::detail::atomic_count &ticks) const
+        {
+            tick.store(++ticks, std::memory_order_relaxed);
+        }
+        long get() const { return tick.load(std::memory_order_relaxed); }
+
+    private:
+        mutable std::atomic<long> tick;
+    };
+
+    // the stamp of a file taken just before it was read, a file modified
+    // during the second it was read isn't trusted
+    struct cached_file
+    {
+        cached_file()
+        :   mtime(-1), size(0), read(0), generation(0)
+        {}
+        explicit cached_file(std::string const &filename)
+        :   mtime(util::binary_file_io::modification_time(filename)),
+            size(file_size(filename)), read(std::time(0)), generation(0)
+        {}
+
+        bool is_current(std::string const &filename) const
+        {
+            return -1 != mtime && mtime < read &&
+                mtime == util::binary_file_io::modification_time(filename) &&
+                size == file_size(filename);
+        }
+
+        static boost::uintmax_t file_size(std::string const &filename)
+        {
+            boost::system::error_code ec;
+            return boost::filesystem::file_size(
+                boost::filesystem::path(filename), ec);
+        }
+
+        boost::shared_ptr<std::string const> content;
+        boost::int64_t mtime;
+        boost::uintmax_t size;
+        boost::int64_t read;
+        long generation;                // the generation it was checked in
+        access_tick used;               // the last access
+    };
+
+    // the directories (or header maps) the lookups depend on, the version is
+    // incremented whenever one of these is found to be modified
+    struct directory
+    {
+        explicit directory(std::string const &path_)
+        :   path(path_), mtime(util::binary_file_io::modification_time(path_)),
+            recorded(std::time(0)), version(0), generation(0)
+        {}
+
+        std::string path;
+        boost::int64_t mtime;
+        boost::int64_t recorded;
+        unsigned long version;
+        long generation;                // the generation it was checked in
+    };
+    typedef std::pair<std::size_t, unsigned long> dependency;
+
+    template <typename ValueT>
+    struct dependent_entry
+    {
+        dependent_entry(ValueT const &value_, long generation_)
+        :   value(value_), generation(generation_)
+        {}
+
+        ValueT value;
+        std::vector<dependency> dependencies;
+        long generation;                // the generation it was checked in
+        access_tick used;               // the last access
+    };
+    typedef dependent_entry<resolution> resolution_entry;
+    typedef dependent_entry<bool> probe_entry;
+
+    typedef boost::unordered_map<std::string, cached_file> file_map_type;
+    typedef boost::unordered_map<std::string, resolution_entry>
+        resolution_map_type;
+    typedef boost::unordered_map<std::string, probe_entry> probe_map_type;
+
+    // the (approximate) memory used by a cached item
+    static std::size_t entry_size(std::string const &key,
+        cached_file const &entry)
+    {
+        return sizeof(cached_file) + key.size() + entry.content->size();
+    }
+    template <typename ValueT>
+    static std::size_t entry_size(std::string const &key,
+        dependent_entry<ValueT> const &entry)
+    {
+        return sizeof(dependent_entry<ValueT>) + key.size() +
+            value_size(entry.value) +
+            entry.dependencies.size() * sizeof(dependency);
+    }
+    static std::size_t value_size(resolution const &value)
+    {
+        return value.file.size() + value.dir.size();
+    }
+    static std::size_t value_size(bool) { return 0; }
+
+    // insert an item into a cache (which must be locked for writing), if the
+    // cache exceeds its limit, the least recently used items are removed,
+    // returns the (previously) cached item
+    template <typename MapT>
+    typename MapT::mapped_type insert_entry(MapT &map, std::size_t &bytes,
+        std::string const &key, typename MapT::mapped_type const &entry)
+    {
+        std::pair<typename MapT::iterator, bool> inserted =
+            map.insert(typename MapT::value_type(key, entry));
+        typename MapT::mapped_type const result((*inserted.first).second);
+        if (inserted.second) {
+            bytes += entry_size(key, entry);
+            if (0 != max_size && bytes > max_size)
+                shrink(map, bytes);
+        }
+        return result;
+    }
+
+    // remove the items accessed least recently until the cache
+    // (which must be locked for writing) is down to 90% of its limit
+    template <typename MapT>
+    void shrink(MapT &map, std::size_t &bytes)
+    {
+        typedef std::pair<long, typename MapT::iterator> item_type;
+        std::vector<item_type> items;
+        items.reserve(map.size());
+        for (typename MapT::iterator it = map.begin(); it != map.end(); ++it)
+            items.push_back(item_type((*it).second.used.get(), it));
+        std::sort(items.begin(), items.end(), older_item<item_type>);
+
+        std::size_t const limit = max_size / 10 * 9;
+        for (std::size_t i = 0; i < items.size() && bytes > limit; ++i) {
+            bytes -= entry_size((*items[i].second).first,
+                (*items[i].second).second);
+            map.erase(items[i].second);
+            ++evicted;
+        }
+    }
+    template <typename ItemT>
+    static bool older_item(ItemT const &lhs, ItemT const &rhs)
+    {
+        return lhs.first < rhs.first;
+    }
+
+    template <typename MapT>
+    static void clear_map(MapT &map, mutex_type &mtx, std::size_t &bytes)
+    {
+        write_lock_type lock(mtx);
+        map.clear();
+        bytes = 0;
+    }
+
+    // look up a cached file, which is checked against the file system once
+    // per generation
+    bool find_file(file_map_type &map, mutex_type &mtx, std::size_t &bytes,
+        std::string const &key, std::string const &filename,
+        std::string &content)
+    {
+        cached_file cached;
+        {
+            read_lock_type lock(mtx);
+            file_map_type::const_iterator it = map.find(key);
+            if (it == map.end())
+                return false;
+            if ((*it).second.generation == generation) {
+                (*it).second.used.touch(ticks);
+                content = *(*it).second.content;
+                return true;
+            }
+            cached = (*it).second;
+        }
+
+        bool const current = cached.is_current(filename);
+
+        write_lock_type lock(mtx);
+        file_map_type::iterator it = map.find(key);
+        if (it == map.end())
+            return false;
+        if (!current) {
+            bytes -= entry_size((*it).first, (*it).second);
+            map.erase(it);
+            ++invalidated;
+            return false;
+        }
+        (*it).second.generation = generation;
+        (*it).second.used.touch(ticks);
+        content = *(*it).second.content;
+        return true;
+    }
+
+    // look up a cached lookup result, the directories it depends on are
+    // checked against the file system once per generation
+    template <typename MapT, typename ValueT>
+    bool find_entry(MapT &map, mutex_type &mtx, std::size_t &bytes,
+        std::string const &key, ValueT &value)
+    {
+        std::vector<dependency> dependencies;
+        {
+            read_lock_type lock(mtx);
+            typename MapT::const_iterator it = map.find(key);
+            if (it == map.end())
+                return false;
+            if ((*it).second.generation == generation) {
+                (*it).second.used.touch(ticks);
+                value = (*it).second.value;
+                return true;
+            }
+            dependencies = (*it).second.dependencies;
+        }
+
+        bool const current = are_current(dependencies);
+
+        write_lock_type lock(mtx);
+        typename MapT::iterator it = map.find(key);
+        if (it == map.end())
+            return false;
+        if (!current) {
+            bytes -= entry_size((*it).first, (*it).second);
+            map.erase(it);
+            ++invalidated;
+            return false;
+        }
+        (*it).second.generation = generation;
+        (*it).second.used.touch(ticks);
+        value = (*it).second.value;
+        return true;
+    }
+
+    dependency get_dependency(std::string const &path)
+    {
+        write_lock_type lock(directories_mtx);
+        boost::unordered_map<std::string, std::size_t>::iterator it =
+            directory_index.find(path);
+        if (it == directory_index.end()) {
+            it = directory_index.insert(std::make_pair(path,
+                directories.size())).first;
+            directories.push_back(directory(path));
+            directories.back().generation = generation;
+        }
+        return dependency((*it).second, directories[(*it).second].version);
+    }
+
+    bool are_current(std::vector<dependency> const &dependencies)
+    {
+        write_lock_type lock(directories_mtx);
+        bool current = true;
+        for (std::size_t i = 0; i < dependencies.size(); ++i) {
+            directory &dir = directories[dependencies[i].first];
+            if (dir.generation != generation) {
+                boost::int64_t mtime =
+                    util::binary_file_io::modification_time(dir.path);
+                if (-1 == mtime || mtime != dir.mtime ||
+                    dir.mtime >= dir.recorded)
+                {
+                    ++dir.version;
+                    dir.mtime = mtime;
+                    dir.recorded = std::time(0);
+                }
+                dir.generation = generation;
+            }
+            current = current && dir.version == dependencies[i].second;
+        }
+        return current;
+    }
+
+    boost::detail::atomic_count generation;
+    boost::detail::atomic_count ticks;  // counts the accesses of the items
+    std::size_t max_size;               // the limit of every cache (if any)
+
+    file_map_type files;
+    file_map_type minimized;
+    resolution_map_type resolutions;
+    probe_map_type probes;
+    std::vector<directory> directories;
+    boost::unordered_map<std::string, std::size_t> directory_index;
+    mutex_type files_mtx;
+    mutex_type minimized_mtx;
+    mutex_type resolutions_mtx;
+    mutex_type probes_mtx;
+    mutex_type directories_mtx;
+
+    // the memory used by the caches, protected by their mutexes
+    std::size_t files_bytes;
+    std::size_t minimized_bytes;
+    std::size_t resolutions_bytes;
+    std::size_t probes_bytes;
+
+    boost::detail::atomic_count file_hits;
+    boost::detail::atomic_count file_misses;
+    boost::detail::atomic_count minimized_hits;
+    boost::detail::atomic_count minimized_misses;
+    boost::detail::atomic_count resolution_hits;
+    boost::detail::atomic_count resolution_misses;
+    boost::detail::atomic_count probe_hits;
+    boost::detail::atomic_count probe_misses;
+    boost::detail::atomic_count invalidated;
+    boost::detail::atomic_count evicted;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_SHARED_RESOURCES_HPP_7A2E5C91_D03B_4E86_A1F4_6B58C2E9D730_INCLUDED)
@@ -18,14 +18,17 @@
 #include <boost/serialization/serialization.hpp>
 #endif
 #include <boost/wave/util/file_position.hpp>
+#include <boost/wave/util/refcount.hpp>
+#include <boost/wave/util/token_arena.hpp>
 #include <boost/wave/token_ids.hpp>
 #include <boost/wave/language_support.hpp>
 
 #include <boost/throw_exception.hpp>
 #include <boost/pool/singleton_pool.hpp>
-#include <boost/smart_ptr/detail/atomic_count.hpp>
 #include <boost/optional.hpp>
 
+#include <utility>
+
 // this must occur after all of the includes and before any code appears
 #ifdef BOOST_HAS_ABI_HEADERS
 #include BOOST_ABI_PREFIX
@@ -38,7 +41,7 @@ namespace cpplexer {
 
 namespace impl {
 
-template <typename StringTypeT, typename PositionT>
+template <typename StringTypeT, typename PositionT, typename AllocationT>
 class token_data
 {
 public:
@@ -61,6 +64,11 @@ public:
     :   id(id_), value(value_), pos(pos_), expand_pos(expand_pos_), refcnt(1)
     {}
 
+    token_data(token_id id_, string_type &&value_,
+               position_type const &pos_)
+    :   id(id_), value(std::move(value_)), pos(pos_), refcnt(1)
+    {}
+
     token_data(token_data const& rhs)
     :   id(rhs.id), value(rhs.value), pos(rhs.pos), expand_pos(rhs.expand_pos), refcnt(1)
     {}
@@ -86,7 +94,9 @@ public:
 
     void set_token_id (token_id id_) { id = id_; }
     void set_value (string_type const &value_) { value = value_; }
+    void set_value (string_type &&value_) { value = std::move(value_); }
     void set_position (position_type const &pos_) { pos = pos_; }
+    void set_position (position_type &&pos_) { pos = std::move(pos_); }
     void set_expand_position (position_type const & pos_) { expand_pos = pos_; }
 
     friend bool operator== (token_data const& lhs, token_data const& rhs)
@@ -150,54 +160,65 @@ private:
     string_type value;          // the text, which was parsed into this token
     position_type pos;          // the original file position
     boost::optional<position_type> expand_pos;    // where this token was expanded
-    boost::detail::atomic_count refcnt;
+    boost::wave::util::refcount_type refcnt;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 struct token_data_tag {};
 
-template <typename StringTypeT, typename PositionT>
+template <typename StringTypeT, typename PositionT, typename AllocationT>
 inline void *
-token_data<StringTypeT, PositionT>::operator new(std::size_t size)
+token_data<StringTypeT, PositionT, AllocationT>::operator new(std::size_t size)
 {
-    BOOST_VERIFY(sizeof(token_data<StringTypeT, PositionT>) == size);
+    BOOST_VERIFY(sizeof(token_data<StringTypeT, PositionT, AllocationT>) == size);
     typedef boost::singleton_pool<
-            token_data_tag, sizeof(token_data<StringTypeT, PositionT>)
+            token_data_tag,
+            sizeof(token_data<StringTypeT, PositionT, AllocationT>) +
+                AllocationT::header_size
         > pool_type;
 
-    void *ret = pool_type::malloc();
-    if (0 == ret)
-        boost::throw_exception(std::bad_alloc());
-    return ret;
+    return AllocationT::template allocate<pool_type>(size);
 }
 
-template <typename StringTypeT, typename PositionT>
+template <typename StringTypeT, typename PositionT, typename AllocationT>
 inline void
-token_data<StringTypeT, PositionT>::operator delete(void *p, std::size_t size)
+token_data<StringTypeT, PositionT, AllocationT>::operator delete(void *p,
+    std::size_t size)
 {
-    BOOST_VERIFY(sizeof(token_data<StringTypeT, PositionT>) == size);
+    BOOST_VERIFY(sizeof(token_data<StringTypeT, PositionT, AllocationT>) == size);
     typedef boost::singleton_pool<
-            token_data_tag, sizeof(token_data<StringTypeT, PositionT>)
+            token_data_tag,
+            sizeof(token_data<StringTypeT, PositionT, AllocationT>) +
+                AllocationT::header_size
         > pool_type;
 
     if (0 != p)
-        pool_type::free(p);
+        AllocationT::template deallocate<pool_type>(p, size);
 }
 
 } // namespace impl
 
 ///////////////////////////////////////////////////////////////////////////////
 //  forward declaration of the token type
-template <typename PositionT = boost::wave::util::file_position_type>
+template <
+    typename PositionT = boost::wave::util::file_position_type,
+    typename AllocationT = boost::wave::util::pool_allocation
+>
 class lex_token;
 
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  lex_token
 //
+//      The template parameter AllocationT decides where the token data is
+//      allocated from: boost::wave::util::pool_allocation (the default)
+//      uses the process wide pools, boost::wave::util::token_arena the
+//      arena of the context working with the token (see the allocation
+//      policy allocation_policies::context_arena).
+//
 ///////////////////////////////////////////////////////////////////////////////
 
-template <typename PositionT>
+template <typename PositionT, typename AllocationT>
 class lex_token
 {
 public:
@@ -205,7 +226,8 @@ public:
     typedef PositionT               position_type;
 
 private:
-    typedef impl::token_data<string_type, position_type> data_type;
+    typedef impl::token_data<string_type, position_type, AllocationT>
+        data_type;
 
 public:
     //  default constructed tokens correspond to EOI tokens
@@ -225,10 +247,22 @@ public:
             data->addref();
     }
 
+    //  moving a token transfers the reference to the shared data, leaving
+    //  the source as an EOI token
+    lex_token(lex_token&& rhs) BOOST_NOEXCEPT
+    :   data(rhs.data)
+    {
+        rhs.data = 0;
+    }
+
     lex_token(token_id id_, string_type const &value_, PositionT const &pos_)
     :   data(new data_type(id_, value_, pos_))
     {}
 
+    lex_token(token_id id_, string_type &&value_, PositionT const &pos_)
+    :   data(new data_type(id_, std::move(value_), pos_))
+    {}
+
     ~lex_token()
     {
         if (0 != data && 0 == data->release())
@@ -249,6 +283,18 @@ public:
         return *this;
     }
 
+    lex_token& operator=(lex_token&& rhs) BOOST_NOEXCEPT
+    {
+        if (&rhs != this) {
+            if (0 != data && 0 == data->release())
+                delete data;
+
+            data = rhs.data;
+            rhs.data = 0;
+        }
+        return *this;
+    }
+
     // accessors
     operator token_id() const { return 0 != data ? token_id(*data) : T_EOI; }
     string_type const &get_value() const { return data->get_value(); }
@@ -259,7 +305,9 @@ public:
 
     void set_token_id (token_id id_) { make_unique(); data->set_token_id(id_); }
     void set_value (string_type const &value_) { make_unique(); data->set_value(value_); }
+    void set_value (string_type &&value_) { make_unique(); data->set_value(std::move(value_)); }
     void set_position (position_type const &pos_) { make_unique(); data->set_position(pos_); }
+    void set_position (position_type &&pos_) { make_unique(); data->set_position(std::move(pos_)); }
     void set_expand_position (position_type const &pos_) { make_unique(); data->set_expand_position(pos_); }
 
     friend bool operator== (lex_token const& lhs, lex_token const& rhs)
@@ -318,18 +366,18 @@ private:
 //  validate a token instance. It has to be defined in the same namespace
 //  as the token class itself to allow ADL to find it.
 ///////////////////////////////////////////////////////////////////////////////
-template <typename Position>
+template <typename Position, typename Allocation>
 inline bool
-token_is_valid(lex_token<Position> const& t)
+token_is_valid(lex_token<Position, Allocation> const& t)
 {
     return t.is_valid();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 #if defined(BOOST_SPIRIT_DEBUG)
-template <typename PositionT>
+template <typename PositionT, typename AllocationT>
 inline std::ostream &
-operator<< (std::ostream &stream, lex_token<PositionT> const &object)
+operator<< (std::ostream &stream, lex_token<PositionT, AllocationT> const &object)
 {
     object.print(stream);
     return stream;
@@ -338,6 +386,21 @@ operator<< (std::ostream &stream, lex_token<PositionT> const &object)
 
 ///////////////////////////////////////////////////////////////////////////////
 }   // namespace cpplexer
+
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//  the sequences of tokens allocated from the arena use the arena as well
+template <typename PositionT>
+struct token_sequence_allocator<
+    boost::wave::cpplexer::lex_token<PositionT, token_arena> >
+{
+    typedef token_allocator<
+            boost::wave::cpplexer::lex_token<PositionT, token_arena>
+        > type;
+};
+
+}   // namespace util
 }   // namespace wave
 }   // namespace boost
 
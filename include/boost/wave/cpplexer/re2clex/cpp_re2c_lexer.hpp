@@ -105,7 +105,14 @@ private:
 #if BOOST_WAVE_SUPPORT_THREADING == 0
     static token_cache<string_type> const cache;
 #else
-    token_cache<string_type> const cache;
+    // the cache is built once per thread instead of once for every lexer
+    // (i.e. for every included file)
+    static token_cache<string_type> const &thread_cache()
+    {
+        static thread_local token_cache<string_type> const cache;
+        return cache;
+    }
+    token_cache<string_type> const &cache;
 #endif
 };
 
@@ -119,7 +126,7 @@ lexer<IteratorT, PositionT, TokenT>::lexer(IteratorT const &first,
     : scanner(first, last),
       filename(pos.get_file()), at_eof(false), language(language_)
 #if BOOST_WAVE_SUPPORT_THREADING != 0
-  , cache()
+  , cache(thread_cache())
 #endif
 {
     using namespace std;        // some systems have memset in std
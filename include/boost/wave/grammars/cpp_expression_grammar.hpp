@@ -14,32 +14,17 @@
 #include <boost/wave/wave_config.hpp>
 
 #include <boost/assert.hpp>
-#include <boost/spirit/include/classic_core.hpp>
-#include <boost/spirit/include/classic_closure.hpp>
-#include <boost/spirit/include/classic_if.hpp>
-#include <boost/spirit/include/classic_assign_actor.hpp>
-#include <boost/spirit/include/classic_push_back_actor.hpp>
-
-#include <boost/spirit/include/phoenix1_functions.hpp>
-#include <boost/spirit/include/phoenix1_operators.hpp>
-#include <boost/spirit/include/phoenix1_primitives.hpp>
-#include <boost/spirit/include/phoenix1_statements.hpp>
-#include <boost/spirit/include/phoenix1_casts.hpp>
+
+#include <limits>
 
 #include <boost/wave/token_ids.hpp>
 
 #include <boost/wave/cpp_exceptions.hpp>
 #include <boost/wave/grammars/cpp_expression_grammar_gen.hpp>
-#include <boost/wave/grammars/cpp_literal_grammar_gen.hpp>
+#include <boost/wave/grammars/cpp_literal_decoders.hpp>
 #include <boost/wave/grammars/cpp_expression_value.hpp>
-#include <boost/wave/util/pattern_parser.hpp>
 #include <boost/wave/util/macro_helpers.hpp>
 
-#if !defined(spirit_append_actor)
-#define spirit_append_actor(actor) boost::spirit::classic::push_back_a(actor)
-#define spirit_assign_actor(actor) boost::spirit::classic::assign_a(actor)
-#endif // !defined(spirit_append_actor)
-
 // this must occur after all of the includes and before any code appears
 #ifdef BOOST_HAS_ABI_HEADERS
 #include BOOST_ABI_PREFIX
@@ -47,702 +32,343 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Encapsulation of the grammar for evaluation of constant preprocessor
-//  expressions
+//  Evaluation of constant preprocessor expressions
 //
 ///////////////////////////////////////////////////////////////////////////////
 namespace boost {
 namespace wave {
 namespace grammars {
-namespace closures {
+namespace impl {
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  define the closure type used throughout the C++ expression grammar
-//
-//      Throughout this grammar all literal tokens are stored into a
-//      closure_value variables, which converts the types appropriately, where
-//      required.
+//  convert the given token value (integer literal) to a unsigned long
 //
 ///////////////////////////////////////////////////////////////////////////////
-    struct cpp_expr_closure
-    :   boost::spirit::classic::closure<cpp_expr_closure, closure_value>
+    template <typename TokenT>
+    inline boost::wave::grammars::closures::closure_value
+    as_intlit(TokenT const &token)
     {
-        member1 val;
-    };
-
-}   // namespace closures
+        typedef boost::wave::grammars::closures::closure_value return_type;
+        bool is_unsigned = false;
+        uint_literal_type ul = evaluate_intlit(token, is_unsigned);
 
-namespace impl {
+        return is_unsigned ?
+            return_type(ul) : return_type(static_cast<int_literal_type>(ul));
+    }
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  convert the given token value (integer literal) to a unsigned long
+//  Convert the given token value (character literal) to a unsigned int
 //
 ///////////////////////////////////////////////////////////////////////////////
-    struct convert_intlit {
-
-        template <typename ArgT>
-        struct result {
-
-            typedef boost::wave::grammars::closures::closure_value type;
-        };
+    template <typename TokenT>
+    inline boost::wave::grammars::closures::closure_value
+    as_chlit(TokenT const &token)
+    {
+        typedef boost::wave::grammars::closures::closure_value return_type;
+        value_error status = error_noerror;
 
-        template <typename TokenT>
-        boost::wave::grammars::closures::closure_value
-        operator()(TokenT const &token) const
+        //  If the literal is a wchar_t and wchar_t is represented by a
+        //  signed integral type, then the created value will be signed as
+        //  well, otherwise we assume unsigned values.
+#if BOOST_WAVE_WCHAR_T_SIGNEDNESS == BOOST_WAVE_WCHAR_T_AUTOSELECT
+        if ('L' == token.get_value()[0] && std::numeric_limits<wchar_t>::is_signed)
         {
-            typedef boost::wave::grammars::closures::closure_value return_type;
-            bool is_unsigned = false;
-            uint_literal_type ul = intlit_grammar_gen<TokenT>::evaluate(token,
-                is_unsigned);
-
-            return is_unsigned ?
-                return_type(ul) : return_type(static_cast<int_literal_type>(ul));
+            int value = evaluate_chlit<int>(token, status);
+            return return_type(value, status);
         }
-    };
-    phoenix::function<convert_intlit> const as_intlit;
+#elif BOOST_WAVE_WCHAR_T_SIGNEDNESS == BOOST_WAVE_WCHAR_T_FORCE_SIGNED
+        if ('L' == token.get_value()[0])
+        {
+            int value = evaluate_chlit<int>(token, status);
+            return return_type(value, status);
+        }
+#endif
+
+        unsigned int value = evaluate_chlit<unsigned int>(token, status);
+        return return_type(value, status);
+    }
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  Convert the given token value (character literal) to a unsigned int
+//  expression_evaluator
+//
+//      A precedence climbing parser evaluating a (fully macro expanded)
+//      constant expression while parsing it. The binary operators are
+//      handled by a single loop driven by their precedence, the unary
+//      operators, parentheses, the ?: operator and the literals are parsed
+//      recursively.
+//
+//      Whitespace and comments are skipped between all tokens. The right
+//      operand of a || whose left operand is true (resp. a && whose left
+//      operand is false) is parsed without being evaluated, so any errors
+//      it might cause (division by zero etc.) are not reported.
+//
+//      parse() returns false if the tokens don't start with a valid
+//      expression, stop() returns the position after the recognized
+//      expression.
 //
 ///////////////////////////////////////////////////////////////////////////////
-    struct convert_chlit {
+    template <typename IteratorT>
+    class expression_evaluator
+    {
+        typedef boost::wave::grammars::closures::closure_value value_type;
 
-        template <typename ArgT>
-        struct result {
+    public:
+        expression_evaluator(IteratorT const &first_, IteratorT const &last_)
+        :   first(first_), last(last_)
+        {}
 
-            typedef boost::wave::grammars::closures::closure_value type;
-        };
-
-        template <typename TokenT>
-        boost::wave::grammars::closures::closure_value
-        operator()(TokenT const &token) const
+        bool parse(value_type &val)
         {
-            typedef boost::wave::grammars::closures::closure_value return_type;
-            value_error status = error_noerror;
-
-            //  If the literal is a wchar_t and wchar_t is represented by a
-            //  signed integral type, then the created value will be signed as
-            //  well, otherwise we assume unsigned values.
-#if BOOST_WAVE_WCHAR_T_SIGNEDNESS == BOOST_WAVE_WCHAR_T_AUTOSELECT
-            if ('L' == token.get_value()[0] && std::numeric_limits<wchar_t>::is_signed)
-            {
-                int value = chlit_grammar_gen<int, TokenT>::evaluate(token, status);
-                return return_type(value, status);
-            }
-#elif BOOST_WAVE_WCHAR_T_SIGNEDNESS == BOOST_WAVE_WCHAR_T_FORCE_SIGNED
-            if ('L' == token.get_value()[0])
-            {
-                int value = chlit_grammar_gen<int, TokenT>::evaluate(token, status);
-                return return_type(value, status);
-            }
-#endif
-
-            unsigned int value = chlit_grammar_gen<unsigned int, TokenT>::evaluate(token, status);
-            return return_type(value, status);
+            return conditional_exp(val, true);
         }
-    };
-    phoenix::function<convert_chlit> const as_chlit;
 
-////////////////////////////////////////////////////////////////////////////////
-//
-//  Handle the ?: operator with correct type and error propagation
-//
-////////////////////////////////////////////////////////////////////////////////
-    struct operator_questionmark {
-
-        template <typename CondT, typename Arg1T, typename Arg2T>
-        struct result {
-
-            typedef boost::wave::grammars::closures::closure_value type;
+        IteratorT const &stop() const { return first; }
+
+    private:
+        // the precedence of the binary operators, 0 for all other tokens
+        enum precedence {
+            no_operator = 0,
+            logical_or_op,
+            logical_and_op,
+            inclusive_or_op,
+            exclusive_or_op,
+            and_op,
+            equality_op,
+            relational_op,
+            shift_op,
+            additive_op,
+            multiplicative_op
         };
 
-        template <typename CondT, typename Arg1T, typename Arg2T>
-        boost::wave::grammars::closures::closure_value
-        operator()(CondT const &cond, Arg1T &val1, Arg2T const &val2) const
+        static int binary_precedence(token_id id)
         {
-            return val1.handle_questionmark(cond, val2);
-        }
-    };
-    phoenix::function<operator_questionmark> const questionmark;
+            switch (id) {
+            case T_STAR:
+            case T_DIVIDE:
+            case T_PERCENT:         return multiplicative_op;
+            case T_PLUS:
+            case T_MINUS:           return additive_op;
+            case T_SHIFTLEFT:
+            case T_SHIFTRIGHT:      return shift_op;
+            case T_LESS:
+            case T_LESSEQUAL:
+            case T_GREATER:
+            case T_GREATEREQUAL:    return relational_op;
+            case T_EQUAL:           return equality_op;
+            default:
+                break;
+            }
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Handle type conversion conserving error conditions
-//
-///////////////////////////////////////////////////////////////////////////////
-    struct operator_to_bool {
+            // these may be spelled as alternative tokens or trigraphs as well
+            switch (BASE_TOKEN(id)) {
+            case T_NOTEQUAL:        return equality_op;
+            case T_AND:             return and_op;
+            case T_XOR:             return exclusive_or_op;
+            case T_OR:              return inclusive_or_op;
+            case T_ANDAND:          return logical_and_op;
+            case T_OROR:            return logical_or_op;
+            default:
+                break;
+            }
+            return no_operator;
+        }
 
-        template <typename ArgT>
-        struct result {
+        static void apply_binary(token_id id, value_type &val,
+            value_type const &rhs)
+        {
+            switch (id) {
+            case T_STAR:            val *= rhs; return;
+            case T_DIVIDE:          val /= rhs; return;
+            case T_PERCENT:         val %= rhs; return;
+            case T_PLUS:            val += rhs; return;
+            case T_MINUS:           val -= rhs; return;
+            case T_SHIFTLEFT:       val <<= rhs; return;
+            case T_SHIFTRIGHT:      val >>= rhs; return;
+            case T_LESS:            val = val < rhs; return;
+            case T_LESSEQUAL:       val = val <= rhs; return;
+            case T_GREATER:         val = val > rhs; return;
+            case T_GREATEREQUAL:    val = val >= rhs; return;
+            case T_EQUAL:           val = val == rhs; return;
+            default:
+                break;
+            }
 
-            typedef boost::wave::grammars::closures::closure_value type;
-        };
+            switch (BASE_TOKEN(id)) {
+            case T_NOTEQUAL:        val = val != rhs; return;
+            case T_AND:             val = val & rhs; return;
+            case T_XOR:             val = val ^ rhs; return;
+            case T_OR:              val = val | rhs; return;
+            default:
+                BOOST_ASSERT(false);
+                break;
+            }
+        }
 
-        template <typename ArgT>
-        boost::wave::grammars::closures::closure_value
-        operator()(ArgT &val) const
+        // skip whitespace, return the id of the next token (T_EOI at the end)
+        token_id peek()
         {
-            typedef boost::wave::grammars::closures::closure_value return_type;
-            return return_type(
-                boost::wave::grammars::closures::as_bool(val), val.is_valid());
+            for (/**/; first != last; ++first) {
+                token_id id = token_id(*first);
+                if (T_SPACE != id && T_CCOMMENT != id && T_CPPCOMMENT != id)
+                    return id;
+            }
+            return T_EOI;
         }
-    };
-    phoenix::function<operator_to_bool> const to_bool;
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Handle explicit type conversion
-//
-///////////////////////////////////////////////////////////////////////////////
-    struct operator_as_bool {
+        //  conditional_exp
+        //      :   binary_exp ('?' conditional_exp ':' conditional_exp)?
+        bool conditional_exp(value_type &val, bool calc)
+        {
+            if (!binary_exp(val, logical_or_op, calc))
+                return false;
+            if (T_QUESTION_MARK != peek())
+                return true;
+            ++first;
 
-        template <typename ArgT>
-        struct result {
+            value_type val1, val2;
+            if (!conditional_exp(val1, calc) || T_COLON != peek())
+                return false;
+            ++first;
+            if (!conditional_exp(val2, calc))
+                return false;
 
-            typedef bool type;
-        };
+            if (calc)
+                val = val1.handle_questionmark(val, val2);
+            return true;
+        }
 
-        template <typename ArgT>
-        bool
-        operator()(ArgT &val) const
+        //  binary_exp
+        //      :   unary_exp (binary_operator binary_exp)*
+        //
+        //  where only operators with a precedence of at least min_prec are
+        //  consumed, the right operand of each binary operator consumes the
+        //  operators binding stronger than this one.
+        bool binary_exp(value_type &val, int min_prec, bool calc)
         {
-            return boost::wave::grammars::closures::as_bool(val);
+            if (!unary_exp(val, calc))
+                return false;
+
+            for (;;) {
+                token_id id = peek();
+                int prec = binary_precedence(id);
+                if (prec < min_prec || no_operator == prec)
+                    return true;
+                ++first;
+
+                value_type rhs;
+                if (logical_or_op == prec || logical_and_op == prec) {
+                    // no more evaluation is required, if the outcome is known
+                    // from the left operand already
+                    bool known = calc &&
+                        (logical_or_op == prec) == as_bool(val);
+
+                    if (!binary_exp(rhs, prec + 1, calc && !known))
+                        return false;
+
+                    if (known)
+                        val = value_type(as_bool(val), val.is_valid());
+                    else if (calc && logical_or_op == prec)
+                        val = val || rhs;
+                    else if (calc)
+                        val = val && rhs;
+                }
+                else {
+                    if (!binary_exp(rhs, prec + 1, calc))
+                        return false;
+                    if (calc)
+                        apply_binary(id, val, rhs);
+                }
+            }
         }
-    };
-    phoenix::function<operator_as_bool> const as_bool;
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//  Handle closure value operators with proper error propagation
-//
-///////////////////////////////////////////////////////////////////////////////
-#define BOOST_WAVE_BINARYOP(op, optok)                                        \
-    struct operator_binary_ ## op {                                           \
-                                                                              \
-        template <typename Arg1T, typename Arg2T>                             \
-        struct result {                                                       \
-                                                                              \
-            typedef boost::wave::grammars::closures::closure_value type;      \
-        };                                                                    \
-                                                                              \
-        template <typename Arg1T, typename Arg2T>                             \
-        boost::wave::grammars::closures::closure_value                        \
-        operator()(Arg1T &val1, Arg2T &val2) const                            \
-        {                                                                     \
-            return val1 optok val2;                                           \
-        }                                                                     \
-    };                                                                        \
-    phoenix::function<operator_binary_ ## op> const binary_ ## op             \
-    /**/
-
-    BOOST_WAVE_BINARYOP(and, &&);
-    BOOST_WAVE_BINARYOP(or, ||);
-
-    BOOST_WAVE_BINARYOP(bitand, &);
-    BOOST_WAVE_BINARYOP(bitor, |);
-    BOOST_WAVE_BINARYOP(bitxor, ^);
-
-    BOOST_WAVE_BINARYOP(lesseq, <=);
-    BOOST_WAVE_BINARYOP(less, <);
-    BOOST_WAVE_BINARYOP(greater, >);
-    BOOST_WAVE_BINARYOP(greateq, >=);
-    BOOST_WAVE_BINARYOP(eq, ==);
-    BOOST_WAVE_BINARYOP(ne, !=);
-
-#undef BOOST_WAVE_BINARYOP
+        //  unary_exp
+        //      :   ('+' | '-' | '~' | '!') unary_exp
+        //      |   primary_exp
+        bool unary_exp(value_type &val, bool calc)
+        {
+            token_id id = peek();
+            switch (id) {
+            case T_PLUS:
+                ++first;
+                return unary_exp(val, calc);
+
+            case T_MINUS:
+                ++first;
+                if (!unary_exp(val, calc))
+                    return false;
+                if (calc)
+                    val = -val;
+                return true;
 
-///////////////////////////////////////////////////////////////////////////////
-#define BOOST_WAVE_UNARYOP(op, optok)                                         \
-    struct operator_unary_ ## op {                                            \
-                                                                              \
-        template <typename ArgT>                                              \
-        struct result {                                                       \
-                                                                              \
-            typedef boost::wave::grammars::closures::closure_value type;      \
-        };                                                                    \
-                                                                              \
-        template <typename ArgT>                                              \
-        boost::wave::grammars::closures::closure_value                        \
-        operator()(ArgT &val) const                                           \
-        {                                                                     \
-            return optok val;                                                 \
-        }                                                                     \
-    };                                                                        \
-    phoenix::function<operator_unary_ ## op> const unary_ ## op               \
-    /**/
-
-    BOOST_WAVE_UNARYOP(neg, !);
-
-#undef BOOST_WAVE_UNARYOP
+            default:
+                break;
+            }
 
-}   // namespace impl
+            switch (BASE_TOKEN(id)) {
+            case T_COMPL:
+                ++first;
+                if (!unary_exp(val, calc))
+                    return false;
+                if (calc)
+                    val = ~val;
+                return true;
 
-///////////////////////////////////////////////////////////////////////////////
-//  define, whether the rule's should generate some debug output
-#define TRACE_CPP_EXPR_GRAMMAR \
-    bool(BOOST_SPIRIT_DEBUG_FLAGS_CPP & BOOST_SPIRIT_DEBUG_FLAGS_CPP_EXPR_GRAMMAR) \
-    /**/
-
-struct expression_grammar :
-    public boost::spirit::classic::grammar<
-        expression_grammar,
-        closures::cpp_expr_closure::context_t
-    >
-{
-    expression_grammar()
-    {
-        BOOST_SPIRIT_DEBUG_TRACE_GRAMMAR_NAME(*this, "expression_grammar",
-            TRACE_CPP_EXPR_GRAMMAR);
-    }
+            case T_NOT:
+                ++first;
+                if (!unary_exp(val, calc))
+                    return false;
+                if (calc)
+                    val = !val;
+                return true;
 
-    // no need for copy constructor/assignment operator
-    expression_grammar(expression_grammar const&);
-    expression_grammar& operator= (expression_grammar const&);
+            default:
+                break;
+            }
+            return primary_exp(val, calc);
+        }
 
-    template <typename ScannerT>
-    struct definition
-    {
-        typedef closures::cpp_expr_closure closure_type;
-        typedef boost::spirit::classic::rule<ScannerT, closure_type::context_t> rule_t;
-        typedef boost::spirit::classic::rule<ScannerT> simple_rule_t;
-
-        simple_rule_t pp_expression;
-
-        rule_t const_exp;
-        rule_t logical_or_exp, logical_and_exp;
-        rule_t inclusive_or_exp, exclusive_or_exp, and_exp;
-        rule_t cmp_equality, cmp_relational;
-        rule_t shift_exp;
-        rule_t add_exp, multiply_exp;
-        rule_t unary_exp, primary_exp, constant;
-
-        rule_t const_exp_nocalc;
-        rule_t logical_or_exp_nocalc, logical_and_exp_nocalc;
-        rule_t inclusive_or_exp_nocalc, exclusive_or_exp_nocalc, and_exp_nocalc;
-        rule_t cmp_equality_nocalc, cmp_relational_nocalc;
-        rule_t shift_exp_nocalc;
-        rule_t add_exp_nocalc, multiply_exp_nocalc;
-        rule_t unary_exp_nocalc, primary_exp_nocalc, constant_nocalc;
-
-        boost::spirit::classic::subrule<0, closure_type::context_t> const_exp_subrule;
-
-        definition(expression_grammar const &self)
+        //  primary_exp
+        //      :   literal
+        //      |   '(' conditional_exp ')'
+        bool primary_exp(value_type &val, bool calc)
         {
-            using namespace boost::spirit::classic;
-            using namespace phoenix;
-            using namespace boost::wave;
-            using boost::wave::util::pattern_p;
-
-            pp_expression
-                =   const_exp[self.val = arg1]
-                ;
-
-            const_exp
-                =   logical_or_exp[const_exp.val = arg1]
-                    >> !(const_exp_subrule =
-                            ch_p(T_QUESTION_MARK)
-                            >>  const_exp
-                                [
-                                    const_exp_subrule.val = arg1
-                                ]
-                            >>  ch_p(T_COLON)
-                            >>  const_exp
-                                [
-                                    const_exp_subrule.val =
-                                        impl::questionmark(const_exp.val,
-                                            const_exp_subrule.val, arg1)
-                                ]
-                        )[const_exp.val = arg1]
-                ;
-
-            logical_or_exp
-                =   logical_and_exp[logical_or_exp.val = arg1]
-                    >> *(   if_p(impl::as_bool(logical_or_exp.val))
-                            [
-                                // if one of the || operators is true, no more
-                                // evaluation is required
-                                pattern_p(T_OROR, MainTokenMask)
-                                >>  logical_and_exp_nocalc
-                                    [
-                                        logical_or_exp.val =
-                                            impl::to_bool(logical_or_exp.val)
-                                    ]
-                            ]
-                            .else_p
-                            [
-                                pattern_p(T_OROR, MainTokenMask)
-                                >>  logical_and_exp
-                                    [
-                                        logical_or_exp.val =
-                                            impl::binary_or(logical_or_exp.val, arg1)
-                                    ]
-                            ]
-                        )
-                ;
-
-            logical_and_exp
-                =   inclusive_or_exp[logical_and_exp.val = arg1]
-                    >> *(   if_p(impl::as_bool(logical_and_exp.val))
-                            [
-                                pattern_p(T_ANDAND, MainTokenMask)
-                                >>  inclusive_or_exp
-                                    [
-                                        logical_and_exp.val =
-                                            impl::binary_and(logical_and_exp.val, arg1)
-                                    ]
-                            ]
-                            .else_p
-                            [
-                                // if one of the && operators is false, no more
-                                // evaluation is required
-                                pattern_p(T_ANDAND, MainTokenMask)
-                                >>  inclusive_or_exp_nocalc
-                                    [
-                                        logical_and_exp.val =
-                                            impl::to_bool(logical_and_exp.val)
-                                    ]
-                            ]
-                        )
-                ;
-
-            inclusive_or_exp
-                =   exclusive_or_exp[inclusive_or_exp.val = arg1]
-                    >> *(   pattern_p(T_OR, MainTokenMask)
-                            >>  exclusive_or_exp
-                                [
-                                    inclusive_or_exp.val =
-                                        impl::binary_bitor(inclusive_or_exp.val, arg1)
-                                ]
-                        )
-                ;
-
-            exclusive_or_exp
-                =   and_exp[exclusive_or_exp.val = arg1]
-                    >> *(   pattern_p(T_XOR, MainTokenMask)
-                            >>  and_exp
-                                [
-                                    exclusive_or_exp.val =
-                                        impl::binary_bitxor(exclusive_or_exp.val, arg1)
-                                ]
-                        )
-                ;
-
-            and_exp
-                =   cmp_equality[and_exp.val = arg1]
-                    >> *(   pattern_p(T_AND, MainTokenMask)
-                            >>  cmp_equality
-                                [
-                                    and_exp.val =
-                                        impl::binary_bitand(and_exp.val, arg1)
-                                ]
-                        )
-                ;
-
-            cmp_equality
-                =   cmp_relational[cmp_equality.val = arg1]
-                    >> *(   ch_p(T_EQUAL)
-                            >>  cmp_relational
-                                [
-                                    cmp_equality.val =
-                                        impl::binary_eq(cmp_equality.val, arg1)
-                                ]
-                        |   pattern_p(T_NOTEQUAL, MainTokenMask)
-                            >>  cmp_relational
-                                [
-                                    cmp_equality.val =
-                                        impl::binary_ne(cmp_equality.val, arg1)
-                                ]
-                        )
-                ;
-
-            cmp_relational
-                =   shift_exp[cmp_relational.val = arg1]
-                    >> *(   ch_p(T_LESSEQUAL)
-                            >>  shift_exp
-                                [
-                                    cmp_relational.val =
-                                        impl::binary_lesseq(cmp_relational.val, arg1)
-                                ]
-                        |   ch_p(T_GREATEREQUAL)
-                            >>  shift_exp
-                                [
-                                    cmp_relational.val =
-                                        impl::binary_greateq(cmp_relational.val, arg1)
-                                ]
-                        |   ch_p(T_LESS)
-                            >>  shift_exp
-                                [
-                                    cmp_relational.val =
-                                        impl::binary_less(cmp_relational.val, arg1)
-                                ]
-                        |   ch_p(T_GREATER)
-                            >>  shift_exp
-                                [
-                                    cmp_relational.val =
-                                        impl::binary_greater(cmp_relational.val, arg1)
-                                ]
-                        )
-                ;
-
-            shift_exp
-                =   add_exp[shift_exp.val = arg1]
-                    >> *(   ch_p(T_SHIFTLEFT)
-                            >>  add_exp
-                                [
-                                    shift_exp.val <<= arg1
-                                ]
-                        |   ch_p(T_SHIFTRIGHT)
-                            >>  add_exp
-                                [
-                                    shift_exp.val >>= arg1
-                                ]
-                        )
-                ;
-
-            add_exp
-                =   multiply_exp[add_exp.val = arg1]
-                    >> *(   ch_p(T_PLUS)
-                            >>  multiply_exp
-                                [
-                                    add_exp.val += arg1
-                                ]
-                        |   ch_p(T_MINUS)
-                            >>  multiply_exp
-                                [
-                                    add_exp.val -= arg1
-                                ]
-                        )
-                ;
-
-            multiply_exp
-                =   unary_exp[multiply_exp.val = arg1]
-                    >> *(   ch_p(T_STAR)
-                            >>  unary_exp
-                                [
-                                    multiply_exp.val *= arg1
-                                ]
-                        |   ch_p(T_DIVIDE)
-                            >>  unary_exp
-                                [
-                                    multiply_exp.val /= arg1
-                                ]
-                        |   ch_p(T_PERCENT)
-                            >>  unary_exp
-                                [
-                                    multiply_exp.val %= arg1
-                                ]
-                        )
-                ;
-
-            unary_exp
-                =   primary_exp[unary_exp.val = arg1]
-                |   ch_p(T_PLUS) >> unary_exp
-                    [
-                        unary_exp.val = arg1
-                    ]
-                |   ch_p(T_MINUS) >> unary_exp
-                    [
-                        unary_exp.val = -arg1
-                    ]
-                |   pattern_p(T_COMPL, MainTokenMask) >> unary_exp
-                    [
-                        unary_exp.val = ~arg1
-                    ]
-                |   pattern_p(T_NOT, MainTokenMask) >> unary_exp
-                    [
-                        unary_exp.val = impl::unary_neg(arg1)
-                    ]
-                ;
-
-            primary_exp
-                =   constant[primary_exp.val = arg1]
-                |   ch_p(T_LEFTPAREN)
-                    >> const_exp[primary_exp.val = arg1]
-                    >> ch_p(T_RIGHTPAREN)
-                ;
-
-            constant
-                =   ch_p(T_PP_NUMBER)
-                    [
-                        constant.val = impl::as_intlit(arg1)
-                    ]
-                |   ch_p(T_INTLIT)
-                    [
-                        constant.val = impl::as_intlit(arg1)
-                    ]
-                |   ch_p(T_LONGINTLIT)
-                    [
-                        constant.val = impl::as_intlit(arg1)
-                    ]
-                |   ch_p(T_CHARLIT)
-                    [
-                        constant.val = impl::as_chlit(arg1)
-                    ]
-                ;
-
-            //  here follows the same grammar, but without any embedded
-            //  calculations
-            const_exp_nocalc
-                =   logical_or_exp_nocalc
-                    >> !(   ch_p(T_QUESTION_MARK)
-                            >>  const_exp_nocalc
-                            >>  ch_p(T_COLON)
-                            >>  const_exp_nocalc
-                        )
-                ;
-
-            logical_or_exp_nocalc
-                =   logical_and_exp_nocalc
-                    >> *(   pattern_p(T_OROR, MainTokenMask)
-                            >>  logical_and_exp_nocalc
-                        )
-                ;
-
-            logical_and_exp_nocalc
-                =   inclusive_or_exp_nocalc
-                    >> *(   pattern_p(T_ANDAND, MainTokenMask)
-                            >>  inclusive_or_exp_nocalc
-                        )
-                ;
-
-            inclusive_or_exp_nocalc
-                =   exclusive_or_exp_nocalc
-                    >> *(   pattern_p(T_OR, MainTokenMask)
-                            >>  exclusive_or_exp_nocalc
-                        )
-                ;
-
-            exclusive_or_exp_nocalc
-                =   and_exp_nocalc
-                    >> *(   pattern_p(T_XOR, MainTokenMask)
-                            >>  and_exp_nocalc
-                        )
-                ;
-
-            and_exp_nocalc
-                =   cmp_equality_nocalc
-                    >> *(   pattern_p(T_AND, MainTokenMask)
-                            >>  cmp_equality_nocalc
-                        )
-                ;
-
-            cmp_equality_nocalc
-                =   cmp_relational_nocalc
-                    >> *(   ch_p(T_EQUAL)
-                            >>  cmp_relational_nocalc
-                        |   pattern_p(T_NOTEQUAL, MainTokenMask)
-                            >>  cmp_relational_nocalc
-                        )
-                ;
-
-            cmp_relational_nocalc
-                =   shift_exp_nocalc
-                    >> *(   ch_p(T_LESSEQUAL)
-                            >>  shift_exp_nocalc
-                        |   ch_p(T_GREATEREQUAL)
-                            >>  shift_exp_nocalc
-                        |   ch_p(T_LESS)
-                            >>  shift_exp_nocalc
-                        |   ch_p(T_GREATER)
-                            >>  shift_exp_nocalc
-                        )
-                ;
-
-            shift_exp_nocalc
-                =   add_exp_nocalc
-                    >> *(   ch_p(T_SHIFTLEFT)
-                            >>  add_exp_nocalc
-                        |   ch_p(T_SHIFTRIGHT)
-                            >>  add_exp_nocalc
-                        )
-                ;
-
-            add_exp_nocalc
-                =   multiply_exp_nocalc
-                    >> *(   ch_p(T_PLUS)
-                            >>  multiply_exp_nocalc
-                        |   ch_p(T_MINUS)
-                            >>  multiply_exp_nocalc
-                        )
-                ;
-
-            multiply_exp_nocalc
-                =   unary_exp_nocalc
-                    >> *(   ch_p(T_STAR)
-                            >>  unary_exp_nocalc
-                        |   ch_p(T_DIVIDE)
-                            >>  unary_exp_nocalc
-                        |   ch_p(T_PERCENT)
-                            >>  unary_exp_nocalc
-                        )
-                ;
-
-            unary_exp_nocalc
-                =   primary_exp_nocalc
-                |   ch_p(T_PLUS) >> unary_exp_nocalc
-                |   ch_p(T_MINUS) >> unary_exp_nocalc
-                |   pattern_p(T_COMPL, MainTokenMask) >> unary_exp_nocalc
-                |   pattern_p(T_NOT, MainTokenMask) >> unary_exp_nocalc
-                ;
-
-            primary_exp_nocalc
-                =   constant_nocalc
-                |   ch_p(T_LEFTPAREN)
-                    >> const_exp_nocalc
-                    >> ch_p(T_RIGHTPAREN)
-                ;
-
-            constant_nocalc
-                =   ch_p(T_PP_NUMBER)
-                |   ch_p(T_INTLIT)
-                |   ch_p(T_LONGINTLIT)
-                |   ch_p(T_CHARLIT)
-                ;
-
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(pp_expression, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(const_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(logical_or_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(logical_and_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(inclusive_or_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(exclusive_or_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(and_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(cmp_equality, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(cmp_relational, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(shift_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(add_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(multiply_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(unary_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(primary_exp, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(constant, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(const_exp_subrule, TRACE_CPP_EXPR_GRAMMAR);
-
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(const_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(logical_or_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(logical_and_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(inclusive_or_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(exclusive_or_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(and_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(cmp_equality_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(cmp_relational_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(shift_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(add_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(multiply_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(unary_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(primary_exp_nocalc, TRACE_CPP_EXPR_GRAMMAR);
-            BOOST_SPIRIT_DEBUG_TRACE_RULE(constant_nocalc, TRACE_CPP_EXPR_GRAMMAR);
+            switch (peek()) {
+            case T_PP_NUMBER:
+            case T_INTLIT:
+            case T_LONGINTLIT:
+            case T_SIZETLIT:
+                if (calc)
+                    val = as_intlit(*first);
+                ++first;
+                return true;
+
+            case T_CHARLIT:
+                if (calc)
+                    val = as_chlit(*first);
+                ++first;
+                return true;
+
+            case T_LEFTPAREN:
+                ++first;
+                if (!conditional_exp(val, calc) || T_RIGHTPAREN != peek())
+                    return false;
+                ++first;
+                return true;
+
+            default:
+                break;
+            }
+            return false;
         }
 
-        // start rule of this grammar
-        simple_rule_t const& start() const
-        { return pp_expression; }
+        IteratorT first;
+        IteratorT const last;
     };
-};
 
-///////////////////////////////////////////////////////////////////////////////
-#undef TRACE_CPP_EXPR_GRAMMAR
+}   // namespace impl
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -766,7 +392,6 @@ expression_grammar_gen<TokenT>::evaluate(
     typename token_type::position_type const &act_pos,
     bool if_block_status, value_error &status)
 {
-    using namespace boost::spirit::classic;
     using namespace boost::wave;
     using namespace boost::wave::grammars::closures;
 
@@ -775,18 +400,14 @@ expression_grammar_gen<TokenT>::evaluate(
     typedef typename token_sequence_type::const_iterator iterator_type;
     typedef typename token_sequence_type::value_type::string_type string_type;
 
-    parse_info<iterator_type> hit(first);
+    impl::expression_evaluator<iterator_type> evaluator(first, last);
     closure_value result;             // expression result
 
 #if !defined(BOOST_NO_EXCEPTIONS)
     try
 #endif
     {
-        expression_grammar g;             // expression grammar
-        hit = parse (first, last, g[spirit_assign_actor(result)],
-                     ch_p(T_SPACE) | ch_p(T_CCOMMENT) | ch_p(T_CPPCOMMENT));
-
-        if (!hit.hit) {
+        if (!evaluator.parse(result)) {
             // expression is illformed
             if (if_block_status) {
                 string_type expression = as_string<string_type>(first, last);
@@ -816,11 +437,11 @@ expression_grammar_gen<TokenT>::evaluate(
     }
 #endif
 
-    if (!hit.full) {
+    if (evaluator.stop() != last) {
         // The token list starts with a valid expression, but there remains
         // something. If the remainder consists out of whitespace only, the
         // expression is still valid.
-        iterator_type next = hit.stop;
+        iterator_type next = evaluator.stop();
 
         while (next != last) {
             switch (token_id(*next)) {
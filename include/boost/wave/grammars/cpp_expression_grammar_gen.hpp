@@ -16,7 +16,7 @@
 #include <boost/wave/grammars/cpp_value_error.hpp>
 
 #include <list>
-#include <boost/pool/pool_alloc.hpp>
+#include <boost/wave/util/chunked_token_sequence.hpp>
 
 // this must occur after all of the includes and before any code appears
 #ifdef BOOST_HAS_ABI_HEADERS
@@ -39,7 +39,7 @@ namespace grammars {
 //  expression_grammar_gen template class
 //
 //      This template helps separating the compilation of the
-//      expression_grammar class from the compilation of the main
+//      expression evaluator from the compilation of the main
 //      pp_iterator. This is done to safe compilation time.
 //
 ///////////////////////////////////////////////////////////////////////////////
@@ -48,7 +48,7 @@ template <typename TokenT>
 struct BOOST_WAVE_DECL expression_grammar_gen {
 
     typedef TokenT token_type;
-    typedef std::list<token_type, boost::fast_pool_allocator<token_type> >
+    typedef typename boost::wave::util::default_token_sequence<token_type>::type
         token_sequence_type;
 
     static bool evaluate(
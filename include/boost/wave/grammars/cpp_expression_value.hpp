@@ -672,6 +672,12 @@ public:
     closure_value &
     operator<<= (closure_value const &rhs)
     {
+        if (is_bool == type) {
+            // the bool operand is promoted to int
+            value.i = as_long(*this);
+            type = is_int;
+        }
+
         switch (type) {
         case is_bool:
         case is_int:
@@ -737,6 +743,12 @@ public:
     closure_value &
     operator>>= (closure_value const &rhs)
     {
+        if (is_bool == type) {
+            // the bool operand is promoted to int
+            value.i = as_long(*this);
+            type = is_int;
+        }
+
         switch (type) {
         case is_bool:
         case is_int:
@@ -16,7 +16,7 @@
 #include <list>
 
 #include <boost/spirit/include/classic_parser.hpp>
-#include <boost/pool/pool_alloc.hpp>
+#include <boost/wave/util/chunked_token_sequence.hpp>
 
 #include <boost/wave/util/unput_queue_iterator.hpp>
 
@@ -40,7 +40,7 @@ template <typename LexIteratorT>
 struct BOOST_WAVE_DECL has_include_grammar_gen
 {
     typedef typename LexIteratorT::token_type token_type;
-    typedef std::list<token_type, boost::fast_pool_allocator<token_type> >
+    typedef typename boost::wave::util::default_token_sequence<token_type>::type
         token_sequence_type;
 
 //  The parse_operator_has_include function is instantiated manually twice to
@@ -0,0 +1,493 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Decoders for integer and character literals
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_LITERAL_DECODERS_HPP_5B7E2A94_INCLUDED)
+#define BOOST_CPP_LITERAL_DECODERS_HPP_5B7E2A94_INCLUDED
+
+#include <algorithm>  // std::min
+#include <limits>     // std::numeric_limits
+#include <climits>    // CHAR_BIT
+
+#include <boost/wave/wave_config.hpp>
+
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+
+#include <boost/wave/cpp_exceptions.hpp>
+#include <boost/wave/grammars/cpp_value_error.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace grammars {
+namespace impl {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Return the value of the given character as a digit (of a base up to 16),
+//  all other characters map to 0xff.
+//
+///////////////////////////////////////////////////////////////////////////////
+    inline unsigned int literal_digit_value(unsigned char c)
+    {
+        static unsigned char const digit_values[256] = {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x00
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x10
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x20
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,     // 0x30 '0'
+            0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff,     // 0x40 'A'
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x50
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff,     // 0x60 'a'
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x70
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x80
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0x90
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0xa0
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0xb0
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0xc0
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0xd0
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0xe0
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,     // 0xf0
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+        };
+        return digit_values[c];
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  decode_intlit
+//
+//      Decode the integer literal given by [first, last): decimal, octal
+//      (leading '0'), hexadecimal ('0x') and binary ('0b') digits with
+//      optional digit separators (a single '\'' between two digits),
+//      followed by an optional suffix: 'u' combined with one of 'l', 'll',
+//      'z' (C++23) or the Microsoft specific 'i64' (or 'I64'), in any
+//      order.
+//
+//      Returns false if the literal is ill formed or if its value doesn't
+//      fit into uint_literal_type. As in #if expressions all integers are
+//      represented by the largest integer types, an unsuffixed literal is
+//      unsigned only if its value doesn't fit into int_literal_type.
+//
+///////////////////////////////////////////////////////////////////////////////
+    template <typename IteratorT>
+    inline bool
+    decode_intlit(IteratorT first, IteratorT const &last,
+        uint_literal_type &value, bool &is_unsigned)
+    {
+        value = 0;
+        is_unsigned = false;
+        if (first == last)
+            return false;
+
+        // the prefix decides the base, the leading '0' of an octal literal
+        // is a digit already
+        unsigned int base = 10;
+        bool seen_digit = false;
+        if ('0' == *first) {
+            ++first;
+            if (first != last && ('x' == *first || 'X' == *first)) {
+                base = 16;
+                ++first;
+            }
+            else if (first != last && ('b' == *first || 'B' == *first)) {
+                base = 2;
+                ++first;
+            }
+            else {
+                base = 8;
+                seen_digit = true;
+            }
+        }
+
+        uint_literal_type const max_value =
+            (std::numeric_limits<uint_literal_type>::max)();
+        uint_literal_type const max_before_shift = max_value / base;
+        bool last_was_digit = seen_digit;
+
+        for (/**/; first != last; ++first) {
+            if ('\'' == *first) {
+                // digit separators are allowed between digits only
+                if (!last_was_digit)
+                    return false;
+                last_was_digit = false;
+                continue;
+            }
+
+            unsigned int digit = literal_digit_value((unsigned char)*first);
+            if (digit >= base)
+                break;
+
+            if (value > max_before_shift ||
+                value * base > max_value - digit)
+            {
+                return false;       // integer constant too large
+            }
+            value = value * base + digit;
+            seen_digit = last_was_digit = true;
+        }
+        if (!seen_digit || !last_was_digit)
+            return false;
+
+        // suffix
+        bool has_u = false;
+        bool has_size = false;          // any of 'l', 'll', 'z' or 'i64'
+        while (first != last) {
+            switch (*first) {
+            case 'u':
+            case 'U':
+                if (has_u)
+                    return false;
+                has_u = true;
+                ++first;
+                break;
+
+            case 'l':
+            case 'L':
+                {
+                    if (has_size)
+                        return false;
+                    has_size = true;
+
+                    // 'll' and 'LL' only, but not 'lL' or 'Ll'
+                    char l = *first;
+                    if (++first != last && l == *first)
+                        ++first;
+                }
+                break;
+
+            case 'z':
+            case 'Z':
+                if (has_size)
+                    return false;
+                has_size = true;
+                ++first;
+                break;
+
+            case 'i':
+            case 'I':
+                if (has_size || ++first == last || '6' != *first ||
+                    ++first == last || '4' != *first)
+                {
+                    return false;
+                }
+                has_size = true;
+                ++first;
+                break;
+
+            default:
+                return false;
+            }
+        }
+
+        is_unsigned = has_u || value >
+            uint_literal_type((std::numeric_limits<int_literal_type>::max)());
+        return true;
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  decode_escape
+//
+//      Decode the escape sequence starting at the given backslash into the
+//      value of the denoted character. All digits of a hexadecimal escape
+//      sequence are used, any value not fitting into 32 bits is returned as
+//      0x100000000.
+//
+///////////////////////////////////////////////////////////////////////////////
+    template <typename IteratorT>
+    inline bool
+    decode_escape(IteratorT &first, IteratorT const &last,
+        boost::uint64_t &character)
+    {
+        boost::uint64_t const too_large = boost::uint64_t(1) << 32;
+
+        if (++first == last)
+            return false;
+
+        char c = *first;
+        ++first;
+        switch (c) {
+        case 'a':   character = 0x07; return true;      // BEL
+        case 'b':   character = 0x08; return true;      // BS
+        case 't':   character = 0x09; return true;      // HT
+        case 'n':   character = 0x0a; return true;      // NL
+        case 'v':   character = 0x0b; return true;      // VT
+        case 'e':
+        case 'E':   character = 0x1b; return true;      // ESC
+        case 'f':   character = 0x0c; return true;      // FF
+        case 'r':   character = 0x0d; return true;      // CR
+        case '?':
+        case '\'':
+        case '\"':
+        case '\\':  character = (unsigned char)c; return true;
+
+        case 'x':
+            {
+                bool seen_digit = false;
+                character = 0;
+                for (/**/; first != last; ++first) {
+                    unsigned int digit =
+                        literal_digit_value((unsigned char)*first);
+                    if (digit >= 16)
+                        break;
+                    character = (std::min)(character * 16 + digit, too_large);
+                    seen_digit = true;
+                }
+                return seen_digit;
+            }
+
+        case 'u':
+        case 'U':
+            {
+                // universal character names have exactly 4 resp. 8 digits
+                int digits = ('u' == c) ? 4 : 8;
+                character = 0;
+                for (/**/; digits != 0; --digits, ++first) {
+                    if (first == last)
+                        return false;
+                    unsigned int digit =
+                        literal_digit_value((unsigned char)*first);
+                    if (digit >= 16)
+                        return false;
+                    character = character * 16 + digit;
+                }
+                return true;
+            }
+
+        default:
+            break;
+        }
+
+        // octal escape sequence of up to 3 digits
+        if (c < '0' || c > '7')
+            return false;       // unknown escape sequence
+
+        character = (unsigned char)(c - '0');
+        for (int digits = 1; digits != 3 && first != last; ++digits, ++first) {
+            if (*first < '0' || *first > '7')
+                break;
+            character = character * 8 + (unsigned char)(*first - '0');
+        }
+        return true;
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  decode_utf8
+//
+//      Decode a (non-ASCII) UTF-8 encoded source character into its code
+//      point. Invalid sequences are taken as a single character, as before.
+//
+///////////////////////////////////////////////////////////////////////////////
+    template <typename IteratorT>
+    inline boost::uint64_t
+    decode_utf8(IteratorT &first, IteratorT const &last)
+    {
+        unsigned char lead = (unsigned char)*first;
+        ++first;
+        if (lead < 0xc0 || lead >= 0xf8)
+            return lead;
+
+        int trailing = (lead >= 0xf0) ? 3 : (lead >= 0xe0) ? 2 : 1;
+        boost::uint64_t code_point = lead & (0x3f >> trailing);
+
+        IteratorT it = first;
+        for (/**/; trailing != 0; --trailing, ++it) {
+            if (it == last || 0x80 != ((unsigned char)*it & 0xc0))
+                return lead;
+            code_point = (code_point << 6) | ((unsigned char)*it & 0x3f);
+        }
+        first = it;
+        return code_point;
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  decode_chlit
+//
+//      Decode the character literal given by [first, last) with an optional
+//      encoding prefix ('L', 'u8', 'u' or 'U'). Multicharacter literals are
+//      composed from the values of their characters, each one shifted in
+//      as a code unit of the literal's character type.
+//
+//      'overflow' is set if a character doesn't fit into a code unit or if
+//      the composed value doesn't fit into 32 bits (a non-ASCII universal
+//      character name doesn't fit into a narrow character literal).
+//      'max_value' receives the largest value of the literal's character
+//      type. Returns false if the literal is ill formed.
+//
+///////////////////////////////////////////////////////////////////////////////
+    template <typename IteratorT>
+    inline bool
+    decode_chlit(IteratorT first, IteratorT const &last,
+        boost::uint32_t &value, bool &overflow, boost::uint32_t &max_value)
+    {
+        // The following assumes that wchar_t is max. 32 Bit
+        BOOST_STATIC_ASSERT(sizeof(wchar_t) <= 4);
+
+        value = 0;
+        overflow = false;
+        if (first == last)
+            return false;
+
+        // the encoding prefix decides the size of the code units
+        unsigned int unit_bits = CHAR_BIT;
+        max_value = (std::numeric_limits<unsigned char>::max)();
+        switch (*first) {
+        case 'L':
+            unit_bits = CHAR_BIT * sizeof(wchar_t);
+            max_value = boost::uint32_t((std::numeric_limits<wchar_t>::max)());
+            ++first;
+            break;
+
+        case 'U':
+            unit_bits = 32;
+            max_value = 0xffffffff;
+            ++first;
+            break;
+
+        case 'u':
+            if (++first != last && '8' == *first) {
+                ++first;
+            }
+            else {
+                unit_bits = 16;
+                max_value = 0xffff;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        if (first == last || '\'' != *first)
+            return false;
+        ++first;
+
+        boost::uint64_t const unit_mask =
+            (boost::uint64_t(1) << unit_bits) - 1;
+        bool seen_character = false;
+
+        while (first != last && '\'' != *first) {
+            boost::uint64_t character = 0;
+            if ('\\' == *first) {
+                IteratorT escape = first;
+                if (!decode_escape(first, last, character))
+                    return false;
+
+                // a universal character name denotes a character, which has
+                // to be encoded in UTF-8, if the code units are bytes
+                if (unit_bits == CHAR_BIT && character > 0x7f &&
+                    ('u' == *++escape || 'U' == *escape))
+                {
+                    overflow = true;
+                }
+            }
+            else if (unit_bits > CHAR_BIT) {
+                character = decode_utf8(first, last);
+            }
+            else {
+                character = (unsigned char)*first;
+                ++first;
+            }
+
+            boost::uint64_t composed =
+                (boost::uint64_t(value) << unit_bits) | character;
+            if (character > unit_mask || composed > 0xffffffff)
+                overflow = true;
+            else
+                value = boost::uint32_t(composed);
+            seen_character = true;
+        }
+
+        if (first == last || !seen_character)
+            return false;
+        return ++first == last;
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Evaluate the given integer resp. character literal token, an ill formed
+//  literal is reported by throwing the corresponding preprocess_exception.
+//
+///////////////////////////////////////////////////////////////////////////////
+    template <typename TokenT>
+    inline uint_literal_type
+    evaluate_intlit(TokenT const &token, bool &is_unsigned)
+    {
+        uint_literal_type result = 0;
+        typename TokenT::string_type const &token_val = token.get_value();
+
+        if (!decode_intlit(token_val.begin(), token_val.end(), result,
+                is_unsigned))
+        {
+            BOOST_WAVE_THROW(preprocess_exception, ill_formed_integer_literal,
+                token_val.c_str(), token.get_position());
+        }
+        return result;
+    }
+
+    template <typename IntegralResult, typename TokenT>
+    inline IntegralResult
+    evaluate_chlit(TokenT const &token, value_error &status)
+    {
+        boost::uint32_t value = 0;
+        boost::uint32_t max_value = 0;
+        bool overflow = false;
+        typename TokenT::string_type const &token_val = token.get_value();
+
+        if (!decode_chlit(token_val.begin(), token_val.end(), value, overflow,
+                max_value))
+        {
+            BOOST_WAVE_THROW(preprocess_exception, ill_formed_character_literal,
+                token_val.c_str(), token.get_position());
+        }
+
+        // range check
+        IntegralResult result = IntegralResult(value);
+        if (overflow || result > IntegralResult(max_value))
+            status = error_character_overflow;
+        return result;
+    }
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace impl
+}   // namespace grammars
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_LITERAL_DECODERS_HPP_5B7E2A94_INCLUDED)
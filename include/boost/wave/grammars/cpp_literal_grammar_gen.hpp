@@ -34,9 +34,9 @@ namespace grammars {
 //
 //  cpp_intlit_grammar_gen template class
 //
-//      This template helps separating the compilation of the intlit_grammar
-//      class from the compilation of the expression_grammar. This is done
-//      to safe compilation time.
+//      This template gives access to the integer literal decoder (see
+//      cpp_literal_decoders.hpp) for code, which doesn't want to include it.
+//      The expression evaluator uses the decoder directly.
 //
 ///////////////////////////////////////////////////////////////////////////////
 template <typename TokenT>
@@ -49,9 +49,9 @@ struct BOOST_WAVE_DECL intlit_grammar_gen {
 //
 //  cpp_chlit_grammar_gen template class
 //
-//      This template helps separating the compilation of the chlit_grammar
-//      class from the compilation of the expression_grammar. This is done
-//      to safe compilation time.
+//      This template gives access to the character literal decoder (see
+//      cpp_literal_decoders.hpp) for code, which doesn't want to include it.
+//      The expression evaluator uses the decoder directly.
 //
 ///////////////////////////////////////////////////////////////////////////////
 template <typename IntegralResult, typename TokenT>
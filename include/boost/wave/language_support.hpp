@@ -70,7 +70,7 @@ enum language_support {
 #endif
 #endif
 
-    support_option_mask = 0xFFC0,
+    support_option_mask = 0xC0FFC0,
     support_option_emit_contnewlines = 0x0040,
     support_option_insert_whitespace = 0x0080,
     support_option_preserve_comments = 0x0100,
@@ -80,7 +80,9 @@ enum language_support {
     support_option_prefer_pp_numbers = 0x1000,
     support_option_emit_line_directives = 0x2000,
     support_option_include_guard_detection = 0x4000,
-    support_option_emit_pragma_directives = 0x8000
+    support_option_emit_pragma_directives = 0x8000,
+    support_option_scan_dependencies = 0x400000,
+    support_option_directives_only = 0x800000
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -283,6 +285,8 @@ BOOST_WAVE_OPTION(emit_pragma_directives)    // support_option_emit_pragma_direc
 #endif
 BOOST_WAVE_OPTION(insert_whitespace)         // support_option_insert_whitespace
 BOOST_WAVE_OPTION(emit_contnewlines)         // support_option_emit_contnewlines
+BOOST_WAVE_OPTION(scan_dependencies)         // support_option_scan_dependencies
+BOOST_WAVE_OPTION(directives_only)           // support_option_directives_only
 #if BOOST_WAVE_SUPPORT_CPP0X != 0
 BOOST_WAVE_OPTION(no_newline_at_end_of_file) // support_no_newline_at_end_of_file
 #endif
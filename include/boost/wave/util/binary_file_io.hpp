@@ -0,0 +1,165 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Helpers for reading and writing the files of the persistent caches
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_BINARY_FILE_IO_HPP_4C81E2D7_95A3_4F06_B2E8_1D7A6C3F905B_INCLUDED)
+#define BOOST_BINARY_FILE_IO_HPP_4C81E2D7_95A3_4F06_B2E8_1D7A6C3F905B_INCLUDED
+
+#include <cstddef>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <boost/wave/wave_config.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+namespace binary_file_io {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The files written by the persistent caches (see output_cache and
+//  include_database) consist of unsigned integers of a given size (stored
+//  little endian) and strings (stored as their 4 byte length followed by
+//  their characters).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// the modification time of the given file or directory, -1 if it doesn't
+// exist
+inline boost::int64_t
+modification_time(std::string const &path)
+{
+    boost::system::error_code ec;
+    std::time_t t = boost::filesystem::last_write_time(
+        boost::filesystem::path(path), ec);
+    return ec ? -1 : boost::int64_t(t);
+}
+
+// read the whole contents of the given file, returns false if the file
+// can't be read
+inline bool
+read_file(std::string const &path, std::string &data)
+{
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return false;
+    data.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+// replace the given file atomically: the data is written to a temporary file
+// in the same directory, which is then renamed, so concurrent readers see
+// either the old or the new contents
+inline bool
+write_file(boost::filesystem::path const &target, std::string const &data)
+{
+    namespace fs = boost::filesystem;
+
+    boost::system::error_code ec;
+    fs::path temp(target);
+    temp += fs::unique_path(".%%%%-%%%%-%%%%");
+    {
+        std::ofstream file(temp.string().c_str(),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(data.data(), std::streamsize(data.size()));
+        if (!file.good()) {
+            file.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+inline void
+write_uint(std::string &out, boost::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        out += char((value >> (8 * i)) & 0xff);
+}
+
+inline void
+write_string(std::string &out, std::string const &value)
+{
+    write_uint(out, value.size(), 4);
+    out += value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  reader: reads the values written by write_uint() and write_string() from
+//  the given data, all functions return false if the data is truncated
+//
+///////////////////////////////////////////////////////////////////////////////
+class reader
+{
+public:
+    reader(std::string const &data_, std::size_t pos_)
+    :   data(data_), pos(pos_)
+    {}
+
+    bool read_uint(boost::uint64_t &value, int bytes)
+    {
+        if (data.size() - pos < std::size_t(bytes))
+            return false;
+        value = 0;
+        for (int i = 0; i < bytes; ++i)
+            value |= boost::uint64_t((unsigned char)data[pos++]) << (8 * i);
+        return true;
+    }
+    bool read_string(std::string &value)
+    {
+        boost::uint64_t size = 0;
+        if (!read_uint(size, 4) || data.size() - pos < size)
+            return false;
+        value.assign(data, pos, std::size_t(size));
+        pos += std::size_t(size);
+        return true;
+    }
+    bool at_end() const { return pos == data.size(); }
+
+private:
+    std::string const &data;
+    std::size_t pos;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace binary_file_io
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_BINARY_FILE_IO_HPP_4C81E2D7_95A3_4F06_B2E8_1D7A6C3F905B_INCLUDED)
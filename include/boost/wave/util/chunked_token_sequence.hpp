@@ -0,0 +1,757 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Segmented contiguous container used for the token sequences
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_WAVE_CHUNKED_TOKEN_SEQUENCE_HPP_6B2F0E4A_1D7C_4A35_8E9B_C3F5A7D1B204_INCLUDED)
+#define BOOST_WAVE_CHUNKED_TOKEN_SEQUENCE_HPP_6B2F0E4A_1D7C_4A35_8E9B_C3F5A7D1B204_INCLUDED
+
+#include <cstddef>
+#include <new>
+#include <list>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/token_arena.hpp>
+#if BOOST_WAVE_SERIALIZATION != 0
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/split_free.hpp>
+#include <boost/serialization/collections_save_imp.hpp>
+#include <boost/serialization/collections_load_imp.hpp>
+#endif
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+template <typename T, typename AllocatorT>
+class chunked_token_sequence;
+
+namespace impl {
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  The chunks of a chunked_token_sequence are kept in a circular doubly
+    //  linked list, the sequence object itself holds the sentinel node. The
+    //  elements of a chunk occupy the range [first, last) of its storage,
+    //  for the sentinel both pointers are null.
+    template <typename T>
+    struct token_chunk_node
+    {
+        token_chunk_node* prev;
+        token_chunk_node* next;
+        T* first;
+        T* last;
+    };
+
+    template <typename T, std::size_t N>
+    struct token_chunk : token_chunk_node<T>
+    {
+        T* storage_begin()
+            { return static_cast<T*>(static_cast<void*>(&storage)); }
+        T* storage_end()
+            { return storage_begin() + N; }
+
+        typename boost::aligned_storage<
+                sizeof(T) * N, boost::alignment_of<T>::value
+            >::type storage;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename T, typename ValueT>
+    class chunked_token_sequence_iterator
+    :   public boost::iterator_facade<
+            chunked_token_sequence_iterator<T, ValueT>, ValueT,
+            boost::bidirectional_traversal_tag>
+    {
+        typedef token_chunk_node<T> node_type;
+
+    public:
+        chunked_token_sequence_iterator() : node(0), p(0) {}
+        chunked_token_sequence_iterator(node_type* node_, T* p_)
+        :   node(node_), p(p_)
+        {}
+
+        template <typename OtherValueT>
+        chunked_token_sequence_iterator(
+                chunked_token_sequence_iterator<T, OtherValueT> const& rhs,
+                typename boost::enable_if_convertible<
+                    OtherValueT*, ValueT*>::type* = 0)
+        :   node(rhs.node), p(rhs.p)
+        {}
+
+    private:
+        friend class boost::iterator_core_access;
+        template <typename T_, typename AllocatorT_>
+        friend class boost::wave::util::chunked_token_sequence;
+        template <typename T_, typename OtherValueT>
+        friend class chunked_token_sequence_iterator;
+
+        ValueT& dereference() const
+        {
+            BOOST_ASSERT(0 != p);
+            return *p;
+        }
+
+        template <typename OtherValueT>
+        bool equal(chunked_token_sequence_iterator<T, OtherValueT> const& rhs) const
+        {
+            return p == rhs.p && node == rhs.node;
+        }
+
+        void increment()
+        {
+            if (++p == node->last) {
+                node = node->next;
+                p = node->first;
+            }
+        }
+
+        void decrement()
+        {
+            if (p == node->first) {
+                node = node->prev;
+                p = node->last;
+            }
+            --p;
+        }
+
+        node_type* node;
+        T* p;       // null for the end iterator
+    };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  chunked_token_sequence
+//
+//      A sequence container storing the tokens in fixed size chunks, each
+//      holding up to chunk_size contiguous elements. It provides the subset
+//      of the std::list interface used for the token sequences, with the
+//      following complexities:
+//
+//          push_back, push_front, pop_back, pop_front:     O(1)
+//          insert, erase (single element):                 O(chunk_size)
+//          splice of a whole sequence:                     O(chunk_size)
+//          splice of a range:                   O(chunk_size + chunks moved)
+//
+//      Splicing relinks whole chunks between sequences, so it never moves
+//      more than the elements of a single chunk.
+//
+//      Iterator invalidation differs from std::list: inserting, erasing and
+//      splicing invalidates the iterators to the elements at and after the
+//      affected position inside the same chunk. Splicing a range moves the
+//      elements of the source, which share a chunk with the range without
+//      being part of it, invalidating the iterators to these as well.
+//      Iterators to all other elements, the end() iterator, and the
+//      iterators to the spliced elements stay valid. Use the iterator
+//      returned by insert and erase to continue a traversal.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename AllocatorT = std::allocator<T> >
+class chunked_token_sequence
+{
+    BOOST_STATIC_CONSTANT(std::size_t, chunk_size = 8);
+
+    typedef impl::token_chunk_node<T> node_type;
+    typedef impl::token_chunk<T, chunk_size> chunk_type;
+    typedef typename std::allocator_traits<AllocatorT>::template
+        rebind_alloc<chunk_type> chunk_allocator_type;
+
+public:
+    typedef T value_type;
+    typedef AllocatorT allocator_type;
+    typedef T& reference;
+    typedef T const& const_reference;
+    typedef T* pointer;
+    typedef T const* const_pointer;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    typedef impl::chunked_token_sequence_iterator<T, T> iterator;
+    typedef impl::chunked_token_sequence_iterator<T, T const> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    chunked_token_sequence()
+    :   count(0)
+    {
+        init();
+    }
+    explicit chunked_token_sequence(allocator_type const& alloc_)
+    :   count(0), alloc(alloc_)
+    {
+        init();
+    }
+    template <typename IteratorT>
+    chunked_token_sequence(IteratorT first, IteratorT last,
+            typename boost::disable_if<boost::is_integral<IteratorT> >::type* = 0)
+    :   count(0)
+    {
+        init();
+        insert(end(), first, last);
+    }
+    chunked_token_sequence(chunked_token_sequence const& rhs)
+    :   count(0), alloc(rhs.alloc)
+    {
+        init();
+        insert(end(), rhs.begin(), rhs.end());
+    }
+    chunked_token_sequence(chunked_token_sequence&& rhs) noexcept
+    :   count(0), alloc(rhs.alloc)
+    {
+        init();
+        take(rhs);
+    }
+    ~chunked_token_sequence()
+    {
+        clear();
+    }
+
+    chunked_token_sequence& operator= (chunked_token_sequence const& rhs)
+    {
+        if (this != &rhs) {
+            clear();
+            insert(end(), rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+    chunked_token_sequence& operator= (chunked_token_sequence&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            clear();
+            take(rhs);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const { return allocator_type(alloc); }
+
+    // iterators
+    iterator begin()
+        { return iterator(head.next, head.next->first); }
+    const_iterator begin() const
+        { return const_iterator(head.next, head.next->first); }
+    iterator end()
+        { return iterator(&head, 0); }
+    const_iterator end() const
+        { return const_iterator(const_cast<node_type*>(&head), 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const
+        { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const
+        { return const_reverse_iterator(begin()); }
+
+    // capacity
+    bool empty() const { return 0 == count; }
+    size_type size() const { return count; }
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+    // element access
+    reference front() { BOOST_ASSERT(!empty()); return *head.next->first; }
+    const_reference front() const
+        { BOOST_ASSERT(!empty()); return *head.next->first; }
+    reference back() { BOOST_ASSERT(!empty()); return *(head.prev->last - 1); }
+    const_reference back() const
+        { BOOST_ASSERT(!empty()); return *(head.prev->last - 1); }
+
+    // modifiers
+    void push_back(T const& value) { append_before(&head, value); }
+    void push_back(T&& value) { append_before(&head, std::move(value)); }
+
+    void push_front(T const& value) { prepend(value); }
+    void push_front(T&& value) { prepend(std::move(value)); }
+
+    void pop_front()
+    {
+        BOOST_ASSERT(!empty());
+        node_type* n = head.next;
+        destroy(n->first++);
+        --count;
+        if (n->first == n->last)
+            free_chunk(n);
+    }
+
+    void pop_back()
+    {
+        BOOST_ASSERT(!empty());
+        node_type* n = head.prev;
+        destroy(--n->last);
+        --count;
+        if (n->first == n->last)
+            free_chunk(n);
+    }
+
+    iterator insert(const_iterator pos, T const& value)
+        { return insert_one(pos, value); }
+    iterator insert(const_iterator pos, T&& value)
+        { return insert_one(pos, std::move(value)); }
+
+    template <typename IteratorT>
+    typename boost::disable_if<boost::is_integral<IteratorT>, iterator>::type
+    insert(const_iterator pos, IteratorT first, IteratorT last)
+    {
+        node_type* n = split(pos);
+        node_type* before = n->prev;
+        T* before_last = before->last;
+
+        for (/**/; first != last; ++first)
+            append_before(n, *first);
+
+        // the first inserted element went either into the chunk before the
+        // insertion point or into a new chunk following it
+        if (before != &head && before_last != before->last)
+            return iterator(before, before_last);
+        return iterator(before->next, before->next->first);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        BOOST_ASSERT(pos != end());
+        const_iterator next = pos;
+        return erase(pos, ++next);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        node_type* fn = first.node;
+        node_type* ln = last.node;
+
+        if (first == last)
+            return iterator(ln, const_cast<T*>(last.p));
+
+        if (fn == ln) {
+            // the erased range is part of a single chunk
+            T* f = const_cast<T*>(first.p);
+            T* l = const_cast<T*>(last.p);
+            std::size_t erased = std::size_t(l - f);
+
+            count -= erased;
+            if (f == fn->first) {
+                // erasing a prefix doesn't need to move anything
+                destroy(f, l);
+                fn->first = l;
+                return iterator(fn, l);
+            }
+
+            T* new_last = std::move(l, fn->last, f);
+            destroy(new_last, fn->last);
+            fn->last = new_last;
+            return make_iterator(fn, f);
+        }
+
+        // the range spans several chunks: truncate the first one, free all
+        // chunks in between and drop the leading part of the last one
+        T* f = const_cast<T*>(first.p);
+        count -= std::size_t(fn->last - f);
+        destroy(f, fn->last);
+        fn->last = f;
+
+        node_type* n = fn->next;
+        if (fn->first == fn->last)
+            free_chunk(fn);
+
+        while (n != ln) {
+            node_type* next = n->next;
+            count -= std::size_t(n->last - n->first);
+            destroy(n->first, n->last);
+            n->last = n->first;
+            free_chunk(n);
+            n = next;
+        }
+
+        if (ln != &head) {
+            T* l = const_cast<T*>(last.p);
+            count -= std::size_t(l - ln->first);
+            destroy(ln->first, l);
+            ln->first = l;
+        }
+        return iterator(ln, const_cast<T*>(last.p));
+    }
+
+    void splice(const_iterator pos, chunked_token_sequence& other)
+    {
+        BOOST_ASSERT(this != &other);
+        if (other.empty())
+            return;
+
+        node_type* first = other.head.next;
+        node_type* last = other.head.prev;
+        size_type moved = other.count;
+
+        other.init();
+        other.count = 0;
+
+        link_before(split(pos), first, last);
+        count += moved;
+    }
+    void splice(const_iterator pos, chunked_token_sequence&& other)
+    {
+        splice(pos, other);
+    }
+
+    void splice(const_iterator pos, chunked_token_sequence& other,
+        const_iterator it)
+    {
+        const_iterator next = it;
+        splice(pos, other, it, ++next);
+    }
+
+    void splice(const_iterator pos, chunked_token_sequence& other,
+        const_iterator first, const_iterator last)
+    {
+        BOOST_ASSERT(this != &other);
+        if (first == last)
+            return;
+
+        // isolate the range into whole chunks by moving the elements around
+        // it, the spliced elements are not touched
+        node_type* ln = other.split(last);
+        node_type* fn = other.split_front(first);
+
+        size_type moved = 0;
+        for (node_type* n = fn; n != ln; n = n->next)
+            moved += size_type(n->last - n->first);
+
+        node_type* lp = ln->prev;
+        fn->prev->next = ln;
+        ln->prev = fn->prev;
+        other.count -= moved;
+
+        link_before(split(pos), fn, lp);
+        count += moved;
+    }
+
+    void clear()
+    {
+        node_type* n = head.next;
+        while (n != &head) {
+            node_type* next = n->next;
+            destroy(n->first, n->last);
+            deallocate_chunk(n);
+            n = next;
+        }
+        init();
+        count = 0;
+    }
+
+    void resize(size_type new_size)
+    {
+        while (count > new_size)
+            pop_back();
+        while (count < new_size)
+            push_back(T());
+    }
+
+    void swap(chunked_token_sequence& rhs)
+    {
+        if (this != &rhs) {
+            chunked_token_sequence temp(std::move(rhs));
+            rhs.take(*this);
+            take(temp);
+        }
+    }
+
+private:
+    void init()
+    {
+        head.prev = head.next = &head;
+        head.first = head.last = 0;
+    }
+
+    //  steal all chunks from rhs, this sequence has to be empty
+    void take(chunked_token_sequence& rhs)
+    {
+        BOOST_ASSERT(empty());
+        if (!rhs.empty()) {
+            link_before(&head, rhs.head.next, rhs.head.prev);
+            count = rhs.count;
+            rhs.init();
+            rhs.count = 0;
+        }
+    }
+
+    static void destroy(T* p)
+    {
+        p->~T();
+    }
+    static void destroy(T* first, T* last)
+    {
+        for (/**/; first != last; ++first)
+            first->~T();
+    }
+
+    static chunk_type* as_chunk(node_type* n)
+    {
+        return static_cast<chunk_type*>(n);
+    }
+
+    //  normalize an iterator pointing past the last element of a chunk
+    iterator make_iterator(node_type* n, T* p)
+    {
+        if (p == n->last)
+            return iterator(n->next, n->next->first);
+        return iterator(n, p);
+    }
+
+    static void link_before(node_type* pos, node_type* first, node_type* last)
+    {
+        first->prev = pos->prev;
+        last->next = pos;
+        pos->prev->next = first;
+        pos->prev = last;
+    }
+
+    chunk_type* allocate_chunk(node_type* pos, bool at_end)
+    {
+        chunk_type* c = ::new (static_cast<void*>(alloc.allocate(1))) chunk_type;
+        c->first = c->last = at_end ? c->storage_end() : c->storage_begin();
+        link_before(pos, c, c);
+        return c;
+    }
+
+    void deallocate_chunk(node_type* n)
+    {
+        chunk_type* c = as_chunk(n);
+        c->~chunk_type();
+        alloc.deallocate(c, 1);
+    }
+
+    void free_chunk(node_type* n)
+    {
+        BOOST_ASSERT(n != &head && n->first == n->last);
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+        deallocate_chunk(n);
+    }
+
+    //  make sure 'pos' refers to the first element of a chunk (or to end())
+    //  and return this chunk
+    node_type* split(const_iterator pos)
+    {
+        node_type* n = pos.node;
+        T* p = const_cast<T*>(pos.p);
+        if (p == n->first)
+            return n;
+
+        chunk_type* c = allocate_chunk(n->next, false);
+        for (T* it = p; it != n->last; ++it) {
+            ::new (static_cast<void*>(c->last)) T(std::move(*it));
+            ++c->last;
+        }
+        destroy(p, n->last);
+        n->last = p;
+        return c;
+    }
+
+    //  make sure 'pos' refers to the first element of a chunk by moving the
+    //  elements preceding it into a new chunk, and return the chunk of 'pos'
+    node_type* split_front(const_iterator pos)
+    {
+        node_type* n = pos.node;
+        T* p = const_cast<T*>(pos.p);
+        if (p == n->first)
+            return n;
+
+        chunk_type* c = allocate_chunk(n, false);
+        for (T* it = n->first; it != p; ++it) {
+            ::new (static_cast<void*>(c->last)) T(std::move(*it));
+            ++c->last;
+        }
+        destroy(n->first, p);
+        n->first = p;
+        return n;
+    }
+
+    //  insert an element right in front of the chunk 'n' (which may be the
+    //  sentinel), without touching any of the elements of 'n'
+    template <typename ValueT>
+    iterator append_before(node_type* n, ValueT&& value)
+    {
+        node_type* prev = n->prev;
+        if (prev == &head || prev->last == as_chunk(prev)->storage_end())
+            prev = allocate_chunk(n, false);
+
+        ::new (static_cast<void*>(prev->last)) T(std::forward<ValueT>(value));
+        ++count;
+        return iterator(prev, prev->last++);
+    }
+
+    template <typename ValueT>
+    void prepend(ValueT&& value)
+    {
+        node_type* n = head.next;
+        if (n == &head || n->first == as_chunk(n)->storage_begin())
+            n = allocate_chunk(head.next, true);
+
+        ::new (static_cast<void*>(n->first - 1)) T(std::forward<ValueT>(value));
+        --n->first;
+        ++count;
+    }
+
+    template <typename ValueT>
+    iterator insert_one(const_iterator pos, ValueT&& value)
+    {
+        node_type* n = pos.node;
+        T* p = const_cast<T*>(pos.p);
+
+        if (n != &head) {
+            chunk_type* c = as_chunk(n);
+            if (p == n->first && n->first != c->storage_begin()) {
+                // there is room in front of the first element
+                ::new (static_cast<void*>(p - 1)) T(std::forward<ValueT>(value));
+                --n->first;
+                ++count;
+                return iterator(n, p - 1);
+            }
+            if (n->last != c->storage_end() &&
+                (p != n->first || n->prev == &head ||
+                 n->prev->last == as_chunk(n->prev)->storage_end()))
+            {
+                // there is room behind the last element, move the tail
+                ::new (static_cast<void*>(n->last)) T(std::move(*(n->last - 1)));
+                std::move_backward(p, n->last - 1, n->last);
+                ++n->last;
+                *p = std::forward<ValueT>(value);
+                ++count;
+                return iterator(n, p);
+            }
+        }
+        return append_before(split(pos), std::forward<ValueT>(value));
+    }
+
+    node_type head;                 // sentinel of the chunk list
+    size_type count;
+    chunk_allocator_type alloc;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename AllocatorT>
+inline bool
+operator== (chunked_token_sequence<T, AllocatorT> const& lhs,
+    chunked_token_sequence<T, AllocatorT> const& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename AllocatorT>
+inline bool
+operator!= (chunked_token_sequence<T, AllocatorT> const& lhs,
+    chunked_token_sequence<T, AllocatorT> const& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, typename AllocatorT>
+inline void
+swap(chunked_token_sequence<T, AllocatorT>& lhs,
+    chunked_token_sequence<T, AllocatorT>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  default_token_sequence
+//
+//      The container type used for the token sequences of the context and
+//      of the explicitly instantiated grammars. Define the compile time
+//      constant BOOST_WAVE_TOKEN_SEQUENCE_USE_LIST to get the std::list based
+//      sequences used by earlier versions of the library.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename TokenT>
+struct default_token_sequence
+{
+#if BOOST_WAVE_TOKEN_SEQUENCE_USE_LIST != 0
+    typedef std::list<
+            TokenT, typename token_sequence_allocator<TokenT>::type
+        > type;
+#else
+    typedef chunked_token_sequence<
+            TokenT, typename token_sequence_allocator<TokenT>::type
+        > type;
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+#if BOOST_WAVE_SERIALIZATION != 0
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace serialization {
+
+template <typename Archive, typename T, typename AllocatorT>
+inline void save(Archive& ar,
+    boost::wave::util::chunked_token_sequence<T, AllocatorT> const& t,
+    const unsigned int /* file_version */)
+{
+    boost::serialization::stl::save_collection<
+        Archive, boost::wave::util::chunked_token_sequence<T, AllocatorT>
+    >(ar, t);
+}
+
+template <typename Archive, typename T, typename AllocatorT>
+inline void load(Archive& ar,
+    boost::wave::util::chunked_token_sequence<T, AllocatorT>& t,
+    const unsigned int /* file_version */)
+{
+    const boost::serialization::library_version_type library_version(
+        ar.get_library_version());
+
+    item_version_type item_version(0);
+    collection_size_type count;
+    ar >> BOOST_SERIALIZATION_NVP(count);
+    if (boost::serialization::library_version_type(3) < library_version)
+        ar >> BOOST_SERIALIZATION_NVP(item_version);
+    stl::collection_load_impl(ar, t, count, item_version);
+}
+
+template <typename Archive, typename T, typename AllocatorT>
+inline void serialize(Archive& ar,
+    boost::wave::util::chunked_token_sequence<T, AllocatorT>& t,
+    const unsigned int file_version)
+{
+    boost::serialization::split_free(ar, t, file_version);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}}  // namespace boost::serialization
+#endif
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_WAVE_CHUNKED_TOKEN_SEQUENCE_HPP_6B2F0E4A_1D7C_4A35_8E9B_C3F5A7D1B204_INCLUDED)
@@ -0,0 +1,413 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Reduction of a source file to its preprocessor directives
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_DIRECTIVE_MINIMIZER_HPP_822B8EF5_4F91_42D4_A638_9905FF077391_INCLUDED)
+#define BOOST_CPP_DIRECTIVE_MINIMIZER_HPP_822B8EF5_4F91_42D4_A638_9905FF077391_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <algorithm>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/language_support.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The function minimize_directives reduces the text of a source file to
+//  the lines holding preprocessor directives, which is all a context running
+//  in the dependency scanning mode (support_option_scan_dependencies) looks
+//  at.
+//
+//      Every directive (from its '#' up to and including the newline ending
+//      it) is copied verbatim, including the comments, the literals and the
+//      continuation lines inside of it. Everything else is replaced by the
+//      newlines it contains, so that the line numbers of the directives (as
+//      seen by __LINE__, #line and the error messages) stay the same. A
+//      comment spanning several lines in front of a directive counts as a
+//      newline, as it does for the preprocessing iterator.
+//
+//      The lines are recognized as the re2c lexer does it: the line
+//      continuations are removed first, comments and string, character and
+//      (for C++11 and newer only) raw string literals hide the characters
+//      looking like a directive or like the start of a comment.
+//
+//      The minimized text isn't equivalent to the original one when the
+//      comments are preserved (support_option_preserve_comments), and the
+//      lexing errors in the removed text aren't reported, except for a
+//      comment left unterminated at the end of the file, which is kept.
+//
+///////////////////////////////////////////////////////////////////////////////
+namespace impl {
+
+    class directive_minimizer
+    {
+    public:
+        directive_minimizer(std::string const &text_, bool raw_strings_)
+        :   text(text_), pos(0), unterminated(std::string::npos),
+            raw_strings(raw_strings_)
+        {}
+
+        void minimize(std::string &result)
+        {
+            result.clear();
+            result.reserve(text.size() / 4);
+
+            skip_splices();
+            while (pos < text.size()) {
+                // the directives may be preceded by whitespace and comments
+                std::size_t begin = pos;
+                bool multiline = false;
+                for (;;) {
+                    char c = current();
+                    if (' ' == c || '\t' == c || '\f' == c || '\v' == c)
+                        advance();
+                    else if (lookahead("/*"))
+                        multiline = skip_c_comment() || multiline;
+                    else
+                        break;
+                }
+
+                std::size_t const start = pos;
+                if (lookahead("#") || lookahead("%:") || lookahead("?\?=")) {
+                    copy_newlines(begin, start, result);
+                    while (pos < text.size() && !skip_token(true))
+                        /**/;
+                    result.append(text, start, pos - start);
+                    continue;
+                }
+
+                // any other line is replaced by its newlines, a comment
+                // spanning several lines starts a new line
+                if (!multiline) {
+                    while (pos < text.size() && !skip_token(false))
+                        /**/;
+                }
+                if (std::string::npos != unterminated) {
+                    copy_newlines(begin, unterminated, result);
+                    result.append(text, unterminated, std::string::npos);
+                    break;
+                }
+                copy_newlines(begin, pos, result);
+            }
+        }
+
+    private:
+        // the length of the newline at the given position, if any
+        std::size_t newline_at(std::size_t p) const
+        {
+            if (p >= text.size())
+                return 0;
+            if ('\n' == text[p])
+                return 1;
+            if ('\r' == text[p])
+                return (p + 1 < text.size() && '\n' == text[p + 1]) ? 2 : 1;
+            return 0;
+        }
+
+        // skip the backslash-newline sequences at the current position
+        void skip_splices()
+        {
+            for (;;) {
+                std::size_t len = 0;
+                if (pos < text.size() && '\\' == text[pos])
+                    len = 1;
+                else if (0 == text.compare(pos, 3, "?\?/"))
+                    len = 3;
+
+                std::size_t nl = (0 != len) ? newline_at(pos + len) : 0;
+                if (0 == nl)
+                    break;
+                pos += len + nl;
+            }
+        }
+
+        char current() const
+        {
+            return pos < text.size() ? text[pos] : '\0';
+        }
+
+        void advance()
+        {
+            pos += (std::max)(newline_at(pos), std::size_t(1));
+            skip_splices();
+        }
+
+        // match the given characters at the current position (looking
+        // through the line continuations) without consuming them
+        bool lookahead(char const *chars)
+        {
+            std::size_t const saved = pos;
+            for (/**/; '\0' != *chars; ++chars) {
+                if (pos >= text.size() || *chars != text[pos]) {
+                    pos = saved;
+                    return false;
+                }
+                advance();
+            }
+            pos = saved;
+            return true;
+        }
+
+        void consume(std::size_t count)
+        {
+            while (count-- > 0)
+                advance();
+        }
+
+        static bool is_identifier_char(char c)
+        {
+            return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+                ('0' <= c && c <= '9') || '_' == c || '$' == c;
+        }
+
+        // skip a C style comment, returns whether it spans several lines
+        bool skip_c_comment()
+        {
+            std::size_t const start = pos;
+            bool multiline = false;
+            consume(2);
+            while (pos < text.size()) {
+                if ('*' == current() && lookahead("*/")) {
+                    consume(2);
+                    return multiline;
+                }
+                multiline = multiline || 0 != newline_at(pos);
+                advance();
+            }
+            unterminated = start;
+            return multiline;
+        }
+
+        // skip a string or character literal, these end at the end of the
+        // line, an unterminated quote is a token of its own
+        void skip_quoted(char quote)
+        {
+            std::size_t const saved = pos;
+            std::size_t length = 0;
+            advance();
+            while (pos < text.size() && 0 == newline_at(pos)) {
+                char c = current();
+                if (quote == c) {
+                    if (0 == length && '\'' == quote)
+                        break;
+                    advance();
+                    return;
+                }
+                if ('\\' == c || lookahead("?\?/")) {
+                    consume('\\' == c ? 1 : 3);
+                    if (pos >= text.size() || 0 != newline_at(pos))
+                        break;
+                }
+                advance();
+                ++length;
+            }
+            pos = saved;
+            advance();
+        }
+
+        // skip a raw string literal starting at the opening quote, returns
+        // false (without consuming anything), if the delimiter is invalid
+        bool skip_raw_string()
+        {
+            std::size_t const saved = pos;
+            std::string delimiter(")");
+            advance();
+            for (;;) {
+                char c = current();
+                if ('(' == c)
+                    break;
+                if (pos >= text.size() || ')' == c || '\\' == c ||
+                    ' ' == c || '\t' == c || '\v' == c || '\f' == c ||
+                    '\r' == c || '\n' == c || delimiter.size() > 16)
+                {
+                    pos = saved;
+                    return false;
+                }
+                delimiter += c;
+                advance();
+            }
+            delimiter += '"';
+
+            advance();
+            while (pos < text.size()) {
+                if (lookahead(delimiter.c_str())) {
+                    consume(delimiter.size());
+                    break;
+                }
+                advance();
+            }
+            return true;
+        }
+
+        // skip the next token, returns true, if it ended the line (outside
+        // of a directive a comment spanning several lines ends it as well)
+        bool skip_token(bool in_directive)
+        {
+            std::size_t nl = newline_at(pos);
+            if (0 != nl) {
+                advance();
+                return true;
+            }
+
+            char c = current();
+            if ('/' == c) {
+                if (lookahead("//")) {
+                    while (pos < text.size() && 0 == newline_at(pos))
+                        advance();
+                    if (pos < text.size())
+                        advance();
+                    return true;
+                }
+                if (lookahead("/*"))
+                    return skip_c_comment() && !in_directive;
+            }
+            else if ('"' == c || '\'' == c) {
+                skip_quoted(c);
+                return false;
+            }
+            else if (('0' <= c && c <= '9') ||
+                ('.' == c && is_number_start()))
+            {
+                // a pp-number may contain digit separators
+                advance();
+                for (;;) {
+                    c = current();
+                    if ('e' == c || 'E' == c) {
+                        advance();
+                        if ('+' == current() || '-' == current())
+                            advance();
+                    }
+                    else if (is_identifier_char(c) || '.' == c) {
+                        advance();
+                    }
+                    else if ('\'' == c && is_separator()) {
+                        advance();
+                    }
+                    else {
+                        break;
+                    }
+                }
+                return false;
+            }
+            else if (is_identifier_char(c)) {
+                std::string name;
+                do {
+                    if (name.size() < 4)
+                        name += c;
+                    advance();
+                    c = current();
+                } while (is_identifier_char(c));
+
+                if (raw_strings && '"' == c &&
+                    ("R" == name || "LR" == name || "uR" == name ||
+                     "UR" == name || "u8R" == name))
+                {
+                    skip_raw_string();
+                }
+                return false;
+            }
+
+            advance();
+            return false;
+        }
+
+        // whether the '.' at the current position starts a number
+        bool is_number_start()
+        {
+            std::size_t const saved = pos;
+            advance();
+            char c = current();
+            pos = saved;
+            return '0' <= c && c <= '9';
+        }
+
+        // whether the ''' at the current position is a digit separator
+        bool is_separator()
+        {
+            std::size_t const saved = pos;
+            advance();
+            char c = current();
+            pos = saved;
+            return is_identifier_char(c);
+        }
+
+        // append the newlines contained in the given part of the text
+        void copy_newlines(std::size_t first, std::size_t last,
+            std::string &result) const
+        {
+            while (first < last) {
+                std::size_t nl = newline_at(first);
+                if (0 != nl) {
+                    result += '\n';
+                    first += nl;
+                }
+                else {
+                    ++first;
+                }
+            }
+        }
+
+        std::string const &text;
+        std::size_t pos;
+        std::size_t unterminated;   // start of a comment reaching the end
+        bool raw_strings;
+    };
+
+}   // namespace impl
+
+///////////////////////////////////////////////////////////////////////////////
+//  whether the lexer recognizes raw string literals for the given language
+inline bool
+need_raw_string_literals(language_support language)
+{
+    return need_cpp0x(language) || need_cpp2a(language) ||
+        need_cpp2b(language);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  reduce the given text to its directives
+inline void
+minimize_directives(std::string const &text, std::string &result,
+    bool raw_strings)
+{
+    impl::directive_minimizer(text, raw_strings).minimize(result);
+}
+
+inline std::string
+minimize_directives(std::string const &text, language_support language)
+{
+    std::string result;
+    minimize_directives(text, result, need_raw_string_literals(language));
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_DIRECTIVE_MINIMIZER_HPP_822B8EF5_4F91_42D4_A638_9905FF077391_INCLUDED)
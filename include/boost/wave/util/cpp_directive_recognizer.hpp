@@ -0,0 +1,304 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Recognizer for the preprocessor directives
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_DIRECTIVE_RECOGNIZER_HPP_3E8B1D07_5C2A_4F96_B1E4_70AD9C6F2E51_INCLUDED)
+#define BOOST_CPP_DIRECTIVE_RECOGNIZER_HPP_3E8B1D07_5C2A_4F96_B1E4_70AD9C6F2E51_INCLUDED
+
+#include <vector>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/token_ids.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The directive_parts template holds the pieces of a recognized
+//  preprocessor directive.
+//
+//      directive       the token of the directive itself (#define etc.)
+//      body            the tokens following the directive keyword, for
+//                      #ifdef, #ifndef, #undef and #region this is the name
+//                      only, for #define the macro definition (replacement
+//                      list) only
+//      macroname       #define only: the name of the defined macro
+//      has_parameters  #define only: the macro has a parameter list
+//      parameters      #define only: the formal macro parameters
+//      eoltokens       the whitespace at the end of the line and the token
+//                      terminating the directive
+//      found_eof       the directive was terminated by the end of the file
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename TokenT, typename ContainerT>
+struct directive_parts
+{
+    directive_parts() : has_parameters(false), found_eof(false) {}
+
+    TokenT directive;
+    ContainerT body;
+    TokenT macroname;
+    bool has_parameters;
+    std::vector<TokenT> parameters;
+    ContainerT eoltokens;
+    bool found_eof;
+};
+
+namespace impl {
+
+    // whitespace allowed inside a directive
+    inline bool is_pp_space(token_id id)
+    {
+        return T_SPACE == id || T_CCOMMENT == id;
+    }
+
+    // tokens ending a directive
+    inline bool is_pp_eol(token_id id)
+    {
+        return T_NEWLINE == id || T_CPPCOMMENT == id || T_EOF == id;
+    }
+
+    // tokens usable as a macro name (identifiers, keywords, alternative
+    // operator names like 'and' and true/false)
+    inline bool is_pp_name(token_id id)
+    {
+        return T_IDENTIFIER == id ||
+            KeywordTokenType == (id & (TokenTypeMask|PPTokenFlag)) ||
+            (OperatorTokenType|AltExtTokenType) ==
+                (id & (ExtTokenTypeMask|PPTokenFlag)) ||
+            BoolLiteralTokenType == (id & (TokenTypeMask|PPTokenFlag));
+    }
+
+    template <typename IteratorT>
+    inline bool skip_pp_space(IteratorT &it, IteratorT const &end)
+    {
+        bool skipped = false;
+        for (/**/; it != end && is_pp_space(token_id(*it)); ++it)
+            skipped = true;
+        return skipped;
+    }
+
+    // copy everything up to the end of the line
+    template <typename IteratorT, typename ContainerT>
+    inline void copy_to_pp_eol(IteratorT &it, IteratorT const &end,
+        ContainerT &body)
+    {
+        for (/**/; it != end && !is_pp_eol(token_id(*it)); ++it)
+            body.push_back(*it);
+    }
+
+    // match the end of the line, store the corresponding tokens
+    template <typename IteratorT, typename PartsT>
+    inline bool match_pp_eol(IteratorT &it, IteratorT const &end,
+        PartsT &parts)
+    {
+        for (/**/; it != end && is_pp_space(token_id(*it)); ++it)
+            parts.eoltokens.push_back(*it);
+
+        if (it == end || !is_pp_eol(token_id(*it)))
+            return false;
+
+        parts.found_eof = (T_EOF == token_id(*it));
+        parts.eoltokens.push_back(*it);
+        ++it;
+        return true;
+    }
+
+    // match '+ppsp name' (#ifdef, #ifndef, #undef, #region)
+    template <typename IteratorT, typename PartsT>
+    inline bool match_pp_name(IteratorT &it, IteratorT const &end,
+        PartsT &parts)
+    {
+        if (!skip_pp_space(it, end) || it == end || !is_pp_name(token_id(*it)))
+            return false;
+        parts.body.push_back(*it);
+        ++it;
+        return true;
+    }
+
+    // match the parameter list of a function like macro:
+    // '(' [name (',' name)*] ')', with optional whitespace between the tokens
+    template <typename IteratorT, typename PartsT>
+    inline bool match_pp_parameters(IteratorT &it, IteratorT const &end,
+        PartsT &parts)
+    {
+        using namespace boost::wave;
+
+        ++it;               // skip '('
+        skip_pp_space(it, end);
+        while (it != end) {
+            token_id id = token_id(*it);
+            if (T_RIGHTPAREN == id && parts.parameters.empty()) {
+                ++it;
+                return true;
+            }
+            if (!is_pp_name(id)
+#if BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
+                && T_ELLIPSIS != id
+#endif
+               )
+            {
+                return false;
+            }
+            parts.parameters.push_back(*it);
+            ++it;
+
+            skip_pp_space(it, end);
+            if (it == end)
+                break;
+            if (T_RIGHTPAREN == token_id(*it)) {
+                ++it;
+                return true;
+            }
+            if (T_COMMA != token_id(*it))
+                return false;
+            ++it;
+            skip_pp_space(it, end);
+        }
+        return false;
+    }
+
+    // trim trailing whitespace from the macro definition
+    template <typename ContainerT>
+    inline void trim_pp_definition(ContainerT &definition)
+    {
+        typename ContainerT::iterator last_nonwhite = definition.end();
+        typename ContainerT::iterator end = definition.end();
+        for (typename ContainerT::iterator it = definition.begin();
+             it != end; ++it)
+        {
+            if (!IS_CATEGORY(*it, WhiteSpaceTokenType))
+                last_nonwhite = it;
+        }
+        if (last_nonwhite != definition.end())
+            definition.erase(++last_nonwhite, definition.end());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  recognize_directive
+//
+//      Recognizes the preprocessor directive starting at the given position
+//      (which has to point to the directive token) and splits it into its
+//      parts. This accepts exactly the well formed directives accepted and
+//      handled by the cpp_grammar, everything else is left to the grammar
+//      (which classifies the ill formed directives for error reporting).
+//
+//      On success, 'it' points past the token terminating the directive. If
+//      the directive isn't recognized, false is returned. The directive token
+//      is stored in any case.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename IteratorT, typename TokenT, typename ContainerT>
+inline bool
+recognize_directive(IteratorT &it, IteratorT const &end,
+    directive_parts<TokenT, ContainerT> &parts)
+{
+    using namespace boost::wave;
+
+    parts.directive = *it;
+    token_id id = token_id(*it);
+    ++it;
+
+    switch (id) {
+    case T_PP_INCLUDE:          // #include ...
+#if BOOST_WAVE_SUPPORT_INCLUDE_NEXT != 0
+    case T_PP_INCLUDE_NEXT:     // #include_next ...
+#endif
+    case T_PP_PRAGMA:           // #pragma ...
+        impl::copy_to_pp_eol(it, end, parts.body);
+        break;
+
+    case T_PP_DEFINE:           // #define name[(parameters)] definition
+        if (!impl::skip_pp_space(it, end) || it == end ||
+            !impl::is_pp_name(token_id(*it)))
+        {
+            return false;
+        }
+        parts.macroname = *it;
+        ++it;
+
+        if (it != end && T_LEFTPAREN == token_id(*it)) {
+            if (!impl::match_pp_parameters(it, end, parts))
+                return false;
+            parts.has_parameters = true;
+            impl::skip_pp_space(it, end);
+        }
+        else if (!impl::skip_pp_space(it, end)) {
+            break;              // no definition at all
+        }
+        impl::copy_to_pp_eol(it, end, parts.body);
+        impl::trim_pp_definition(parts.body);
+        break;
+
+    case T_PP_UNDEF:            // #undef name
+    case T_PP_IFDEF:            // #ifdef name
+    case T_PP_IFNDEF:           // #ifndef name
+#if BOOST_WAVE_SUPPORT_MS_EXTENSIONS != 0
+    case T_MSEXT_PP_REGION:     // #region name
+#endif
+        if (!impl::match_pp_name(it, end, parts))
+            return false;
+        break;
+
+    case T_PP_IF:               // #if expression
+    case T_PP_ELIF:             // #elif expression
+        impl::copy_to_pp_eol(it, end, parts.body);
+        if (parts.body.empty())
+            return false;
+        break;
+
+    case T_PP_LINE:             // #line line-number ["filename"]
+        impl::skip_pp_space(it, end);
+        impl::copy_to_pp_eol(it, end, parts.body);
+        if (parts.body.empty())
+            return false;
+        break;
+
+    case T_PP_ERROR:            // #error ...
+#if BOOST_WAVE_SUPPORT_WARNING_DIRECTIVE != 0
+    case T_PP_WARNING:          // #warning ...
+#endif
+        impl::skip_pp_space(it, end);
+        impl::copy_to_pp_eol(it, end, parts.body);
+        break;
+
+#if BOOST_WAVE_SUPPORT_MS_EXTENSIONS != 0
+    case T_MSEXT_PP_ENDREGION:  // #endregion
+        break;
+#endif
+
+    default:                    // #something else
+        return false;
+    }
+    return impl::match_pp_eol(it, end, parts);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_DIRECTIVE_RECOGNIZER_HPP_3E8B1D07_5C2A_4F96_B1E4_70AD9C6F2E51_INCLUDED)
@@ -0,0 +1,216 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Snapshots of the contents of the include directories
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_DIRECTORY_SNAPSHOTS_HPP_0E6B93A1_27D4_4C58_9F3E_B84A1D5C62F7_INCLUDED)
+#define BOOST_CPP_DIRECTORY_SNAPSHOTS_HPP_0E6B93A1_27D4_4C58_9F3E_B84A1D5C62F7_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+#include <boost/unordered_map.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/filesystem_compatibility.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The class directory_snapshots answers, whether a file name (possibly
+//  containing subdirectories) names a file inside a given directory by
+//  looking at a snapshot of the directory contents instead of querying the
+//  file system for the file itself.
+//
+//      Every directory is read once, on its first use, and its entries are
+//      kept in a hash map together with their type. Subdirectories are read
+//      only if a file name refers to them.
+//
+//      Entries, which can't be judged from their directory entry alone
+//      (symbolic links and special files) and file names containing '.' or
+//      '..' components are left to the caller, the same holds for
+//      directories, which can't be read.
+//
+//      The snapshots assume, that the directories don't change while
+//      preprocessing, they should be disabled (or cleared) otherwise.
+//
+///////////////////////////////////////////////////////////////////////////////
+class directory_snapshots
+{
+public:
+    enum lookup_result {
+        file_absent,        // no (includable) file of the given name
+        file_present,       // a regular file of the given name exists
+        file_unknown        // the file system needs to be asked
+    };
+
+    directory_snapshots()
+    :   enabled(true), lookups(0), unknown(0), entries(0)
+    {}
+
+    lookup_result lookup(boost::filesystem::path const &dir,
+        std::string const &filename)
+    {
+        namespace fs = boost::filesystem;
+
+        ++lookups;
+
+        fs::path name(create_path(filename));
+        fs::path::iterator end = name.end();
+        fs::path::iterator last = end;
+        if (name.begin() == end || name.has_root_path()) {
+            ++unknown;
+            return file_unknown;
+        }
+        --last;
+
+        fs::path current(dir);
+        for (fs::path::iterator it = name.begin(); it != end; ++it) {
+            std::string component((*it).string());
+            if (component.empty() || component == "." || component == "..") {
+                ++unknown;
+                return file_unknown;
+            }
+
+            snapshot_type const *snapshot = get_snapshot(current);
+            if (0 == snapshot) {
+                ++unknown;
+                return file_unknown;
+            }
+
+            snapshot_type::const_iterator entry = snapshot->find(component);
+            if (entry == snapshot->end())
+                return file_absent;
+
+            if (it == last) {
+                switch ((*entry).second) {
+                case entry_file:        return file_present;
+                case entry_directory:   return file_absent;
+                default:                break;
+                }
+                ++unknown;
+                return file_unknown;
+            }
+
+            if (entry_directory != (*entry).second) {
+                if (entry_file == (*entry).second)
+                    return file_absent;         // a file isn't a directory
+                ++unknown;
+                return file_unknown;
+            }
+            current /= *it;
+        }
+        return file_absent;
+    }
+
+    // the snapshots may be disabled, f.e. if headers are generated while
+    // preprocessing
+    void enable(bool enable_ = true) { enabled = enable_; clear(); }
+    bool is_enabled() const { return enabled; }
+
+    void clear()
+    {
+        snapshots.clear();
+        lookups = unknown = entries = 0;
+    }
+
+    // statistics
+    std::size_t size() const { return snapshots.size(); }
+    std::size_t get_entries() const { return entries; }
+    std::size_t get_lookups() const { return lookups; }
+    std::size_t get_unknown() const { return unknown; }
+
+private:
+    enum entry_type {
+        entry_file,
+        entry_directory,
+        entry_other         // symbolic links, special files
+    };
+
+    typedef boost::unordered_map<std::string, entry_type> snapshot_type;
+
+    struct directory_info
+    {
+        directory_info() : readable(false) {}
+
+        bool readable;
+        snapshot_type contents;
+    };
+    typedef boost::unordered_map<std::string, directory_info>
+        directory_map_type;
+
+    // return the snapshot of the given directory, read it if necessary,
+    // returns 0 if the directory can't be read
+    snapshot_type const *get_snapshot(boost::filesystem::path const &dir)
+    {
+        namespace fs = boost::filesystem;
+
+        std::string key(dir.string());
+        directory_map_type::iterator it = snapshots.find(key);
+        if (it != snapshots.end())
+            return (*it).second.readable ? &(*it).second.contents : 0;
+
+        directory_info &info = snapshots[key];
+        boost::system::error_code ec;
+        fs::directory_iterator entry(dir, ec);
+        if (ec)
+            return 0;
+
+        for (/**/; entry != fs::directory_iterator(); entry.increment(ec)) {
+            if (ec)
+                return 0;
+
+            boost::system::error_code status_ec;
+            fs::file_status status = (*entry).symlink_status(status_ec);
+            entry_type type = entry_other;
+            if (!status_ec && fs::is_regular_file(status))
+                type = entry_file;
+            else if (!status_ec && fs::is_directory(status))
+                type = entry_directory;
+
+            info.contents[(*entry).path().filename().string()] = type;
+        }
+        if (ec)
+            return 0;
+
+        entries += info.contents.size();
+        info.readable = true;
+        return &info.contents;
+    }
+
+    directory_map_type snapshots;
+    bool enabled;
+    std::size_t lookups;
+    std::size_t unknown;
+    std::size_t entries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_DIRECTORY_SNAPSHOTS_HPP_0E6B93A1_27D4_4C58_9F3E_B84A1D5C62F7_INCLUDED)
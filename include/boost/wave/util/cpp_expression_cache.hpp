@@ -0,0 +1,131 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Cache of the results of evaluated #if/#elif expressions
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_EXPRESSION_CACHE_HPP_6A0F3C2E_94B1_4D8E_A7C5_2E19B0D4F873_INCLUDED)
+#define BOOST_CPP_EXPRESSION_CACHE_HPP_6A0F3C2E_94B1_4D8E_A7C5_2E19B0D4F873_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+#include <boost/unordered_map.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/token_ids.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The class conditional_expression_cache memoizes the results of the
+//  #if/#elif expressions, which evaluated without any error.
+//
+//      The result of an expression depends only on the fully macro expanded
+//      token sequence (with all undefined identifiers replaced by '0') and on
+//      the status of the enclosing conditional block, which decides whether
+//      an ill formed expression is reported. Both are encoded into the key,
+//      so no entry ever needs to be invalidated.
+//
+//      The key holds the id of every token and the value of all tokens but
+//      whitespace and comments, which makes it exact: different token
+//      sequences never share an entry.
+//
+///////////////////////////////////////////////////////////////////////////////
+class conditional_expression_cache
+{
+public:
+    conditional_expression_cache()
+    :   enabled(true), hits(0), misses(0)
+    {}
+
+    template <typename ContainerT>
+    static void make_key(ContainerT const &expanded, bool if_block_status,
+        std::string &key)
+    {
+        using namespace boost::wave;
+
+        key.clear();
+        key += if_block_status ? '1' : '0';
+
+        typename ContainerT::const_iterator end = expanded.end();
+        for (typename ContainerT::const_iterator it = expanded.begin();
+             it != end; ++it)
+        {
+            token_id id = token_id(*it);
+
+            key.append(reinterpret_cast<char const *>(&id), sizeof(id));
+            if (IS_CATEGORY(id, WhiteSpaceTokenType) || T_NEWLINE == id)
+                continue;           // the value doesn't matter
+
+            typename ContainerT::value_type::string_type const &value =
+                (*it).get_value();
+            std::size_t size = value.size();
+
+            key.append(reinterpret_cast<char const *>(&size), sizeof(size));
+            key.append(value.data(), size);
+        }
+    }
+
+    // look up the result for the given key, counts hits and misses
+    bool find(std::string const &key, bool &result)
+    {
+        map_type::const_iterator it = results.find(key);
+        if (it == results.end()) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        result = (*it).second;
+        return true;
+    }
+    void insert(std::string const &key, bool result)
+        { results[key] = result; }
+
+    // the cache may be disabled, f.e. by a hook, which needs every
+    // expression to be evaluated
+    void enable(bool enable_ = true) { enabled = enable_; }
+    bool is_enabled() const { return enabled; }
+
+    void clear() { results.clear(); hits = misses = 0; }
+
+    // statistics
+    std::size_t size() const { return results.size(); }
+    std::size_t get_hits() const { return hits; }
+    std::size_t get_misses() const { return misses; }
+
+private:
+    typedef boost::unordered_map<std::string, bool> map_type;
+
+    map_type results;
+    bool enabled;
+    std::size_t hits;
+    std::size_t misses;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_EXPRESSION_CACHE_HPP_6A0F3C2E_94B1_4D8E_A7C5_2E19B0D4F873_INCLUDED)
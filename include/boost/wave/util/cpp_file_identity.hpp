@@ -0,0 +1,110 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Identification of files independent of the path used to reach them
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_FILE_IDENTITY_HPP_4C81E0B7_95A2_4F3D_B6E8_2D07A9C35F14_INCLUDED)
+#define BOOST_CPP_FILE_IDENTITY_HPP_4C81E0B7_95A2_4F3D_B6E8_2D07A9C35F14_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <boost/wave/wave_config.hpp>
+
+#if !defined(BOOST_WINDOWS)
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  file_identity: identifies a file by its device and inode numbers, so
+//  that a file reached through different paths (symbolic or hard links,
+//  different spellings of a directory) is recognized as the same file.
+//
+//      If the file system doesn't provide these numbers (or the file can't
+//      be queried), the identity falls back to the (normalized) path of the
+//      file.
+//
+///////////////////////////////////////////////////////////////////////////////
+struct file_identity
+{
+    file_identity() : device(0), inode(0) {}
+
+    boost::uint64_t device;
+    boost::uint64_t inode;
+    std::string path;           // used only, if there is no device/inode
+
+    bool has_inode() const { return path.empty(); }
+
+    friend bool operator== (file_identity const &lhs, file_identity const &rhs)
+    {
+        return lhs.device == rhs.device && lhs.inode == rhs.inode &&
+            lhs.path == rhs.path;
+    }
+    friend bool operator!= (file_identity const &lhs, file_identity const &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend std::size_t hash_value(file_identity const &id)
+    {
+        if (!id.has_inode())
+            return boost::hash_value(id.path);
+
+        std::size_t seed = 0;
+        boost::hash_combine(seed, id.device);
+        boost::hash_combine(seed, id.inode);
+        return seed;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  Retrieve the identity of the file with the given (normalized) path
+inline file_identity
+get_file_identity(std::string const &path)
+{
+    file_identity id;
+#if !defined(BOOST_WINDOWS)
+    struct stat st;
+    if (0 == ::stat(path.c_str(), &st)) {
+        id.device = boost::uint64_t(st.st_dev);
+        id.inode = boost::uint64_t(st.st_ino);
+        return id;
+    }
+#endif
+    id.path = path;
+    return id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_FILE_IDENTITY_HPP_4C81E0B7_95A2_4F3D_B6E8_2D07A9C35F14_INCLUDED)
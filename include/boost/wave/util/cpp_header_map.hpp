@@ -0,0 +1,309 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Header maps: index files mapping include file names to file paths
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_HEADER_MAP_HPP_7A2E5C19_D3F8_4B61_8E07_C95B14A6F2D3_INCLUDED)
+#define BOOST_CPP_HEADER_MAP_HPP_7A2E5C19_D3F8_4B61_8E07_C95B14A6F2D3_INCLUDED
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/filesystem_compatibility.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Header maps
+//
+//      A header map is a binary index file mapping the names of include
+//      files, as they are spelled in #include directives (f.e. 'sub/foo.h'),
+//      to the paths of the files. Build systems knowing where every header
+//      lives can generate one and put it into the include search path,
+//      where it replaces the search of the directories it was built from.
+//
+//      The file is mapped into memory and the names are looked up by hash,
+//      its layout is (all numbers are 32 bit little endian integers):
+//
+//          header      "WHMP", version (1), number of buckets (a power of
+//                      two), number of entries, offset and size of the
+//                      string table
+//          buckets     offsets of the name and of the path of an entry into
+//                      the string table, a zero name offset marks an empty
+//                      bucket; an entry is stored in the first empty bucket
+//                      following the one selected by the (FNV-1a) hash of
+//                      its name
+//          strings     the zero terminated names and paths, starting with an
+//                      empty string
+//
+///////////////////////////////////////////////////////////////////////////////
+namespace header_map_format {
+
+    char const magic[4] = { 'W', 'H', 'M', 'P' };
+    boost::uint32_t const version = 1;
+    std::size_t const header_size = 24;
+    std::size_t const bucket_size = 8;
+
+    inline boost::uint32_t hash(char const *name, std::size_t len)
+    {
+        boost::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < len; ++i) {
+            h ^= (unsigned char)name[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    inline boost::uint32_t read_uint32(unsigned char const *p)
+    {
+        return boost::uint32_t(p[0]) | (boost::uint32_t(p[1]) << 8) |
+            (boost::uint32_t(p[2]) << 16) | (boost::uint32_t(p[3]) << 24);
+    }
+
+    inline void append_uint32(std::string &out, boost::uint32_t value)
+    {
+        out += char(value & 0xff);
+        out += char((value >> 8) & 0xff);
+        out += char((value >> 16) & 0xff);
+        out += char((value >> 24) & 0xff);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  header_map: a loaded (memory mapped) header map
+//
+///////////////////////////////////////////////////////////////////////////////
+class header_map : boost::noncopyable
+{
+public:
+    header_map()
+    :   data(0), bucket_count(0), entry_count(0), strings(0), strings_size(0)
+    {}
+
+    // map the given file, returns false if it's not a valid header map
+    bool load(std::string const &filename_)
+    {
+        namespace ipc = boost::interprocess;
+        using namespace header_map_format;
+
+        data = 0;
+        try {
+            ipc::file_mapping file(filename_.c_str(), ipc::read_only);
+            ipc::mapped_region mapped(file, ipc::read_only);
+            region.swap(mapped);
+        }
+        catch (ipc::interprocess_exception const &) {
+            return false;
+        }
+
+        unsigned char const *base =
+            static_cast<unsigned char const *>(region.get_address());
+        std::size_t size = region.get_size();
+        if (size < header_size || 0 != std::memcmp(base, magic, 4) ||
+            version != read_uint32(base + 4))
+        {
+            return false;
+        }
+
+        boost::uint32_t buckets = read_uint32(base + 8);
+        boost::uint32_t strings_offset = read_uint32(base + 16);
+        boost::uint32_t strings_size_ = read_uint32(base + 20);
+
+        // the buckets and the string table have to fit into the file, the
+        // string table has to start with an empty string and has to end
+        // with a terminating zero
+        if (0 == buckets || 0 != (buckets & (buckets - 1)) ||
+            buckets > (size - header_size) / bucket_size ||
+            strings_offset < header_size + buckets * bucket_size ||
+            strings_offset > size || strings_size_ > size - strings_offset ||
+            0 == strings_size_ || 0 != base[strings_offset] ||
+            0 != base[strings_offset + strings_size_ - 1])
+        {
+            return false;
+        }
+
+        data = base;
+        bucket_count = buckets;
+        entry_count = read_uint32(base + 12);
+        strings = reinterpret_cast<char const *>(base + strings_offset);
+        strings_size = strings_size_;
+        filename = filename_;
+        return true;
+    }
+    bool is_loaded() const { return 0 != data; }
+
+    // look up the given include file name, returns the mapped path
+    bool find(std::string const &name, std::string &path) const
+    {
+        using namespace header_map_format;
+
+        if (0 == data)
+            return false;
+
+        boost::uint32_t mask = bucket_count - 1;
+        boost::uint32_t bucket = hash(name.c_str(), name.size()) & mask;
+        for (boost::uint32_t probes = 0; probes != bucket_count; ++probes) {
+            unsigned char const *entry =
+                data + header_size + bucket * bucket_size;
+            boost::uint32_t name_offset = read_uint32(entry);
+            if (0 == name_offset)
+                return false;       // empty bucket: not in the map
+
+            boost::uint32_t path_offset = read_uint32(entry + 4);
+            if (name_offset < strings_size && path_offset < strings_size &&
+                0 == std::strcmp(strings + name_offset, name.c_str()))
+            {
+                path = strings + path_offset;
+                return true;
+            }
+            bucket = (bucket + 1) & mask;
+        }
+        return false;
+    }
+
+    // check whether one of the entries is mapped to the given (normalized)
+    // file, i.e. whether the file was found through this header map, the
+    // search of an #include_next directive continues after the map then
+    bool maps_to(boost::filesystem::path const &file) const
+    {
+        using namespace header_map_format;
+
+        if (0 == data)
+            return false;
+
+        for (boost::uint32_t bucket = 0; bucket != bucket_count; ++bucket) {
+            unsigned char const *entry =
+                data + header_size + bucket * bucket_size;
+            boost::uint32_t name_offset = read_uint32(entry);
+            boost::uint32_t path_offset = read_uint32(entry + 4);
+            if (0 == name_offset || path_offset >= strings_size)
+                continue;
+
+            boost::filesystem::path mapped(create_path(strings + path_offset));
+            if (normalize(mapped) == file)
+                return true;
+        }
+        return false;
+    }
+
+    std::string const &get_filename() const { return filename; }
+    std::size_t size() const { return entry_count; }
+
+private:
+    boost::interprocess::mapped_region region;
+    unsigned char const *data;
+    boost::uint32_t bucket_count;
+    boost::uint32_t entry_count;
+    char const *strings;
+    boost::uint32_t strings_size;
+    std::string filename;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  header_map_builder: collects the entries of a header map and writes the
+//  header map file
+//
+///////////////////////////////////////////////////////////////////////////////
+class header_map_builder
+{
+public:
+    // add a mapping, the first one added for a name wins
+    bool add(std::string const &name, std::string const &path)
+    {
+        if (name.empty())
+            return false;
+        return entries.insert(entry_map_type::value_type(name, path)).second;
+    }
+
+    std::size_t size() const { return entries.size(); }
+
+    bool write(std::string const &filename) const
+    {
+        using namespace header_map_format;
+
+        // keep the load factor at or below 1/2
+        boost::uint32_t buckets = 1;
+        while (buckets < 2 * entries.size())
+            buckets *= 2;
+
+        std::string string_table(1, '\0');
+        std::vector<boost::uint32_t> bucket_data(2 * buckets, 0);
+
+        entry_map_type::const_iterator end = entries.end();
+        for (entry_map_type::const_iterator it = entries.begin(); it != end; ++it)
+        {
+            boost::uint32_t name_offset = boost::uint32_t(string_table.size());
+            string_table.append((*it).first.c_str(), (*it).first.size() + 1);
+            boost::uint32_t path_offset = boost::uint32_t(string_table.size());
+            string_table.append((*it).second.c_str(), (*it).second.size() + 1);
+
+            boost::uint32_t bucket =
+                hash((*it).first.c_str(), (*it).first.size()) & (buckets - 1);
+            while (0 != bucket_data[2 * bucket])
+                bucket = (bucket + 1) & (buckets - 1);
+            bucket_data[2 * bucket] = name_offset;
+            bucket_data[2 * bucket + 1] = path_offset;
+        }
+
+        std::string out(magic, sizeof(magic));
+        append_uint32(out, version);
+        append_uint32(out, buckets);
+        append_uint32(out, boost::uint32_t(entries.size()));
+        append_uint32(out, boost::uint32_t(header_size + buckets * bucket_size));
+        append_uint32(out, boost::uint32_t(string_table.size()));
+        for (std::size_t i = 0; i < bucket_data.size(); ++i)
+            append_uint32(out, bucket_data[i]);
+        out += string_table;
+
+        std::ofstream file(filename.c_str(),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(out.data(), std::streamsize(out.size()));
+        return file.good();
+    }
+
+private:
+    typedef std::map<std::string, std::string> entry_map_type;
+    entry_map_type entries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_HEADER_MAP_HPP_7A2E5C19_D3F8_4B61_8E07_C95B14A6F2D3_INCLUDED)
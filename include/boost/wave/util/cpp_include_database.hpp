@@ -0,0 +1,382 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Persistent database of include file lookups
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_INCLUDE_DATABASE_HPP_E93F1A62_0B7C_4D85_A1F4_6C28D9B3E570_INCLUDED)
+#define BOOST_CPP_INCLUDE_DATABASE_HPP_E93F1A62_0B7C_4D85_A1F4_6C28D9B3E570_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/cpp_include_lookup_cache.hpp>
+#include <boost/wave/util/binary_file_io.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  include_database: keeps the results of the include file lookups across
+//  runs of the preprocessor, f.e. for all the compilation steps of a build
+//
+//      The lookups are stored per configuration, i.e. per hash of the
+//      ordered include search lists (see include_paths). Every lookup
+//      result records the directories (or header maps), whose contents it
+//      depends on. A result is reused only, if none of these changed its
+//      modification time since the result was stored.
+//
+//      As the modification times have a resolution of one second only,
+//      directories modified during the second the database was written are
+//      not trusted in the next run.
+//
+//      Concurrent writers don't corrupt the file (it's replaced atomically),
+//      but the lookups stored by one of them may be lost.
+//
+///////////////////////////////////////////////////////////////////////////////
+class include_database
+{
+public:
+    typedef include_lookup_cache::resolution resolution;
+
+    include_database()
+    :   current(0), hits(0), misses(0), invalidated(0)
+    {}
+
+    // read the database from the given file, a missing file is not an
+    // error (the database starts empty), a corrupt file is
+    bool load(std::string const &filename_)
+    {
+        filename = filename_;
+        sections.clear();
+        current = 0;
+
+        std::string data;
+        if (!binary_file_io::read_file(filename, data))
+            return true;
+
+        if (!parse(data, sections)) {
+            sections.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // write the database back to the file it was loaded from, merging the
+    // configurations stored meanwhile by others
+    bool save()
+    {
+        if (filename.empty())
+            return false;
+
+        bool modified = false;
+        section_map_type::iterator end = sections.end();
+        for (section_map_type::iterator it = sections.begin(); it != end; ++it)
+        {
+            if ((*it).second.modified) {
+                (*it).second.written = std::time(0);
+                modified = true;
+            }
+        }
+        if (!modified)
+            return true;
+
+        section_map_type merged;
+        std::string data;
+        if (binary_file_io::read_file(filename, data) && !parse(data, merged))
+            merged.clear();
+        for (section_map_type::iterator it = sections.begin(); it != end; ++it)
+        {
+            if ((*it).second.modified || merged.find((*it).first) == merged.end())
+                merged[(*it).first] = (*it).second;
+        }
+
+        serialize(merged, data);
+        if (!binary_file_io::write_file(boost::filesystem::path(filename),
+                data))
+        {
+            return false;
+        }
+
+        for (section_map_type::iterator it = sections.begin(); it != end; ++it)
+            (*it).second.modified = false;
+        return true;
+    }
+
+    // select the configuration the following lookups belong to, drops the
+    // stored lookups, which are outdated
+    void select_configuration(boost::uint64_t config)
+    {
+        current = &sections[config];
+        if (!current->validated)
+            validate(*current);
+    }
+    bool has_configuration() const { return 0 != current; }
+
+    bool find(std::string const &key, resolution &result)
+    {
+        if (0 != current) {
+            entry_map_type::const_iterator it = current->entries.find(key);
+            if (it != current->entries.end()) {
+                ++hits;
+                result = (*it).second.result;
+                return true;
+            }
+        }
+        ++misses;
+        return false;
+    }
+
+    // store a lookup together with the directories it depends on
+    void insert(std::string const &key, resolution const &result,
+        std::vector<std::string> const &dependencies)
+    {
+        if (0 == current)
+            return;
+
+        entry &e = current->entries[key];
+        e.result = result;
+        e.dependencies.clear();
+        std::vector<std::string>::const_iterator end = dependencies.end();
+        for (std::vector<std::string>::const_iterator it = dependencies.begin();
+             it != end; ++it)
+        {
+            boost::uint32_t index = current->get_directory(*it);
+            if (std::find(e.dependencies.begin(), e.dependencies.end(), index) ==
+                e.dependencies.end())
+            {
+                e.dependencies.push_back(index);
+            }
+        }
+        current->modified = true;
+    }
+
+    // hash the description of a configuration
+    static boost::uint64_t hash(std::string const &config)
+    {
+        boost::uint64_t h = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < config.size(); ++i) {
+            h ^= (unsigned char)config[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    // statistics
+    std::string const &get_filename() const { return filename; }
+    std::size_t size() const
+        { return 0 != current ? current->entries.size() : 0; }
+    std::size_t get_configurations() const { return sections.size(); }
+    std::size_t get_directories() const
+        { return 0 != current ? current->directories.size() : 0; }
+    std::size_t get_hits() const { return hits; }
+    std::size_t get_misses() const { return misses; }
+    std::size_t get_invalidated() const { return invalidated; }
+
+private:
+    struct entry
+    {
+        resolution result;
+        std::vector<boost::uint32_t> dependencies;
+    };
+    typedef boost::unordered_map<std::string, entry> entry_map_type;
+
+    struct section
+    {
+        section() : written(0), validated(false), modified(false) {}
+
+        boost::uint32_t get_directory(std::string const &path)
+        {
+            boost::unordered_map<std::string, boost::uint32_t>::iterator it =
+                directory_index.find(path);
+            if (it != directory_index.end())
+                return (*it).second;
+
+            boost::uint32_t index = boost::uint32_t(directories.size());
+            directories.push_back(path);
+            mtimes.push_back(binary_file_io::modification_time(path));
+            directory_index[path] = index;
+            return index;
+        }
+
+        std::vector<std::string> directories;
+        std::vector<boost::int64_t> mtimes;
+        boost::unordered_map<std::string, boost::uint32_t> directory_index;
+        entry_map_type entries;
+        boost::int64_t written;
+        bool validated;
+        bool modified;
+    };
+    typedef std::map<boost::uint64_t, section> section_map_type;
+
+    void validate(section &s)
+    {
+        std::vector<bool> valid(s.directories.size());
+        for (std::size_t i = 0; i < s.directories.size(); ++i) {
+            boost::int64_t mtime =
+                binary_file_io::modification_time(s.directories[i]);
+            valid[i] = -1 != mtime && mtime == s.mtimes[i] && mtime < s.written;
+            s.mtimes[i] = mtime;
+        }
+
+        entry_map_type::iterator it = s.entries.begin();
+        while (it != s.entries.end()) {
+            bool outdated = false;
+            std::vector<boost::uint32_t> const &deps = (*it).second.dependencies;
+            for (std::size_t i = 0; i < deps.size() && !outdated; ++i)
+                outdated = deps[i] >= valid.size() || !valid[deps[i]];
+
+            if (outdated) {
+                it = s.entries.erase(it);
+                ++invalidated;
+                s.modified = true;
+            }
+            else {
+                ++it;
+            }
+        }
+        s.validated = true;
+    }
+
+    // file format: "WIDB", version, then the sections, each consisting of
+    // the configuration hash, the time it was written, the directories it
+    // depends on (with their modification times) and the lookups (key,
+    // result and the indices of the directories they depend on), see
+    // binary_file_io
+    static void serialize(section_map_type const &sections_, std::string &out)
+    {
+        using binary_file_io::write_uint;
+        using binary_file_io::write_string;
+
+        out.assign("WIDB", 4);
+        write_uint(out, 1, 4);
+        write_uint(out, sections_.size(), 4);
+
+        section_map_type::const_iterator end = sections_.end();
+        for (section_map_type::const_iterator it = sections_.begin();
+             it != end; ++it)
+        {
+            section const &s = (*it).second;
+            write_uint(out, (*it).first, 8);
+            write_uint(out, boost::uint64_t(s.written), 8);
+
+            write_uint(out, s.directories.size(), 4);
+            for (std::size_t i = 0; i < s.directories.size(); ++i) {
+                write_string(out, s.directories[i]);
+                write_uint(out, boost::uint64_t(s.mtimes[i]), 8);
+            }
+
+            write_uint(out, s.entries.size(), 4);
+            entry_map_type::const_iterator eend = s.entries.end();
+            for (entry_map_type::const_iterator e = s.entries.begin();
+                 e != eend; ++e)
+            {
+                write_string(out, (*e).first);
+                write_uint(out, (*e).second.result.found ? 1 : 0, 1);
+                write_string(out, (*e).second.result.file);
+                write_string(out, (*e).second.result.dir);
+                write_uint(out, (*e).second.dependencies.size(), 4);
+                for (std::size_t i = 0; i < (*e).second.dependencies.size(); ++i)
+                    write_uint(out, (*e).second.dependencies[i], 4);
+            }
+        }
+    }
+
+    static bool parse(std::string const &data, section_map_type &sections_)
+    {
+        if (data.size() < 4 || 0 != data.compare(0, 4, "WIDB"))
+            return false;
+
+        binary_file_io::reader in(data, 4);
+        boost::uint64_t version = 0, count = 0;
+        if (!in.read_uint(version, 4) || 1 != version || !in.read_uint(count, 4))
+            return false;
+
+        for (boost::uint64_t n = 0; n < count; ++n) {
+            boost::uint64_t config = 0, written = 0, dirs = 0, entries = 0;
+            if (!in.read_uint(config, 8) || !in.read_uint(written, 8) ||
+                !in.read_uint(dirs, 4))
+            {
+                return false;
+            }
+
+            section &s = sections_[config];
+            s.written = boost::int64_t(written);
+            for (boost::uint64_t i = 0; i < dirs; ++i) {
+                std::string path;
+                boost::uint64_t mtime = 0;
+                if (!in.read_string(path) || !in.read_uint(mtime, 8))
+                    return false;
+                s.directory_index[path] = boost::uint32_t(s.directories.size());
+                s.directories.push_back(path);
+                s.mtimes.push_back(boost::int64_t(mtime));
+            }
+
+            if (!in.read_uint(entries, 4))
+                return false;
+            for (boost::uint64_t i = 0; i < entries; ++i) {
+                std::string key;
+                entry e;
+                boost::uint64_t found = 0, deps = 0;
+                if (!in.read_string(key) || !in.read_uint(found, 1) ||
+                    !in.read_string(e.result.file) ||
+                    !in.read_string(e.result.dir) || !in.read_uint(deps, 4))
+                {
+                    return false;
+                }
+                e.result.found = 0 != found;
+                for (boost::uint64_t d = 0; d < deps; ++d) {
+                    boost::uint64_t index = 0;
+                    if (!in.read_uint(index, 4))
+                        return false;
+                    e.dependencies.push_back(boost::uint32_t(index));
+                }
+                s.entries[key] = e;
+            }
+        }
+        return in.at_end();
+    }
+
+    std::string filename;
+    section_map_type sections;
+    section *current;
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t invalidated;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_INCLUDE_DATABASE_HPP_E93F1A62_0B7C_4D85_A1F4_6C28D9B3E570_INCLUDED)
@@ -0,0 +1,179 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Cache of the results of include file lookups
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_INCLUDE_LOOKUP_CACHE_HPP_C41D7E2B_8A93_4F05_B6E1_5D02A9F3C78E_INCLUDED)
+#define BOOST_CPP_INCLUDE_LOOKUP_CACHE_HPP_C41D7E2B_8A93_4F05_B6E1_5D02A9F3C78E_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+#include <boost/unordered_map.hpp>
+
+#include <boost/wave/wave_config.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  The class include_lookup_cache memoizes the work done by the include_paths
+//  class while searching the include directories for a file.
+//
+//      The resolutions map the complete description of a lookup (the file
+//      name as spelled in the directive, whether it was a <file> or a "file"
+//      inclusion, the directory of the including file, if it is searched,
+//      and the file where an #include_next starts searching) to its result,
+//      i.e. the found file or the fact, that the file couldn't be found.
+//      These depend on the configured include paths, so they are dropped
+//      whenever an include path is added.
+//
+//      The probes map every candidate file tested during a search (a file
+//      name appended to one of the include directories) to whether it names
+//      an includable file. This avoids the repeated file system queries for
+//      the same candidate from different lookups, especially for the
+//      directories, which don't contain the file (negative lookups).
+//
+//      Both assume, that the file system doesn't change while preprocessing,
+//      the cache should be disabled (or cleared) otherwise.
+//
+///////////////////////////////////////////////////////////////////////////////
+class include_lookup_cache
+{
+public:
+    // the result of a resolved lookup
+    struct resolution
+    {
+        resolution() : found(false) {}
+        resolution(std::string const &file_, std::string const &dir_)
+        :   found(true), file(file_), dir(dir_)
+        {}
+
+        bool found;
+        std::string file;           // normalized full name of the found file
+        std::string dir;            // path as seen from the including file
+    };
+
+    include_lookup_cache()
+    :   enabled(true), hits(0), misses(0), probe_hits(0), probe_misses(0)
+    {}
+
+    // the parts of a lookup key, which aren't needed, are passed as empty
+    // strings resp. as a null pointer
+    static void make_key(std::string const &spelling, bool is_system,
+        std::string const &includer_dir, char const *include_next_start,
+        std::string &key)
+    {
+        key.clear();
+        key += is_system ? '<' : '"';
+        key += spelling;
+        key += '\0';
+        key += includer_dir;
+        if (0 != include_next_start) {
+            key += '\0';
+            key += include_next_start;
+        }
+    }
+
+    // look up the result for the given key, counts hits and misses
+    bool find(std::string const &key, resolution &result)
+    {
+        resolution_map_type::const_iterator it = resolutions.find(key);
+        if (it == resolutions.end()) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        result = (*it).second;
+        return true;
+    }
+    void insert(std::string const &key, resolution const &result)
+        { resolutions[key] = result; }
+
+    // look up, whether the given candidate file was found to be includable
+    bool find_probe(std::string const &candidate, bool &includable)
+    {
+        probe_map_type::const_iterator it = probes.find(candidate);
+        if (it == probes.end()) {
+            ++probe_misses;
+            return false;
+        }
+        ++probe_hits;
+        includable = (*it).second;
+        return true;
+    }
+    void insert_probe(std::string const &candidate, bool includable)
+        { probes[candidate] = includable; }
+
+    // the cache may be disabled, f.e. if files are generated while
+    // preprocessing
+    void enable(bool enable_ = true) { enabled = enable_; clear(); }
+    bool is_enabled() const { return enabled; }
+
+    // the include paths changed, the probes stay valid
+    void clear_resolutions() { resolutions.clear(); }
+    void clear()
+    {
+        resolutions.clear();
+        probes.clear();
+        hits = misses = probe_hits = probe_misses = 0;
+    }
+
+    // statistics
+    std::size_t size() const { return resolutions.size(); }
+    std::size_t get_hits() const { return hits; }
+    std::size_t get_misses() const { return misses; }
+    std::size_t probes_size() const { return probes.size(); }
+    std::size_t get_probe_hits() const { return probe_hits; }
+    std::size_t get_probe_misses() const { return probe_misses; }
+    std::size_t get_negative_probes() const
+    {
+        std::size_t count = 0;
+        probe_map_type::const_iterator end = probes.end();
+        for (probe_map_type::const_iterator it = probes.begin(); it != end; ++it)
+        {
+            if (!(*it).second)
+                ++count;
+        }
+        return count;
+    }
+
+private:
+    typedef boost::unordered_map<std::string, resolution> resolution_map_type;
+    typedef boost::unordered_map<std::string, bool> probe_map_type;
+
+    resolution_map_type resolutions;
+    probe_map_type probes;
+    bool enabled;
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t probe_hits;
+    std::size_t probe_misses;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_INCLUDE_LOOKUP_CACHE_HPP_C41D7E2B_8A93_4F05_B6E1_5D02A9F3C78E_INCLUDED)
@@ -14,20 +14,37 @@
 #include <string>
 #include <list>
 #include <utility>
+#include <map>
 
 #include <boost/assert.hpp>
 #include <boost/wave/wave_config.hpp>
 #include <boost/wave/util/filesystem_compatibility.hpp>
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+#include <vector>
+#include <boost/wave/util/cpp_include_lookup_cache.hpp>
+#include <boost/wave/util/cpp_include_database.hpp>
+#include <boost/wave/cpp_shared_resources.hpp>
+#endif
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+#include <boost/wave/util/cpp_directory_snapshots.hpp>
+#endif
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+#include <boost/shared_ptr.hpp>
+#include <boost/wave/util/cpp_header_map.hpp>
+#endif
 
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
+#include <boost/unordered_map.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/wave/util/cpp_file_identity.hpp>
 #endif
 
 #if BOOST_WAVE_SERIALIZATION != 0
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/utility.hpp>
+#include <boost/serialization/list.hpp>
 #include <boost/serialization/collections_save_imp.hpp>
 #include <boost/serialization/collections_load_imp.hpp>
 #include <boost/serialization/split_free.hpp>
@@ -46,58 +63,40 @@ namespace boost { namespace wave { namespace util {
 
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
 ///////////////////////////////////////////////////////////////////////////////
-//  Tags for accessing both sides of a bidirectional map
+//  Tags for accessing both sides of the table of include once files
 struct from {};
 struct to {};
 
 ///////////////////////////////////////////////////////////////////////////////
-//  The class template bidirectional_map wraps the specification
-//  of a bidirectional map based on multi_index_container.
-template<typename FromType, typename ToType>
-struct bidirectional_map
+//  The table of files containing a #pragma once or include guards, indexed
+//  by the identity of the file and by the name of the guard.
+struct include_once_entry
 {
-    typedef std::pair<FromType, ToType> value_type;
-
-#if defined(BOOST_NO_POINTER_TO_MEMBER_TEMPLATE_PARAMETERS) || \
-    (defined(BOOST_MSVC) && (BOOST_MSVC == 1600) ) || \
-    (defined(BOOST_INTEL_CXX_VERSION) && \
-        (defined(_MSC_VER) && (BOOST_INTEL_CXX_VERSION <= 700)))
-
-    BOOST_STATIC_CONSTANT(unsigned, from_offset = offsetof(value_type, first));
-    BOOST_STATIC_CONSTANT(unsigned, to_offset   = offsetof(value_type, second));
-
-    typedef boost::multi_index::multi_index_container<
-        value_type,
-        boost::multi_index::indexed_by<
-            boost::multi_index::ordered_unique<
-                boost::multi_index::tag<from>,
-                boost::multi_index::member_offset<value_type, FromType, from_offset>
-            >,
-            boost::multi_index::ordered_non_unique<
-                boost::multi_index::tag<to>,
-                boost::multi_index::member_offset<value_type, ToType, to_offset>
-            >
-        >
-    > type;
-
-#else
-
-  typedef boost::multi_index::multi_index_container<
-      value_type,
-      boost::multi_index::indexed_by<
-          boost::multi_index::ordered_unique<
-              boost::multi_index::tag<from>,
-              boost::multi_index::member<value_type, FromType, &value_type::first>
-          >,
-          boost::multi_index::ordered_non_unique<
-              boost::multi_index::tag<to>,
-              boost::multi_index::member<value_type, ToType, &value_type::second>
-          >
-      >
-  > type;
+    include_once_entry(file_identity const &id_, std::string const &filename_,
+            std::string const &guard_name_)
+    :   id(id_), filename(filename_), guard_name(guard_name_)
+    {}
 
-#endif
+    file_identity id;
+    std::string filename;       // the name the file was first seen under
+    std::string guard_name;
 };
+
+typedef boost::multi_index::multi_index_container<
+    include_once_entry,
+    boost::multi_index::indexed_by<
+        boost::multi_index::hashed_unique<
+            boost::multi_index::tag<from>,
+            boost::multi_index::member<
+                include_once_entry, file_identity, &include_once_entry::id>
+        >,
+        boost::multi_index::hashed_non_unique<
+            boost::multi_index::tag<to>,
+            boost::multi_index::member<
+                include_once_entry, std::string, &include_once_entry::guard_name>
+        >
+    >
+> include_once_set_type;
 #endif // BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
 
 #if BOOST_WAVE_SERIALIZATION != 0
@@ -134,6 +133,22 @@ struct load_filepos
 //      directories are searched before the current one and which are searched
 //      after.
 //
+//      The results of the lookups are cached (see include_lookup_cache), if
+//      BOOST_WAVE_CACHE_INCLUDE_LOOKUPS is defined to something != 0. In
+//      this case they may be kept across runs as well, by attaching a
+//      database with the 'set_include_database()' function, and shared with
+//      other (concurrently running) contexts by attaching a shared_resources
+//      object with the 'set_shared_resources()' function. The
+//      contents of the searched directories are read once and kept in memory
+//      (see directory_snapshots), if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES
+//      is defined to something != 0.
+//
+//      Header maps (see header_map) added with the 'add_header_map()'
+//      function take the place of a directory in the search lists. A file
+//      name found in a header map is resolved to the file it maps to, without
+//      searching any further directories, if BOOST_WAVE_SUPPORT_HEADER_MAPS
+//      is defined to something != 0.
+//
 ///////////////////////////////////////////////////////////////////////////////
 class include_paths
 {
@@ -142,16 +157,15 @@ private:
         include_list_type;
     typedef include_list_type::value_type include_value_type;
 
-#if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
-    typedef bidirectional_map<std::string, std::string>::type
-        pragma_once_set_type;
-#endif
-
 public:
     include_paths()
     :   was_sys_include_path(false),
+        base_dir(initial_path()),
         current_dir(initial_path()),
         current_rel_dir(initial_path())
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+      , database(0), database_selected(false), dependencies(0), resources(0)
+#endif
     {}
 
     bool add_include_path(char const *path_, bool is_system = false)
@@ -159,24 +173,128 @@ public:
         return add_include_path(path_, (is_system || was_sys_include_path) ?
             system_include_paths : user_include_paths);
     }
-    void set_sys_include_delimiter() { was_sys_include_path = true; }
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+    bool add_header_map(char const *file_, bool is_system = false)
+    {
+        return add_header_map(file_, (is_system || was_sys_include_path) ?
+            system_include_paths : user_include_paths);
+    }
+#endif
+    void set_sys_include_delimiter()
+    {
+        was_sys_include_path = true;
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        lookup_cache.clear_resolutions();
+        database_selected = false;
+        configuration.clear();
+#endif
+    }
     bool find_include_file (std::string &s, std::string &dir, bool is_system,
         char const *current_file) const;
     void set_current_directory(char const *path_);
     boost::filesystem::path get_current_directory() const
         { return current_dir; }
 
+    // the directory the relative paths are completed against (defaults to
+    // the initial directory of the program), set it before adding the include
+    // paths and before starting the preprocessing
+    void set_base_directory(boost::filesystem::path const &dir)
+    {
+        base_dir = dir;
+        current_dir = dir;
+        current_rel_dir = dir;
+    }
+    boost::filesystem::path const &get_base_directory() const
+        { return base_dir; }
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    // access the cache of the include file lookups (f.e. to disable it or to
+    // retrieve its hit rate)
+    include_lookup_cache &get_lookup_cache() { return lookup_cache; }
+    include_lookup_cache const &get_lookup_cache() const
+        { return lookup_cache; }
+
+    // attach a database keeping the lookups across runs (the database isn't
+    // owned by the include_paths object), used only while the cache is
+    // enabled
+    void set_include_database(include_database *database_)
+    {
+        database = database_;
+        database_selected = false;
+    }
+    include_database *get_include_database() const { return database; }
+
+    // share the lookups with other include_paths objects (the resources
+    // aren't owned by the include_paths object), used only while the cache
+    // is enabled
+    void set_shared_resources(boost::wave::shared_resources *resources_)
+        { resources = resources_; }
+    boost::wave::shared_resources *get_shared_resources() const
+        { return resources; }
+#endif
+
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+    // access the snapshots of the searched directories (f.e. to disable
+    // them)
+    directory_snapshots &get_directory_snapshots() { return snapshots; }
+    directory_snapshots const &get_directory_snapshots() const
+        { return snapshots; }
+#endif
+
 protected:
+    bool search_include_file (std::string &s, std::string &dir, bool is_system,
+        char const *current_file) const;
     bool find_include_file (std::string &s, std::string &dir,
         include_list_type const &pathes, char const *) const;
     bool add_include_path(char const *path_, include_list_type &pathes_);
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+    bool add_header_map(char const *file_, include_list_type &pathes_);
+    bool find_in_header_map(std::string const &map_file, std::string &s,
+        std::string &dir, bool &found) const;
+#endif
 
 private:
     include_list_type user_include_paths;
     include_list_type system_include_paths;
     bool was_sys_include_path;          // saw a set_sys_include_delimiter()
+    boost::filesystem::path base_dir;
     boost::filesystem::path current_dir;
     boost::filesystem::path current_rel_dir;
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    mutable include_lookup_cache lookup_cache;
+    include_database *database;
+    mutable bool database_selected;     // the configuration is up to date
+    // the directories the current search depends on (while a database or
+    // shared resources are attached)
+    mutable std::vector<std::string> *dependencies;
+    boost::wave::shared_resources *resources;
+    mutable std::string configuration;  // see get_configuration()
+
+    std::string const &get_configuration() const;
+    void record_dependency(boost::filesystem::path const &p) const
+    {
+        namespace fs = boost::filesystem;
+
+        // the lookup depends on the contents of the innermost existing
+        // directory containing the candidate file
+        boost::system::error_code ec;
+        fs::path dir (p.parent_path());
+        while (!dir.empty() && !fs::is_directory(dir, ec))
+            dir = dir.parent_path();
+        if (!dir.empty())
+            dependencies->push_back(dir.string());
+    }
+#endif
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+    mutable directory_snapshots snapshots;
+#endif
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+    // the loaded header maps, indexed by the (complete) name of their file,
+    // which is what appears in the search lists
+    typedef std::map<std::string, boost::shared_ptr<header_map> >
+        header_map_type;
+    header_map_type header_maps;
+#endif
 
     bool may_be_includable(const boost::filesystem::path& p) const
     {
@@ -196,22 +314,68 @@ private:
         }
     }
 
+    // 'p' is the file 'name' inside the directory 'dir' (which is empty, if
+    // 'name' is an absolute path)
+    bool is_includable(const boost::filesystem::path& dir,
+        std::string const& name, const boost::filesystem::path& p) const
+    {
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        if (0 != dependencies)
+            record_dependency(p);
+#endif
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+        if (snapshots.is_enabled() && !dir.empty()) {
+            switch (snapshots.lookup(dir, name)) {
+            case directory_snapshots::file_absent:  return false;
+            case directory_snapshots::file_present: return true;
+            default:                                break;
+            }
+        }
+#endif
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        if (lookup_cache.is_enabled()) {
+            std::string candidate(p.string());
+            bool includable = false;
+            if (!lookup_cache.find_probe(candidate, includable)) {
+                if (0 == resources ||
+                    !resources->find_probe(candidate, includable))
+                {
+                    includable = may_be_includable(p);
+                    if (0 != resources)
+                        resources->insert_probe(candidate, includable);
+                }
+                lookup_cache.insert_probe(candidate, includable);
+            }
+            return includable;
+        }
+#endif
+        return may_be_includable(p);
+    }
+
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
 public:
-    bool has_pragma_once(std::string const &filename)
+    // The files are identified by their device and inode numbers, so a file
+    // reached through a different path (f.e. a symbolic link) is recognized
+    // as well. The identities are remembered for every path, so the file
+    // system is queried once per path only.
+    bool has_pragma_once(std::string const &filename) const
     {
+        if (pragma_once_files.empty())
+            return false;       // nothing to find, don't query the file system
+
         using boost::multi_index::get;
-        return get<from>(pragma_once_files).find(filename) != pragma_once_files.end();
+        return get<from>(pragma_once_files).find(get_identity(filename)) !=
+            pragma_once_files.end();
     }
     bool add_pragma_once_header(std::string const &filename,
         std::string const& guard_name)
     {
-        typedef pragma_once_set_type::value_type value_type;
-        return pragma_once_files.insert(value_type(filename, guard_name)).second;
+        return pragma_once_files.insert(include_once_entry(
+            get_identity(filename), filename, guard_name)).second;
     }
     bool remove_pragma_once_header(std::string const& guard_name)
     {
-        typedef pragma_once_set_type::index_iterator<to>::type to_iterator;
+        typedef include_once_set_type::index_iterator<to>::type to_iterator;
         typedef std::pair<to_iterator, to_iterator> range_type;
 
         range_type r = pragma_once_files.get<to>().equal_range(guard_name);
@@ -224,12 +388,25 @@ public:
     }
 
 private:
-    pragma_once_set_type pragma_once_files;
+    file_identity const &get_identity(std::string const &filename) const
+    {
+        typedef boost::unordered_map<std::string, file_identity>::iterator
+            iterator;
+        iterator it = identities.find(filename);
+        if (it == identities.end()) {
+            it = identities.insert(std::make_pair(filename,
+                get_file_identity(filename))).first;
+        }
+        return (*it).second;
+    }
+
+    include_once_set_type pragma_once_files;
+    mutable boost::unordered_map<std::string, file_identity> identities;
 #endif
 
 #if BOOST_WAVE_SERIALIZATION != 0
 public:
-    BOOST_STATIC_CONSTANT(unsigned int, version = 0x10);
+    BOOST_STATIC_CONSTANT(unsigned int, version = 0x20);
     BOOST_STATIC_CONSTANT(unsigned int, version_mask = 0x0f);
 
 private:
@@ -239,7 +416,16 @@ private:
     {
         using namespace boost::serialization;
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
-        ar & make_nvp("pragma_once_files", pragma_once_files);
+        // the file identities are valid for the current process only, so
+        // the file names are saved instead
+        std::list<std::pair<std::string, std::string> > once_files;
+        include_once_set_type::const_iterator end = pragma_once_files.end();
+        for (include_once_set_type::const_iterator it = pragma_once_files.begin();
+             it != end; ++it)
+        {
+            once_files.push_back(std::make_pair((*it).filename, (*it).guard_name));
+        }
+        ar & make_nvp("pragma_once_files", once_files);
 #endif
         ar & make_nvp("user_include_paths", user_include_paths);
         ar & make_nvp("system_include_paths", system_include_paths);
@@ -256,7 +442,16 @@ private:
         }
 
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
-        ar & make_nvp("pragma_once_files", pragma_once_files);
+        std::list<std::pair<std::string, std::string> > once_files;
+        ar & make_nvp("pragma_once_files", once_files);
+
+        std::list<std::pair<std::string, std::string> >::const_iterator end =
+            once_files.end();
+        for (std::list<std::pair<std::string, std::string> >::const_iterator it =
+                once_files.begin(); it != end; ++it)
+        {
+            add_pragma_once_header((*it).first, (*it).second);
+        }
 #endif
         // verify that the old include paths match the current ones
         include_list_type user_paths, system_paths;
@@ -300,11 +495,80 @@ bool include_paths::add_include_path (
         }
 
         pathes_.push_back (include_value_type(newpath, path_));
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        lookup_cache.clear_resolutions();
+        database_selected = false;
+        configuration.clear();
+#endif
+        return true;
+    }
+    return false;
+}
+
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+///////////////////////////////////////////////////////////////////////////////
+//  Add a header map to one of the search lists (user include path or system
+//  include path).
+inline
+bool include_paths::add_header_map (
+    char const *file_, include_list_type &pathes_)
+{
+    namespace fs = boost::filesystem;
+    if (file_) {
+        fs::path newpath = util::complete_path(create_path(file_), current_dir);
+
+        boost::shared_ptr<header_map> map(new header_map);
+        if (!map->load(newpath.string())) {
+            // the given file is not a valid header map
+            return false;
+        }
+
+        header_maps[newpath.string()] = map;
+        pathes_.push_back (include_value_type(newpath, file_));
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        lookup_cache.clear_resolutions();
+        database_selected = false;
+        configuration.clear();
+#endif
         return true;
     }
     return false;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//  Look up an include file in a header map, returns false if the given search
+//  list entry isn't a header map.
+inline
+bool include_paths::find_in_header_map (std::string const &map_file,
+    std::string &s, std::string &dir, bool &found) const
+{
+    namespace fs = boost::filesystem;
+
+    header_map_type::const_iterator map = header_maps.find(map_file);
+    if (map == header_maps.end())
+        return false;
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    if (0 != dependencies)
+        dependencies->push_back(map_file);      // the map itself may change
+#endif
+
+    // a file listed in the map, which doesn't exist anymore, is searched for
+    // in the remaining entries of the search list
+    std::string mapped;
+    found = false;
+    if ((*map).second->find(s, mapped)) {
+        fs::path mappedpath (create_path(mapped));
+        if (is_includable(fs::path(), mapped, mappedpath)) {
+            dir = mapped;
+            s = normalize(mappedpath).string();
+            found = true;
+        }
+    }
+    return true;
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Find an include file by traversing the list of include directories
 inline
@@ -328,7 +592,27 @@ bool include_paths::find_include_file (std::string &s, std::string &dir,
         // file was found.
 
         fs::path file_path (create_path(current_file));
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+        fs::path mapped_path (create_path(current_file));
+        mapped_path = normalize(mapped_path);
+#endif
         for (/**/; it != include_paths_end; ++it) {
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+            // a file found through a header map may live anywhere
+            header_map_type::const_iterator map =
+                header_maps.find((*it).first.string());
+            if (map != header_maps.end()) {
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+                if (0 != dependencies)
+                    dependencies->push_back((*map).first);
+#endif
+                if ((*map).second->maps_to(mapped_path)) {
+                    ++it;     // start searching with the next entry
+                    break;
+                }
+                continue;
+            }
+#endif
             fs::path currpath (create_path((*it).first.string()));
             if (std::equal(currpath.begin(), currpath.end(), file_path.begin()))
             {
@@ -340,13 +624,26 @@ bool include_paths::find_include_file (std::string &s, std::string &dir,
 #endif
 
     for (/**/; it != include_paths_end; ++it) {
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+        bool found = false;
+        if (!header_maps.empty() &&
+            find_in_header_map((*it).first.string(), s, dir, found))
+        {
+            if (found)
+                return true;
+            continue;
+        }
+#endif
+
         fs::path currpath (create_path(s));
+        fs::path searchdir;
         if (!currpath.has_root_directory()) {
-            currpath = create_path((*it).first.string());
+            searchdir = create_path((*it).first.string());
+            currpath = searchdir;
             currpath /= create_path(s);      // append filename
         }
 
-        if (may_be_includable(currpath)) {
+        if (is_includable(searchdir, s, currpath)) {
             fs::path dirpath (create_path(s));
             if (!dirpath.has_root_directory()) {
                 dirpath = create_path((*it).second);
@@ -361,12 +658,126 @@ bool include_paths::find_include_file (std::string &s, std::string &dir,
     return false;
 }
 
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+///////////////////////////////////////////////////////////////////////////////
+//  Describe the search lists, lookups stored in a database or shared with
+//  other include_paths objects are valid for identical search lists only (the
+//  directories are compared as given as well, as these are part of the
+//  results)
+inline std::string const &
+include_paths::get_configuration() const
+{
+    if (!configuration.empty())
+        return configuration;
+
+    std::string config(was_sys_include_path ? "-I-" : "");
+    include_list_type::const_iterator end = user_include_paths.end();
+    for (include_list_type::const_iterator it = user_include_paths.begin();
+         it != end; ++it)
+    {
+        config += '\0';
+        config += (*it).first.string();
+        config += '\0';
+        config += (*it).second;
+    }
+    config += '\1';
+    end = system_include_paths.end();
+    for (include_list_type::const_iterator it = system_include_paths.begin();
+         it != end; ++it)
+    {
+        config += '\0';
+        config += (*it).first.string();
+        config += '\0';
+        config += (*it).second;
+    }
+    configuration.swap(config);
+    return configuration;
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Find an include file by searching the user and system includes in the
-//  correct sequence (as it was configured by the user of the driver program)
+//  correct sequence (as it was configured by the user of the driver program),
+//  answer repeated lookups from the cache
 inline bool
 include_paths::find_include_file (std::string &s, std::string &dir,
     bool is_system, char const *current_file) const
+{
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    if (lookup_cache.is_enabled()) {
+        // the directory of the including file is searched for "file" only
+        // (and never for #include_next)
+        std::string includer_dir;
+        if (!is_system && !was_sys_include_path && 0 == current_file) {
+            includer_dir = current_dir.string();
+            includer_dir += '\0';
+            includer_dir += current_rel_dir.string();
+        }
+
+        std::string key;
+        include_lookup_cache::make_key(s, is_system, includer_dir,
+            current_file, key);
+
+        if (0 != database && !database_selected) {
+            database->select_configuration(
+                include_database::hash(get_configuration()));
+            database_selected = true;
+        }
+
+        include_lookup_cache::resolution result;
+        if (!lookup_cache.find(key, result)) {
+            if (0 == resources ||
+                !resources->find_resolution(get_configuration(), key, result))
+            {
+                if (0 == database || !database->find(key, result)) {
+                    // remember the searched directories for the database and
+                    // the shared resources
+                    std::vector<std::string> searched;
+                    dependencies = (0 != database || 0 != resources) ?
+                        &searched : 0;
+
+                    std::string file(s);
+                    bool found = false;
+                    try {
+                        found = search_include_file(file, result.dir,
+                            is_system, current_file);
+                    }
+                    catch (...) {
+                        dependencies = 0;
+                        throw;
+                    }
+                    dependencies = 0;
+
+                    if (found) {
+                        result.found = true;
+                        result.file = file;
+                    }
+                    if (0 != database)
+                        database->insert(key, result, searched);
+                    if (0 != resources) {
+                        resources->insert_resolution(get_configuration(), key,
+                            result, searched);
+                    }
+                }
+            }
+            lookup_cache.insert(key, result);
+        }
+
+        if (result.found) {
+            s = result.file;
+            dir = result.dir;
+        }
+        return result.found;
+    }
+#endif
+    return search_include_file(s, dir, is_system, current_file);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  Search the user and system include directories for the given file
+inline bool
+include_paths::search_include_file (std::string &s, std::string &dir,
+    bool is_system, char const *current_file) const
 {
     namespace fs = boost::filesystem;
 
@@ -375,12 +786,14 @@ include_paths::find_include_file (std::string &s, std::string &dir,
         if (!was_sys_include_path) { // set_sys_include_delimiter() not called
                                      // first have a look at the current directory
             fs::path currpath(create_path(s));
+            fs::path searchdir;
             if (!currpath.has_root_directory()) {
-                currpath = create_path(current_dir.string());
+                searchdir = create_path(current_dir.string());
+                currpath = searchdir;
                 currpath /= create_path(s);
             }
 
-            if (0 == current_file && may_be_includable(currpath)) {
+            if (0 == current_file && is_includable(searchdir, s, currpath)) {
                 // if 0 != current_path (#include_next handling) it can't be
                 // the file in the current directory
                 fs::path dirpath(create_path(s));
@@ -506,50 +919,6 @@ inline void serialize (Archive & ar, boost::filesystem::path &p,
     boost::serialization::split_free(ar, p, file_version);
 }
 
-///////////////////////////////////////////////////////////////////////////////
-//  Serialization support for the used multi_index
-template<class Archive>
-inline void save (Archive & ar,
-    const typename boost::wave::util::bidirectional_map<
-        std::string, std::string
-    >::type &t,
-    const unsigned int /* file_version */)
-{
-    boost::serialization::stl::save_collection<
-        Archive,
-        typename boost::wave::util::bidirectional_map<
-            std::string, std::string
-        >::type
-    >(ar, t);
-}
-
-template<class Archive>
-inline void load (Archive & ar,
-    typename boost::wave::util::bidirectional_map<std::string, std::string>::type &t,
-    const unsigned int /* file_version */)
-{
-    typedef typename boost::wave::util::bidirectional_map<
-            std::string, std::string
-        >::type map_type;
-    boost::serialization::stl::load_collection<
-        Archive, map_type,
-        boost::serialization::stl::archive_input_unique<Archive, map_type>,
-        boost::serialization::stl::no_reserve_imp<map_type>
-    >(ar, t);
-}
-
-// split non-intrusive serialization function member into separate
-// non intrusive save/load member functions
-template<class Archive>
-inline void serialize (Archive & ar,
-    typename boost::wave::util::bidirectional_map<
-        std::string, std::string
-    >::type &t,
-    const unsigned int file_version)
-{
-    boost::serialization::split_free(ar, t, file_version);
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 }}  // namespace boost::serialization
 
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <utility>
 #include <cstdlib>
 #include <cctype>
 
@@ -37,6 +38,10 @@
 #include <boost/wave/util/transform_iterator.hpp>
 #include <boost/wave/util/functor_input.hpp>
 #include <boost/wave/util/filesystem_compatibility.hpp>
+#include <boost/wave/util/cpp_directive_recognizer.hpp>
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+#include <boost/wave/util/cpp_expression_cache.hpp>
+#endif
 
 #include <boost/wave/grammars/cpp_grammar_gen.hpp>
 #include <boost/wave/grammars/cpp_expression_grammar_gen.hpp>
@@ -268,6 +273,11 @@ private:
     typedef typename parse_tree_match_type::parse_node_t parse_node_value_type; // node_val_data<>
     typedef typename parse_tree_match_type::container_t  parse_tree_type;       // parse_node_type::children_t
 
+    // the parts of a recognized pp directive
+    typedef boost::wave::util::directive_parts<
+            result_type, token_sequence_type
+        > directive_parts_type;
+
 public:
     template <typename IteratorT>
     pp_iterator_functor(ContextT &ctx_, IteratorT const &first_,
@@ -288,6 +298,15 @@ public:
         ctx_.set_current_filename(pos_.get_file().c_str());
 #endif
         iter_ctx->emitted_lines = (unsigned int)(-1);   // force #line directive
+
+        // the directives only mode starts with the macros defined on the
+        // command line
+        if (need_directives_only(ctx_.get_language()) &&
+            !need_scan_dependencies(ctx_.get_language()) &&
+            !ctx_.is_initialized())
+        {
+            queue_command_line_macros();
+        }
     }
 
     // get the next preprocessed token
@@ -315,44 +334,40 @@ protected:
     bool pp_directive();
     template <typename IteratorT>
     bool handle_pp_directive(IteratorT &it);
-    bool dispatch_directive(tree_parse_info_type const &hit,
-        result_type const& found_directive,
-        token_sequence_type const& found_eoltokens);
+    void pass_directive_through(lexer_type first);
+    void queue_command_line_macros();
+    bool parse_directive(lexer_type &it, directive_parts_type &parts);
+    bool dispatch_directive(directive_parts_type &parts);
     void replace_undefined_identifiers(token_sequence_type &expanded);
+    bool evaluate_expression(token_sequence_type const &expanded,
+        grammars::value_error &status);
+    bool reevaluate_expression(result_type const& found_directive,
+        token_sequence_type const &toexpand, bool if_status);
 
     void on_include(string_type const &s, bool is_system, bool include_next);
-    void on_include(typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end, bool include_next);
+    void on_include(token_sequence_type &toexpand, bool include_next);
 
-    void on_define(parse_node_type const &node);
+    void on_define(directive_parts_type &parts);
     void on_undefine(lexer_type const &it);
 
     void on_ifdef(result_type const& found_directive,
-        typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+        token_sequence_type &toexpand);
     void on_ifndef(result_type const& found_directive,
-        typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+        token_sequence_type &toexpand);
     void on_else();
     void on_endif();
     void on_illformed(typename result_type::string_type s);
 
-    void on_line(typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+    void on_line(token_sequence_type &toexpand);
     void on_if(result_type const& found_directive,
-        typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+        token_sequence_type &toexpand);
     void on_elif(result_type const& found_directive,
-        typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
-    void on_error(typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+        token_sequence_type &toexpand);
+    void on_error(token_sequence_type &toexpand);
 #if BOOST_WAVE_SUPPORT_WARNING_DIRECTIVE != 0
-    void on_warning(typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+    void on_warning(token_sequence_type &toexpand);
 #endif
-    bool on_pragma(typename parse_tree_type::const_iterator const &begin,
-        typename parse_tree_type::const_iterator const &end);
+    bool on_pragma(token_sequence_type &body);
 
     bool emit_line_directive();
     bool returned_from_include();
@@ -372,6 +387,7 @@ private:
 
     token_sequence_type unput_queue;     // tokens to be preprocessed again
     token_sequence_type pending_queue;   // tokens already preprocessed
+    token_sequence_type prologue;        // generated before the input
 
     // detect whether to insert additional whitespace in between two adjacent
     // tokens, which otherwise would form a different token type, if
@@ -488,6 +504,10 @@ pp_iterator_functor<ContextT>::operator()()
 {
     using namespace boost::wave;
 
+    // allocate all tokens from the memory owned by the context (if any)
+    typename ContextT::allocation_policy_type::scope arena_scope(
+        ctx.get_allocation_policy());
+
     // make sure the cwd has been initialized
     ctx.init_context();
 
@@ -590,7 +610,7 @@ pp_iterator_functor<ContextT>::operator()()
                 rescanned.push_back(*it);
 
             pending_queue.splice(pending_queue.begin(), rescanned);
-            act_token = pending_queue.front();
+            act_token = std::move(pending_queue.front());
             id = token_id(act_token);
             pending_queue.pop_front();
         }
@@ -626,6 +646,20 @@ pp_iterator_functor<ContextT>::get_next_token()
 {
     using namespace boost::wave;
 
+    // in dependency scanning mode only the directives are evaluated, all of
+    // the tokens generated otherwise (from a #pragma, etc.) are discarded
+    bool const scan_only = need_scan_dependencies(ctx.get_language());
+    if (scan_only)
+        pending_queue.clear();
+
+    // the input is preceded by the prologue, followed by a #line directive
+    if (!prologue.empty()) {
+        act_token = std::move(prologue.front());
+        prologue.pop_front();
+        must_emit_line_directive = prologue.empty();
+        return act_token;
+    }
+
     // if there is something in the unput_queue, then return the next token from
     // there (all tokens in the queue are preprocessed already)
     if (!pending_queue.empty() || !unput_queue.empty())
@@ -641,11 +675,13 @@ pp_iterator_functor<ContextT>::get_next_token()
             // If there are pending tokens in the queue, we'll have to return
             // these. This may happen from a #pragma directive, which got replaced
             // by some token sequence.
-            if (!pending_queue.empty()) {
+            if (scan_only)
+                pending_queue.clear();
+            else if (!pending_queue.empty()) {
                 util::on_exit::pop_front<token_sequence_type>
                     pop_front_token(pending_queue);
 
-                return act_token = pending_queue.front();
+                return act_token = std::move(pending_queue.front());
             }
 
             // adjust the current position (line and column)
@@ -695,6 +731,8 @@ pp_iterator_functor<ContextT>::get_next_token()
                     util::impl::call_skipped_token_hook(ctx, act_token);
                     continue;
                 }
+                if (scan_only)
+                    continue;
                 return act_token;
             }
             seen_newline = false;
@@ -715,6 +753,35 @@ pp_iterator_functor<ContextT>::get_next_token()
                 // correctly
             }
             else if (ctx.get_if_block_status()) {
+                if (scan_only) {
+                    // a #pragma to be emitted was consumed already, its
+                    // tokens are discarded
+                    if (!pending_queue.empty()) {
+                        pending_queue.clear();
+                        continue;
+                    }
+
+                    // skip the text in between the directives without
+                    // expanding any macros, a C comment spanning several lines
+                    // is a line end as well (see operator()())
+                    if (T_CCOMMENT == id && !need_preserve_comments(ctx.get_language()) &&
+                        context_policies::util::ccomment_has_newline(act_token))
+                    {
+                        seen_newline = true;
+                    }
+                    ++iter_ctx->first;
+                    continue;
+                }
+
+                // in directives only mode the text in between the directives
+                // is returned as is, without expanding any macros
+                if (need_directives_only(ctx.get_language()) &&
+                    pending_queue.empty())
+                {
+                    ++iter_ctx->first;
+                    return act_token;
+                }
+
                 // preprocess this token, eat up more, if appropriate, return
                 // the next preprocessed token
                 return pp_token();
@@ -829,7 +896,7 @@ pp_iterator_functor<ContextT>::emit_line_directive()
             // if there is some replacement text, insert it into the pending queue
             if (!pending.empty()) {
                 pending_queue.splice(pending_queue.begin(), pending);
-                act_token = pending_queue.front();
+                act_token = std::move(pending_queue.front());
                 pending_queue.pop_front();
             }
         }
@@ -860,7 +927,7 @@ pp_iterator_functor<ContextT>::pp_token()
     do {
         if (!pending_queue.empty()) {
             // if there are pending tokens in the queue, return the first one
-            act_token = pending_queue.front();
+            act_token = std::move(pending_queue.front());
             pending_queue.pop_front();
             act_pos = act_token.get_position();
         }
@@ -1001,11 +1068,10 @@ namespace impl {
     remove_leading_whitespace(ContextT &ctx, ContainerT& c, bool call_hook = true)
     {
         typename ContainerT::iterator it = c.begin();
-        while (IS_CATEGORY(*it, WhiteSpaceTokenType)) {
-            typename ContainerT::iterator save = it++;
+        while (it != c.end() && IS_CATEGORY(*it, WhiteSpaceTokenType)) {
             if (call_hook)
-                util::impl::call_skipped_token_hook(ctx, *save);
-            c.erase(save);
+                util::impl::call_skipped_token_hook(ctx, *it);
+            it = c.erase(it);
         }
     }
 }
@@ -1337,34 +1403,56 @@ pp_iterator_functor<ContextT>::pp_directive()
     if (it == iter_ctx->last)
         return false;
 
+    // in directives only mode the macro definitions are passed through, as
+    // the macros aren't expanded in the text
+    bool const pass_through = need_directives_only(ctx.get_language()) &&
+        ctx.get_if_block_status() &&
+        (T_PP_DEFINE == token_id(*it) || T_PP_UNDEF == token_id(*it));
+    lexer_type const directive_begin = it;
+
     // ignore/handle all pp directives not related to conditional compilation while
     // if block status is false
     if (handle_pp_directive(it)) {
         // we may skip pp directives only if the current if block status is
         // false or if it was a #include directive we could handle directly
+        if (pass_through)
+            pass_directive_through(directive_begin);
         return true;    //  the pp directive has been handled/skipped
     }
 
     // found a pp directive, so try to identify it, start with the pp_token
-    bool found_eof = false;
-    result_type found_directive;
-    token_sequence_type found_eoltokens;
+    directive_parts_type parts;
+    lexer_type stop = it;
 
-    tree_parse_info_type hit = cpp_grammar_type::parse_cpp_grammar(
-        it, iter_ctx->last, act_pos, found_eof, found_directive, found_eoltokens);
+#if BOOST_WAVE_DUMP_PARSE_TREE != 0
+    // use the cpp_grammar, which allows to dump the generated parse tree
+    bool matched = parse_directive(stop, parts);
+#else
+    bool matched = boost::wave::util::recognize_directive(stop, iter_ctx->last,
+        parts);
+    if (!matched) {
+        // leave anything else to the cpp_grammar, which classifies the ill
+        // formed directives
+        parts = directive_parts_type();
+        stop = it;
+        matched = parse_directive(stop, parts);
+    }
+#endif
 
-    if (hit.match) {
+    if (matched) {
         // position the iterator past the matched sequence to allow
         // resynchronization, if an error occurs
-        iter_ctx->first = hit.stop;
+        iter_ctx->first = stop;
         seen_newline = true;
         must_emit_line_directive = true;
 
         // found a valid pp directive, dispatch to the correct function to handle
         // the found pp directive
-        bool result = dispatch_directive(hit, found_directive, found_eoltokens);
+        bool result = dispatch_directive(parts);
+        if (pass_through)
+            pass_directive_through(directive_begin);
 
-        if (found_eof && !need_single_line(ctx.get_language()) &&
+        if (parts.found_eof && !need_single_line(ctx.get_language()) &&
             !need_no_newline_at_end_of_file(ctx.get_language()))
         {
             // The line was terminated with an end of file token.
@@ -1375,7 +1463,7 @@ pp_iterator_functor<ContextT>::pp_directive()
         }
         return result;
     }
-    else if (token_id(found_directive) != T_EOF) {
+    else if (token_id(parts.directive) != T_EOF) {
         // recognized invalid directive
         impl::skip_to_eol(ctx, it, iter_ctx->last);
         seen_newline = true;
@@ -1392,34 +1480,174 @@ pp_iterator_functor<ContextT>::pp_directive()
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-//  dispatch_directive(): dispatch a recognized preprocessor directive
+//  pass_directive_through(): return the tokens of the handled directive
+//      starting at the given position (a #define or #undef in directives
+//      only mode) as the next tokens
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename ContextT>
+inline void
+pp_iterator_functor<ContextT>::pass_directive_through(lexer_type first)
+{
+    token_sequence_type directive;
+    for (/**/; first != iter_ctx->first; ++first) {
+        if (T_EOF != token_id(*first))
+            directive.push_back(*first);
+    }
+    if (directive.empty())
+        return;
+
+    // make sure the directive ends with a newline
+    if (!IS_CATEGORY(token_id(directive.back()), EOLTokenType)) {
+        directive.push_back(result_type(T_NEWLINE, "\n",
+            directive.back().get_position()));
+    }
+
+    // a #line directive is needed only, if the output isn't in sync
+    must_emit_line_directive = iter_ctx->emitted_lines + 1 !=
+        directive.front().get_position().get_line();
+    pending_queue.splice(pending_queue.end(), directive);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  queue_command_line_macros(): generate the #undef and #define directives
+//      for the macros undefined and defined on the command line (before
+//      preprocessing started), which start the output of the directives
+//      only mode, as the compiler processing it doesn't know about these
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename ContextT>
+inline void
+pp_iterator_functor<ContextT>::queue_command_line_macros()
+{
+    typedef typename ContextT::string_type string_type;
+    typedef typename ContextT::const_name_iterator name_iterator;
+
+    position_type const pos("<command line>");
+    std::vector<string_type> const &undefined = ctx.get_undefined_macros();
+    for (std::size_t i = 0; i < undefined.size(); ++i) {
+        prologue.push_back(result_type(T_PP_UNDEF, "#undef", pos));
+        prologue.push_back(result_type(T_SPACE, " ", pos));
+        prologue.push_back(result_type(T_IDENTIFIER, undefined[i], pos));
+        prologue.push_back(result_type(T_NEWLINE, "\n", pos));
+    }
+
+    name_iterator end = ctx.macro_names_end();
+    for (name_iterator it = ctx.macro_names_begin(); it != end; ++it) {
+        bool has_parameters = false;
+        bool is_predefined = false;
+        position_type macro_pos;
+        std::vector<result_type> parameters;
+        token_sequence_type definition;
+
+        if (!ctx.get_macro_definition(*it, has_parameters, is_predefined,
+                macro_pos, parameters, definition) ||
+            macro_pos.get_file() != pos.get_file())
+        {
+            continue;
+        }
+
+        prologue.push_back(result_type(T_PP_DEFINE, "#define", pos));
+        prologue.push_back(result_type(T_SPACE, " ", pos));
+        prologue.push_back(result_type(T_IDENTIFIER, *it, pos));
+        if (has_parameters) {
+            prologue.push_back(result_type(T_LEFTPAREN, "(", pos));
+            for (std::size_t i = 0; i < parameters.size(); ++i) {
+                if (0 != i)
+                    prologue.push_back(result_type(T_COMMA, ",", pos));
+                prologue.push_back(parameters[i]);
+            }
+            prologue.push_back(result_type(T_RIGHTPAREN, ")", pos));
+        }
+        if (!definition.empty()) {
+            prologue.push_back(result_type(T_SPACE, " ", pos));
+            prologue.splice(prologue.end(), definition);
+        }
+        prologue.push_back(result_type(T_NEWLINE, "\n", pos));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  parse_directive(): recognize a preprocessor directive using the
+//      cpp_grammar and extract its parts from the generated parse tree
 //
 ///////////////////////////////////////////////////////////////////////////////
 template <typename ContextT>
 inline bool
-pp_iterator_functor<ContextT>::dispatch_directive(
-    tree_parse_info_type const &hit, result_type const& found_directive,
-    token_sequence_type const& found_eoltokens)
+pp_iterator_functor<ContextT>::parse_directive(lexer_type &it,
+    directive_parts_type &parts)
 {
     using namespace cpplexer;
 
     typedef typename parse_tree_type::const_iterator const_child_iterator_t;
 
+    tree_parse_info_type hit = cpp_grammar_type::parse_cpp_grammar(
+        it, iter_ctx->last, act_pos, parts.found_eof, parts.directive,
+        parts.eoltokens);
+
+    if (!hit.match)
+        return false;
+    it = hit.stop;
+
     // this iterator points to the root node of the parse tree
     const_child_iterator_t begin = hit.trees.begin();
 
-    // decide, which preprocessor directive was found
     parse_tree_type const& root = (*begin).children;
-    parse_node_value_type const& nodeval = get_first_leaf(*root.begin()).value;
-    //long node_id = nodeval.id().to_long();
-
     const_child_iterator_t begin_child_it = (*root.begin()).children.begin();
     const_child_iterator_t end_child_it = (*root.begin()).children.end();
 
-    token_id id = token_id(found_directive);
+    get_token_value<result_type, parse_node_type> get_value;
+
+    switch (token_id(parts.directive)) {
+    case T_PP_DEFINE:       // #define
+        {
+            position_type pos(act_token.get_position());
+
+            if (!boost::wave::util::retrieve_macroname(ctx, *begin,
+                    BOOST_WAVE_PLAIN_DEFINE_ID, parts.macroname, pos, false))
+                return false;
+            parts.has_parameters = boost::wave::util::retrieve_macrodefinition(
+                *begin, BOOST_WAVE_MACRO_PARAMETERS_ID, parts.parameters, pos,
+                false);
+            boost::wave::util::retrieve_macrodefinition(*begin,
+                BOOST_WAVE_MACRO_DEFINITION_ID, parts.body, pos, false);
+        }
+        break;
+
+    case T_PP_IFDEF:        // #ifdef
+    case T_PP_IFNDEF:       // #ifndef
+        std::copy(
+            make_ref_transform_iterator((*begin_child_it).children.begin(), get_value),
+            make_ref_transform_iterator((*begin_child_it).children.end(), get_value),
+            std::inserter(parts.body, parts.body.end()));
+        break;
+
+    default:
+        std::copy(make_ref_transform_iterator(begin_child_it, get_value),
+            make_ref_transform_iterator(end_child_it, get_value),
+            std::inserter(parts.body, parts.body.end()));
+        break;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  dispatch_directive(): dispatch a recognized preprocessor directive
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename ContextT>
+inline bool
+pp_iterator_functor<ContextT>::dispatch_directive(directive_parts_type &parts)
+{
+    using namespace cpplexer;
+
+    token_id id = token_id(parts.directive);
 
     // call preprocessing hook
-    if (impl::call_found_directive_hook(ctx, found_directive))
+    if (impl::call_found_directive_hook(ctx, parts.directive))
         return true;    // skip this directive and return newline only
 
     switch (id) {
@@ -1443,11 +1671,11 @@ pp_iterator_functor<ContextT>::dispatch_directive(
 #if BOOST_WAVE_SUPPORT_INCLUDE_NEXT != 0
     case T_PP_INCLUDE_NEXT: // #include_next ...
 #endif
-        on_include (begin_child_it, end_child_it, T_PP_INCLUDE_NEXT == id);
+        on_include (parts.body, T_PP_INCLUDE_NEXT == id);
         break;
 
     case T_PP_DEFINE:       // #define
-        on_define (*begin);
+        on_define (parts);
         break;
 
 //     case T_PP_UNDEF:        // #undef
@@ -1455,19 +1683,19 @@ pp_iterator_functor<ContextT>::dispatch_directive(
 //         break;
 //
     case T_PP_IFDEF:        // #ifdef
-        on_ifdef(found_directive, begin_child_it, end_child_it);
+        on_ifdef(parts.directive, parts.body);
         break;
 
     case T_PP_IFNDEF:       // #ifndef
-        on_ifndef(found_directive, begin_child_it, end_child_it);
+        on_ifndef(parts.directive, parts.body);
         break;
 
     case T_PP_IF:           // #if
-        on_if(found_directive, begin_child_it, end_child_it);
+        on_if(parts.directive, parts.body);
         break;
 
     case T_PP_ELIF:         // #elif
-        on_elif(found_directive, begin_child_it, end_child_it);
+        on_elif(parts.directive, parts.body);
         break;
 
 //     case T_PP_ELSE:         // #else
@@ -1479,21 +1707,21 @@ pp_iterator_functor<ContextT>::dispatch_directive(
 //         break;
 
     case T_PP_LINE:         // #line
-        on_line(begin_child_it, end_child_it);
+        on_line(parts.body);
         break;
 
     case T_PP_ERROR:        // #error
-        on_error(begin_child_it, end_child_it);
+        on_error(parts.body);
         break;
 
 #if BOOST_WAVE_SUPPORT_WARNING_DIRECTIVE != 0
     case T_PP_WARNING:      // #warning
-        on_warning(begin_child_it, end_child_it);
+        on_warning(parts.body);
         break;
 #endif
 
     case T_PP_PRAGMA:       // #pragma
-        return on_pragma(begin_child_it, end_child_it);
+        return on_pragma(parts.body);
 
 #if BOOST_WAVE_SUPPORT_MS_EXTENSIONS != 0
     case T_MSEXT_PP_REGION:
@@ -1502,25 +1730,19 @@ pp_iterator_functor<ContextT>::dispatch_directive(
 #endif
 
     default:                // #something else
-        on_illformed((*nodeval.begin()).get_value());
+        // reported by its first token, like the cpp_grammar did
+        on_illformed((parts.body.empty() ?
+            parts.directive : parts.body.front()).get_value());
 
         // if we end up here, we have been instructed to ignore the error, so
         // we simply copy the whole construct to the output
-        {
-            token_sequence_type expanded;
-            get_token_value<result_type, parse_node_type> get_value;
-
-            std::copy(make_ref_transform_iterator(begin_child_it, get_value),
-                make_ref_transform_iterator(end_child_it, get_value),
-                std::inserter(expanded, expanded.end()));
-            pending_queue.splice(pending_queue.begin(), expanded);
-        }
+        pending_queue.splice(pending_queue.begin(), parts.body);
         break;
     }
 
     // properly skip trailing newline for all directives
-    typename token_sequence_type::const_iterator eol = found_eoltokens.begin();
-    impl::skip_to_eol(ctx, eol, found_eoltokens.end());
+    typename token_sequence_type::iterator eol = parts.eoltokens.begin();
+    impl::skip_to_eol(ctx, eol, parts.eoltokens.end());
     return true;    // return newline only
 }
 
@@ -1650,21 +1872,13 @@ pp_iterator_functor<ContextT>::on_include_helper(char const* f, char const* s,
 
 template <typename ContextT>
 inline void
-pp_iterator_functor<ContextT>::on_include(
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end, bool include_next)
+pp_iterator_functor<ContextT>::on_include(token_sequence_type &toexpand,
+    bool include_next)
 {
     BOOST_ASSERT(ctx.get_if_block_status());
 
     // preprocess the given token sequence (the body of the #include directive)
-    get_token_value<result_type, parse_node_type> get_value;
     token_sequence_type expanded;
-    token_sequence_type toexpand;
-
-    std::copy(make_ref_transform_iterator(begin, get_value),
-        make_ref_transform_iterator(end, get_value),
-        std::inserter(toexpand, toexpand.end()));
-
     typename token_sequence_type::iterator begin2 = toexpand.begin();
     // expanding the computed include
     ctx.expand_whole_tokensequence(begin2, toexpand.end(), expanded,
@@ -1692,24 +1906,15 @@ pp_iterator_functor<ContextT>::on_include(
 
 template <typename ContextT>
 inline void
-pp_iterator_functor<ContextT>::on_define (parse_node_type const &node)
+pp_iterator_functor<ContextT>::on_define (directive_parts_type &parts)
 {
     BOOST_ASSERT(ctx.get_if_block_status());
 
-    // retrieve the macro definition from the parse tree
-    result_type macroname;
-    std::vector<result_type> macroparameters;
-    token_sequence_type macrodefinition;
-    bool has_parameters = false;
-    position_type pos(act_token.get_position());
-
-    if (!boost::wave::util::retrieve_macroname(ctx, node,
-            BOOST_WAVE_PLAIN_DEFINE_ID, macroname, pos, false))
-        return;
-    has_parameters = boost::wave::util::retrieve_macrodefinition(node,
-        BOOST_WAVE_MACRO_PARAMETERS_ID, macroparameters, pos, false);
-    boost::wave::util::retrieve_macrodefinition(node,
-        BOOST_WAVE_MACRO_DEFINITION_ID, macrodefinition, pos, false);
+    // the macro definition as extracted from the directive
+    result_type const& macroname = parts.macroname;
+    std::vector<result_type>& macroparameters = parts.parameters;
+    token_sequence_type& macrodefinition = parts.body;
+    bool has_parameters = parts.has_parameters;
 
     if (has_parameters) {
 #if BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
@@ -1849,17 +2054,8 @@ pp_iterator_functor<ContextT>::on_undefine (lexer_type const &it)
 template <typename ContextT>
 inline void
 pp_iterator_functor<ContextT>::on_ifdef(
-    result_type const& found_directive,
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+    result_type const& found_directive, token_sequence_type &toexpand)
 {
-    get_token_value<result_type, parse_node_type> get_value;
-    token_sequence_type toexpand;
-
-    std::copy(make_ref_transform_iterator((*begin).children.begin(), get_value),
-              make_ref_transform_iterator((*begin).children.end(), get_value),
-              std::inserter(toexpand, toexpand.end()));
-
     bool is_defined = false;
 
     do {
@@ -1877,17 +2073,8 @@ pp_iterator_functor<ContextT>::on_ifdef(
 template <typename ContextT>
 inline void
 pp_iterator_functor<ContextT>::on_ifndef(
-    result_type const& found_directive,
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+    result_type const& found_directive, token_sequence_type &toexpand)
 {
-    get_token_value<result_type, parse_node_type> get_value;
-    token_sequence_type toexpand;
-
-    std::copy(make_ref_transform_iterator((*begin).children.begin(), get_value),
-              make_ref_transform_iterator((*begin).children.end(), get_value),
-              std::inserter(toexpand, toexpand.end()));
-
     bool is_defined = false;
 
     do {
@@ -1952,6 +2139,67 @@ pp_iterator_functor<ContextT>::replace_undefined_identifiers(
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//  evaluate the (fully expanded) expression of a #if/#elif directive, the
+//  results of the expressions evaluating without errors are cached
+template <typename ContextT>
+inline bool
+pp_iterator_functor<ContextT>::evaluate_expression(
+    token_sequence_type const &expanded, grammars::value_error &status)
+{
+    typedef grammars::expression_grammar_gen<result_type> evaluator_type;
+
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+    util::conditional_expression_cache &cache =
+        ctx.get_conditional_expression_cache();
+
+    if (cache.is_enabled()) {
+        std::string key;
+        bool result = false;
+
+        util::conditional_expression_cache::make_key(expanded,
+            ctx.get_if_block_status(), key);
+        if (cache.find(key, result))
+            return result;
+
+        // errors are not cached, they have to be reported every time
+        grammars::value_error error = grammars::error_noerror;
+        result = evaluator_type::evaluate(expanded.begin(), expanded.end(),
+            act_pos, ctx.get_if_block_status(), error);
+        if (grammars::error_noerror == error)
+            cache.insert(key, result);
+        else
+            status = error;
+        return result;
+    }
+#endif
+    return evaluator_type::evaluate(expanded.begin(), expanded.end(), act_pos,
+        ctx.get_if_block_status(), status);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//  call the evaluated_conditional_expression() hook, returns whether the
+//  expression has to be evaluated again
+template <typename ContextT>
+inline bool
+pp_iterator_functor<ContextT>::reevaluate_expression(
+    result_type const& found_directive, token_sequence_type const &toexpand,
+    bool if_status)
+{
+    if (!ctx.get_hooks().evaluated_conditional_expression(ctx.derived(),
+            found_directive, toexpand, if_status))
+    {
+        return false;
+    }
+
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+    // the hook relies on the expressions being evaluated, so don't answer
+    // any of them from the cache anymore
+    ctx.get_conditional_expression_cache().enable(false);
+#endif
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  on_if(): handle #if directives
@@ -1960,18 +2208,8 @@ pp_iterator_functor<ContextT>::replace_undefined_identifiers(
 template <typename ContextT>
 inline void
 pp_iterator_functor<ContextT>::on_if(
-    result_type const& found_directive,
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+    result_type const& found_directive, token_sequence_type &toexpand)
 {
-    // preprocess the given sequence into the provided list
-    get_token_value<result_type, parse_node_type> get_value;
-    token_sequence_type toexpand;
-
-    std::copy(make_ref_transform_iterator(begin, get_value),
-        make_ref_transform_iterator(end, get_value),
-        std::inserter(toexpand, toexpand.end()));
-
     impl::remove_leading_whitespace(ctx, toexpand);
 
     bool if_status = false;
@@ -1997,9 +2235,7 @@ pp_iterator_functor<ContextT>::on_if(
 #endif
         try {
             // parse the expression and enter the #if block
-            if_status = grammars::expression_grammar_gen<result_type>::
-                    evaluate(expanded.begin(), expanded.end(), act_pos,
-                        ctx.get_if_block_status(), status);
+            if_status = evaluate_expression(expanded, status);
         }
         catch (boost::wave::preprocess_exception const& e) {
             // any errors occurred have to be dispatched to the context hooks
@@ -2007,8 +2243,7 @@ pp_iterator_functor<ContextT>::on_if(
             break;
         }
 
-    } while (ctx.get_hooks().evaluated_conditional_expression(ctx.derived(),
-                found_directive, toexpand, if_status)
+    } while (reevaluate_expression(found_directive, toexpand, if_status)
              && status == grammars::error_noerror);
 
     ctx.enter_if_block(if_status);
@@ -2041,18 +2276,8 @@ pp_iterator_functor<ContextT>::on_if(
 template <typename ContextT>
 inline void
 pp_iterator_functor<ContextT>::on_elif(
-    result_type const& found_directive,
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+    result_type const& found_directive, token_sequence_type &toexpand)
 {
-    // preprocess the given sequence into the provided list
-    get_token_value<result_type, parse_node_type> get_value;
-    token_sequence_type toexpand;
-
-    std::copy(make_ref_transform_iterator(begin, get_value),
-        make_ref_transform_iterator(end, get_value),
-        std::inserter(toexpand, toexpand.end()));
-
     impl::remove_leading_whitespace(ctx, toexpand);
 
     // check current if block status
@@ -2095,17 +2320,14 @@ pp_iterator_functor<ContextT>::on_elif(
 
         try {
             // parse the expression and enter the #elif block
-            if_status = grammars::expression_grammar_gen<result_type>::
-                evaluate(expanded.begin(), expanded.end(), act_pos,
-                    ctx.get_if_block_status(), status);
+            if_status = evaluate_expression(expanded, status);
         }
         catch (boost::wave::preprocess_exception const& e) {
             // any errors occurred have to be dispatched to the context hooks
             ctx.get_hooks().throw_exception(ctx.derived(), e);
         }
 
-    } while (ctx.get_hooks().evaluated_conditional_expression(ctx.derived(),
-                found_directive, toexpand, if_status)
+    } while (reevaluate_expression(found_directive, toexpand, if_status)
              && status == grammars::error_noerror);
 
     if (!ctx.enter_elif_block(if_status)) {
@@ -2217,9 +2439,7 @@ namespace impl {
 
 template <typename ContextT>
 inline void
-pp_iterator_functor<ContextT>::on_line(
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+pp_iterator_functor<ContextT>::on_line(token_sequence_type &toexpand)
 {
     BOOST_ASSERT(ctx.get_if_block_status());
 
@@ -2227,25 +2447,16 @@ pp_iterator_functor<ContextT>::on_line(
     // directly. If that fails, preprocess the whole token sequence and try again
     // to extract this information.
     token_sequence_type expanded;
-    get_token_value<result_type, parse_node_type> get_value;
-
-    typedef typename ref_transform_iterator_generator<
-            get_token_value<result_type, parse_node_type>,
-            typename parse_tree_type::const_iterator
-        >::type const_tree_iterator_t;
-
-    const_tree_iterator_t first = make_ref_transform_iterator(begin, get_value);
-    const_tree_iterator_t last = make_ref_transform_iterator(end, get_value);
 
     // try to interpret the #line body as a number followed by an optional
     // string literal
     unsigned int line = 0;
     preprocess_exception::error_code error = preprocess_exception::no_error;
     string_type file_name;
-    token_sequence_type toexpand;
 
-    std::copy(first, last, std::inserter(toexpand, toexpand.end()));
-    if (!impl::retrieve_line_info(first, last, line, file_name, error)) {
+    if (!impl::retrieve_line_info(toexpand.begin(), toexpand.end(), line,
+            file_name, error))
+    {
         // preprocess the body of this #line message
         typename token_sequence_type::iterator begin2 = toexpand.begin();
         ctx.expand_whole_tokensequence(begin2, toexpand.end(),
@@ -2307,27 +2518,13 @@ pp_iterator_functor<ContextT>::on_line(
 ///////////////////////////////////////////////////////////////////////////////
 template <typename ContextT>
 inline void
-pp_iterator_functor<ContextT>::on_error(
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+pp_iterator_functor<ContextT>::on_error(token_sequence_type &toexpand)
 {
     BOOST_ASSERT(ctx.get_if_block_status());
 
-    // preprocess the given sequence into the provided list
-    token_sequence_type expanded;
-    get_token_value<result_type, parse_node_type> get_value;
-
-    typename ref_transform_iterator_generator<
-        get_token_value<result_type, parse_node_type>,
-        typename parse_tree_type::const_iterator
-    >::type first = make_ref_transform_iterator(begin, get_value);
-
 #if BOOST_WAVE_PREPROCESS_ERROR_MESSAGE_BODY != 0
     // preprocess the body of this #error message
-    token_sequence_type toexpand;
-
-    std::copy(first, make_ref_transform_iterator(end, get_value),
-        std::inserter(toexpand, toexpand.end()));
+    token_sequence_type expanded;
 
     typename token_sequence_type::iterator begin2 = toexpand.begin();
     ctx.expand_whole_tokensequence(begin2, toexpand.end(), expanded,
@@ -2336,8 +2533,8 @@ pp_iterator_functor<ContextT>::on_error(
 #else
     // simply copy the body of this #error message to the issued diagnostic
     // message
-    std::copy(first, make_ref_transform_iterator(end, get_value),
-        std::inserter(expanded, expanded.end()));
+    token_sequence_type& expanded = toexpand;
+
     if (!ctx.get_hooks().found_error_directive(ctx.derived(), expanded))
 #endif
     {
@@ -2356,27 +2553,13 @@ pp_iterator_functor<ContextT>::on_error(
 ///////////////////////////////////////////////////////////////////////////////
 template <typename ContextT>
 inline void
-pp_iterator_functor<ContextT>::on_warning(
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+pp_iterator_functor<ContextT>::on_warning(token_sequence_type &toexpand)
 {
     BOOST_ASSERT(ctx.get_if_block_status());
 
-    // preprocess the given sequence into the provided list
-    token_sequence_type expanded;
-    get_token_value<result_type, parse_node_type> get_value;
-
-    typename ref_transform_iterator_generator<
-        get_token_value<result_type, parse_node_type>,
-        typename parse_tree_type::const_iterator
-    >::type first = make_ref_transform_iterator(begin, get_value);
-
 #if BOOST_WAVE_PREPROCESS_ERROR_MESSAGE_BODY != 0
     // preprocess the body of this #warning message
-    token_sequence_type toexpand;
-
-    std::copy(first, make_ref_transform_iterator(end, get_value),
-        std::inserter(toexpand, toexpand.end()));
+    token_sequence_type expanded;
 
     typename token_sequence_type::iterator begin2 = toexpand.begin();
     ctx.expand_whole_tokensequence(begin2, toexpand.end(), expanded,
@@ -2385,8 +2568,8 @@ pp_iterator_functor<ContextT>::on_warning(
 #else
     // simply copy the body of this #warning message to the issued diagnostic
     // message
-    std::copy(first, make_ref_transform_iterator(end, get_value),
-        std::inserter(expanded, expanded.end()));
+    token_sequence_type& expanded = toexpand;
+
     if (!ctx.get_hooks().found_warning_directive(ctx.derived(), expanded))
 #endif
     {
@@ -2405,9 +2588,7 @@ pp_iterator_functor<ContextT>::on_warning(
 ///////////////////////////////////////////////////////////////////////////////
 template <typename ContextT>
 inline bool
-pp_iterator_functor<ContextT>::on_pragma(
-    typename parse_tree_type::const_iterator const &begin,
-    typename parse_tree_type::const_iterator const &end)
+pp_iterator_functor<ContextT>::on_pragma(token_sequence_type &body)
 {
     using namespace boost::wave;
 
@@ -2417,15 +2598,9 @@ pp_iterator_functor<ContextT>::on_pragma(
     // (see C99 standard [6.10.6.2]), if it is, the sequence must _not_ be
     // preprocessed.
     token_sequence_type expanded;
-    get_token_value<result_type, parse_node_type> get_value;
-
-    typedef typename ref_transform_iterator_generator<
-            get_token_value<result_type, parse_node_type>,
-            typename parse_tree_type::const_iterator
-        >::type const_tree_iterator_t;
 
-    const_tree_iterator_t first = make_ref_transform_iterator(begin, get_value);
-    const_tree_iterator_t last = make_ref_transform_iterator(end, get_value);
+    typename token_sequence_type::iterator first = body.begin();
+    typename token_sequence_type::iterator last = body.end();
 
     expanded.push_back(result_type(T_PP_PRAGMA, "#pragma", act_token.get_position()));
 
@@ -2443,12 +2618,10 @@ pp_iterator_functor<ContextT>::on_pragma(
         else {
 #if BOOST_WAVE_PREPROCESS_PRAGMA_BODY != 0
             // preprocess the given tokensequence
-            token_sequence_type toexpand;
-
-            std::copy(first, last, std::inserter(toexpand, toexpand.end()));
+            body.erase(body.begin(), first);
 
-            typename token_sequence_type::iterator begin2 = toexpand.begin();
-            ctx.expand_whole_tokensequence(begin2, toexpand.end(),
+            typename token_sequence_type::iterator begin2 = body.begin();
+            ctx.expand_whole_tokensequence(begin2, body.end(),
                                            expanded, false, false);
 #else
             // do _not_ preprocess the token sequence
@@ -2542,6 +2715,8 @@ public:
 
     bool force_include(char const *path_, bool is_last)
     {
+        typename ContextT::allocation_policy_type::scope arena_scope(
+            this->get_functor().ctx.get_allocation_policy());
         bool result = this->get_functor().on_include_helper(path_, path_,
             false, false);
         if (is_last) {
@@ -2550,6 +2725,31 @@ public:
         }
         return result;
     }
+
+    // push interface: pass the current and all following tokens to
+    // consumer(token), bypassing the multi_pass policies as soon as the
+    // iterator is the only one using the functor and no tokens buffered by
+    // its copies are left. Until then the iterator is incremented as usual.
+    // Afterwards the iterator equals the end iterator. If an exception is
+    // thrown, preprocessing may be continued by incrementing the iterator,
+    // as if the exception was thrown from operator++().
+    template <typename ConsumerT>
+    void run(ConsumerT &&consumer)
+    {
+        // the iterator refers to the current token of the functor, if no
+        // buffered tokens are left
+        self_type const last;
+        while (*this != last &&
+            (!this->unique() || &**this != &this->get_input()))
+        {
+            consumer(**this);
+            ++*this;
+        }
+        if (*this != last) {
+            this->functor_input_type::
+                template inner<input_policy_type>::consume_input(consumer);
+        }
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
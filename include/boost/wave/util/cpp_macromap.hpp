@@ -23,6 +23,7 @@
 #include <iterator>
 #include <algorithm>
 #include <string>
+#include <utility>
 
 #include <boost/assert.hpp>
 #include <boost/wave/wave_config.hpp>
@@ -43,10 +44,6 @@
 #include <boost/wave/util/cpp_macromap_utils.hpp>
 #include <boost/wave/util/cpp_macromap_predef.hpp>
 #include <boost/wave/util/filesystem_compatibility.hpp>
-#include <boost/wave/grammars/cpp_defined_grammar_gen.hpp>
-#if BOOST_WAVE_SUPPORT_HAS_INCLUDE != 0
-#include <boost/wave/grammars/cpp_has_include_grammar_gen.hpp>
-#endif
 
 #include <boost/wave/wave_version.hpp>
 #include <boost/wave/cpp_exceptions.hpp>
@@ -716,7 +713,7 @@ macromap<ContextT>::expand_tokensequence_worker(
     if (!pending.empty()) {
         on_exit::pop_front<definition_container_type> pop_front_token(pending);
 
-        return act_token = pending.front();
+        return act_token = std::move(pending.front());
     }
 
     //  analyze the next element of the given sequence, if it is an
@@ -732,7 +729,7 @@ macromap<ContextT>::expand_tokensequence_worker(
 
             ++first;
             if (first == last)
-                return act_token = placeholder;
+                return act_token = std::move(placeholder);
             id = token_id(*first);
         }
 
@@ -766,7 +763,7 @@ macromap<ContextT>::expand_tokensequence_worker(
                     // next token
                     on_exit::pop_front<definition_container_type> pop_token(pending);
 
-                    return act_token = pending.front();
+                    return act_token = std::move(pending.front());
                 }
 
                 // the operator _Pragma() was eaten completely, continue
@@ -802,7 +799,7 @@ macromap<ContextT>::expand_tokensequence_worker(
                     // return the first token from the pending queue
                     on_exit::pop_front<definition_container_type> pop_queue(pending);
 
-                    return act_token = pending.front();
+                    return act_token = std::move(pending.front());
                 }
                 else {
                     // macro expansion reached the eoi
@@ -823,7 +820,7 @@ macromap<ContextT>::expand_tokensequence_worker(
                 return result;
             }
             else {
-                act_token = name_token;
+                act_token = std::move(name_token);
                 ++first;
                 return act_token;
             }
@@ -1376,10 +1373,7 @@ macromap<ContextT>::rescan_replacement_list(token_type const &curr_token,
             while (it != end) {
                 using namespace boost::wave;
                 if (T_PLACEMARKER == token_id(*it)) {
-                    typename ContainerT::iterator placemarker = it;
-
-                    ++it;
-                    replacement_list.erase(placemarker);
+                    it = replacement_list.erase(it);
                 }
                 else {
                     ++it;
@@ -1722,7 +1716,7 @@ macromap<ContextT>::expand_predefined_macro(token_type const &curr_token,
 
     ctx.get_hooks().expanded_macro(ctx.derived(), replacement_list);
 
-    expanded.push_back(replacement);
+    expanded.push_back(std::move(replacement));
 
     ctx.get_hooks().rescanned_macro(ctx.derived(), expanded);
 
@@ -1743,15 +1737,11 @@ macromap<ContextT>::resolve_defined(IteratorT &first,
     IteratorT const &last, ContainerT &pending)
 {
     using namespace boost::wave;
-    using namespace boost::wave::grammars;
 
-ContainerT result;
-IteratorT start = first;
-boost::spirit::classic::parse_info<IteratorT> hit =
-    defined_grammar_gen<typename ContextT::lexer_type>::
-        parse_operator_defined(start, last, result);
+    token_type name;
+    IteratorT it = first;
 
-    if (!hit.hit) {
+    if (!impl::match_operator_defined(it, last, name)) {
         string_type msg ("defined(): ");
         msg = msg + util::impl::as_string<string_type>(first, last);
         BOOST_WAVE_THROW_CTX(ctx, preprocess_exception, ill_formed_expression,
@@ -1761,17 +1751,16 @@ boost::spirit::classic::parse_info<IteratorT> hit =
         pending.push_back(token_type(T_INTLIT, "0", main_pos));
     }
     else {
-        impl::assign_iterator<IteratorT>::do_(first, hit.stop);
+        impl::assign_iterator<IteratorT>::do_(first, it);
 
         // insert a token, which reflects the outcome
         pending.push_back(token_type(T_INTLIT,
-            is_defined(result.begin(), result.end()) ? "1" : "0",
-            main_pos));
+            is_defined(name.get_value()) ? "1" : "0", main_pos));
     }
 
     on_exit::pop_front<definition_container_type> pop_front_token(pending);
 
-    return act_token = pending.front();
+    return act_token = std::move(pending.front());
 }
 
 #if BOOST_WAVE_SUPPORT_HAS_INCLUDE != 0
@@ -1788,18 +1777,15 @@ macromap<ContextT>::resolve_has_include(IteratorT &first,
     IteratorT const &last, ContainerT &pending)
 {
     using namespace boost::wave;
-    using namespace boost::wave::grammars;
 
     ContainerT result;
     bool is_quoted_filename;
     bool is_system;
-    IteratorT start = first;
+    IteratorT it = first;
 
-    boost::spirit::classic::parse_info<IteratorT> hit =
-        has_include_grammar_gen<typename ContextT::lexer_type>::
-        parse_operator_has_include(start, last, result, is_quoted_filename, is_system);
-
-    if (!hit.hit) {
+    if (!impl::match_operator_has_include(it, last, result,
+            is_quoted_filename, is_system))
+    {
         string_type msg ("__has_include(): ");
         msg = msg + util::impl::as_string<string_type>(first, last);
         BOOST_WAVE_THROW_CTX(ctx, preprocess_exception, ill_formed_expression,
@@ -1809,7 +1795,7 @@ macromap<ContextT>::resolve_has_include(IteratorT &first,
         pending.push_back(token_type(T_INTLIT, "0", main_pos));
     }
     else {
-        impl::assign_iterator<IteratorT>::do_(first, hit.stop);
+        impl::assign_iterator<IteratorT>::do_(first, it);
 
         // insert a token, which reflects the outcome
         pending.push_back(
@@ -1821,7 +1807,7 @@ macromap<ContextT>::resolve_has_include(IteratorT &first,
 
     on_exit::pop_front<definition_container_type> pop_front_token(pending);
 
-    return act_token = pending.front();
+    return act_token = std::move(pending.front());
 }
 #endif
 
@@ -1945,7 +1931,7 @@ macromap<ContextT>::resolve_operator_pragma(IteratorT &first,
     pending.push_front(token_type(T_STRINGLIT, string_type("\"") + pragma_cmd + "\"",
         pragma_token.get_position()));
     pending.push_front(token_type(T_LEFTPAREN, "(", pragma_token.get_position()));
-    pending.push_front(pragma_token);
+    pending.push_front(std::move(pragma_token));
     return false;
 }
 
@@ -2075,17 +2061,15 @@ macromap<ContextT>::concat_tokensequence(ContainerT &expanded)
                     // remove the '##' and the next tokens from the sequence
                     iterator_type first_to_delete = prev;
 
-                    expanded.erase(++first_to_delete, ++next);
-                    it = next;
+                    it = expanded.erase(++first_to_delete, ++next);
                     continue;
                 }
                 else if (T_PLACEMARKER == token_id(*prev)) {
                     // remove the '##' and the next tokens from the sequence
                     iterator_type first_to_delete = prev;
 
-                    *prev = *next;
-                    expanded.erase(++first_to_delete, ++next);
-                    it = next;
+                    *prev = std::move(*next);
+                    it = expanded.erase(++first_to_delete, ++next);
                     continue;
                 }
             }
@@ -2111,22 +2095,28 @@ macromap<ContextT>::concat_tokensequence(ContainerT &expanded)
 #if BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
             if (boost::wave::need_variadics(ctx.get_language())) {
                 // remove the prev, '##' and the next tokens from the sequence
-                expanded.erase(prev, ++next); // remove not needed tokens
-
-                // some stl implementations clear() the container if we erased all
-                // the elements, which orphans all iterators. we re-initialize these
-                // here
-                if (expanded.empty())
-                    end = next = expanded.end();
+                next = expanded.erase(prev, ++next); // remove not needed tokens
 
                 // replace the old token (pointed to by *prev) with the re-tokenized
-                // sequence
-                expanded.splice(next, rescanned);
-
-                // the last token of the inserted sequence is the new previous
-                prev = next;
-                if (next != expanded.end())
+                // sequence, the last token of the inserted sequence is the new
+                // previous
+                if (!rescanned.empty()) {
+                    prev = rescanned.end();
                     --prev;
+                    expanded.splice(next, rescanned);
+                    next = prev;
+                    ++next;
+                }
+                else {
+                    prev = next;
+                    if (next != expanded.end())
+                        --prev;
+                }
+
+                // some stl implementations clear() the container if we erased all
+                // the elements, which orphans all iterators. we re-initialize the
+                // end iterator here
+                end = expanded.end();
             }
             else
 #endif // BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
@@ -2140,7 +2130,7 @@ macromap<ContextT>::concat_tokensequence(ContainerT &expanded)
                 // remove the '##' and the next tokens from the sequence
                 iterator_type first_to_delete = prev;
 
-                expanded.erase(++first_to_delete, ++next);
+                next = expanded.erase(++first_to_delete, ++next);
             }
             it = next;
             continue;
@@ -14,6 +14,7 @@
 #define BOOST_CPP_MACROMAP_PREDEF_HPP_HK041119
 
 #include <cstdio>
+#include <ctime>
 #include <boost/assert.hpp>
 #include <boost/format.hpp>
 
@@ -74,6 +75,19 @@ namespace util {
             return string_type(ss.c_str());
         }
 
+        // convert the given time to the local time, unlike localtime() this
+        // doesn't use a buffer shared by all threads
+        static bool get_local_time(std::time_t tt, std::tm &tb)
+        {
+            if (tt == (std::time_t)-1)
+                return false;
+#if defined(BOOST_WINDOWS)
+            return 0 == localtime_s(&tb, &tt);
+#else
+            return 0 != localtime_r(&tt, &tb);
+#endif
+        }
+
     protected:
         void reset_datestr()
         {
@@ -85,15 +99,13 @@ namespace util {
             // for some systems sprintf, time_t etc. is in namespace std
             using namespace std;
 
-            time_t tt = time(0);
-            struct tm *tb = 0;
+            struct tm tb;
 
-            if (tt != (time_t)-1) {
-                tb = localtime (&tt);
+            if (get_local_time(time(0), tb)) {
                 datestr_ = strconv((boost::format("\"%s %2d %4d\"")
-                                    % monthnames[tb->tm_mon]
-                                    % tb->tm_mday
-                                    % (tb->tm_year + 1900)).str());
+                                    % monthnames[tb.tm_mon]
+                                    % tb.tm_mday
+                                    % (tb.tm_year + 1900)).str());
             }
             else {
                 datestr_ = "\"??? ?? ????\"";
@@ -105,15 +117,13 @@ namespace util {
             // for some systems sprintf, time_t etc. is in namespace std
             using namespace std;
 
-            time_t tt = time(0);
-            struct tm *tb = 0;
+            struct tm tb;
 
-            if (tt != (time_t)-1) {
-                tb = localtime (&tt);
+            if (get_local_time(time(0), tb)) {
                 timestr_ = strconv((boost::format("\"%02d:%02d:%02d\"")
-                                    % tb->tm_hour
-                                    % tb->tm_min
-                                    % tb->tm_sec).str());
+                                    % tb.tm_hour
+                                    % tb.tm_min
+                                    % tb.tm_sec).str());
             }
             else {
                 timestr_ = "\"??:??:??\"";
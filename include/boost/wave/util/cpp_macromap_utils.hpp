@@ -18,6 +18,7 @@
 #include <boost/wave/wave_config.hpp>
 #include <boost/wave/token_ids.hpp>
 #include <boost/wave/util/unput_queue_iterator.hpp>
+#include <boost/wave/util/cpp_directive_recognizer.hpp>
 #include <boost/wave/language_support.hpp>
 
 // this must occur after all of the includes and before any code appears
@@ -294,10 +295,7 @@ trim_replacement_list (ContainerT &replacement_list)
         while (it != end && IS_CATEGORY(*it, WhiteSpaceTokenType)) {
             token_id id(*it);
             if (T_PLACEHOLDER != id && T_PLACEMARKER != id) {
-                typename ContainerT::iterator next = it;
-                ++next;
-                replacement_list.erase(it);
-                it = next;
+                it = replacement_list.erase(it);
             }
             else {
                 ++it;
@@ -319,10 +317,7 @@ trim_replacement_list (ContainerT &replacement_list)
         while (it != end && IS_CATEGORY(*it, WhiteSpaceTokenType)) {
             token_id id(*it);
             if (T_PLACEHOLDER != id && T_PLACEMARKER != id) {
-                typename ContainerT::iterator next = it;
-                ++next;
-                replacement_list.erase(it);
-                it = next;
+                it = replacement_list.erase(it);
             }
             else {
                 ++it;
@@ -390,10 +385,7 @@ remove_placeholders (ContainerT &replacement_list)
         while (it != end) {
             token_id id(*it);
             if (T_PLACEHOLDER == id || T_PLACEMARKER == id) {
-                typename ContainerT::iterator next = it;
-                ++next;
-                replacement_list.erase(it);
-                it = next;
+                it = replacement_list.erase(it);
             }
             else {
                 ++it;
@@ -515,6 +507,133 @@ get_full_name(IteratorT const &begin, IteratorT const &end)
     return full_name;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Match the operator defined: 'defined' name or 'defined' '(' name ')',
+//  whitespace and comments are allowed in between.
+//
+//      On success, 'it' points past the matched sequence and 'name' holds the
+//      inspected name.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename IteratorT, typename TokenT>
+inline bool
+match_operator_defined(IteratorT &it, IteratorT const &end, TokenT &name)
+{
+    using namespace boost::wave;
+
+    if (it == end || T_IDENTIFIER != token_id(*it))
+        return false;               // token contains 'defined'
+    ++it;
+
+    skip_pp_space(it, end);
+    if (it == end)
+        return false;
+
+    bool parenthesized = (T_LEFTPAREN == token_id(*it));
+    if (parenthesized) {
+        ++it;
+        skip_pp_space(it, end);
+        if (it == end)
+            return false;
+    }
+
+    if (!is_pp_name(token_id(*it)))
+        return false;
+    name = *it;
+    ++it;
+
+    if (parenthesized) {
+        skip_pp_space(it, end);
+        if (it == end || T_RIGHTPAREN != token_id(*it))
+            return false;
+        ++it;
+    }
+    return true;
+}
+
+#if BOOST_WAVE_SUPPORT_HAS_INCLUDE != 0
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Match the operator __has_include: '__has_include' '(' followed by either
+//  <...>, a string literal or an arbitrary sequence of tokens with properly
+//  nested parentheses (computed include) and a closing ')'.
+//
+//      The tokens of the file name are appended to 'tokens', whitespace and
+//      comments are not stored. If a '<' isn't followed by a matching '>'
+//      the tokens consumed so far are not removed before the sequence is
+//      matched as a computed include again.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename IteratorT, typename ContainerT>
+inline bool
+match_operator_has_include(IteratorT &it, IteratorT const &end,
+    ContainerT &tokens, bool &is_quoted_filename, bool &is_system)
+{
+    using namespace boost::wave;
+
+    is_quoted_filename = false;
+    is_system = false;
+
+    if (it == end || T_IDENTIFIER != token_id(*it))
+        return false;               // token contains '__has_include'
+    ++it;
+
+    skip_pp_space(it, end);
+    if (it == end || T_LEFTPAREN != token_id(*it))
+        return false;
+    ++it;
+    skip_pp_space(it, end);
+
+    bool matched = false;
+    if (it != end && T_LESS == token_id(*it)) {
+        // <...>
+        IteratorT start = it;
+
+        tokens.push_back(*it);
+        for (++it; skip_pp_space(it, end), it != end; ++it) {
+            tokens.push_back(*it);
+            if (T_GREATER == token_id(*it)) {
+                is_quoted_filename = is_system = matched = true;
+                ++it;
+                break;
+            }
+        }
+        if (!matched)
+            it = start;
+    }
+    else if (it != end && T_STRINGLIT == token_id(*it)) {
+        // "..."
+        tokens.push_back(*it);
+        is_quoted_filename = matched = true;
+        ++it;
+    }
+
+    if (!matched) {
+        // computed include
+        int depth = 0;
+        for (/**/; skip_pp_space(it, end), it != end; ++it) {
+            token_id id = token_id(*it);
+            if (T_LEFTPAREN == id) {
+                ++depth;
+            }
+            else if (T_RIGHTPAREN == id) {
+                if (0 == depth)
+                    break;
+                --depth;
+            }
+            tokens.push_back(*it);
+        }
+    }
+
+    skip_pp_space(it, end);
+    if (it == end || T_RIGHTPAREN != token_id(*it))
+        return false;
+    ++it;
+    return true;
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  The following predicate is used in conjunction with the remove_copy_if
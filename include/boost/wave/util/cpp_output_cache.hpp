@@ -0,0 +1,498 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Persistent cache of the preprocessed output
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_CPP_OUTPUT_CACHE_HPP_6F2D8A47_C913_4E5B_B07A_3D9E1C64F820_INCLUDED)
+#define BOOST_CPP_OUTPUT_CACHE_HPP_6F2D8A47_C913_4E5B_B07A_3D9E1C64F820_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/sha256.hpp>
+#include <boost/wave/util/binary_file_io.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  output_cache: keeps the results of the runs of the preprocessor in a
+//  directory, so a translation unit preprocessed before with the same
+//  inputs doesn't need to be preprocessed again
+//
+//      A run is identified by a key, i.e. the description of everything
+//      the output depends on apart from the included files (f.e. the
+//      options, the initial macro definitions and the content of the main
+//      file). The manifest stored for a key lists the results stored so far
+//      together with the files they were made from (with the digests of
+//      their contents). A result is reused only, if all of these files are
+//      unchanged.
+//
+//      Files whose size and modification time are as recorded are taken as
+//      unchanged, others are compared by their content. Inputs modified
+//      after the run started aren't trusted, the result isn't stored then.
+//      Like in the direct mode of ccache, a newly created header, which
+//      would be found instead of one of the recorded files, isn't detected.
+//
+//      The cache is limited to a maximal size, if this is exceeded the least
+//      recently used files are removed. Concurrent users don't corrupt the
+//      cache (all files are replaced atomically), but some of the stored
+//      results or updates of the statistics may be lost.
+//
+///////////////////////////////////////////////////////////////////////////////
+class output_cache
+{
+public:
+    // the outcome of a run of the preprocessor
+    struct result
+    {
+        std::string output;         // the preprocessed text
+        std::string dependencies;   // the list of dependencies (if any)
+        std::string messages;       // the warnings issued
+    };
+
+    // the statistics kept in the cache directory
+    struct statistics
+    {
+        statistics()
+        :   hits(0), misses(0), uncacheable(0), stored(0), evicted(0),
+            size(0)
+        {}
+
+        boost::uint64_t hits;
+        boost::uint64_t misses;
+        boost::uint64_t uncacheable;    // runs, whose result can't be stored
+        boost::uint64_t stored;
+        boost::uint64_t evicted;        // files removed to limit the size
+        boost::uint64_t size;           // the bytes used by the cache
+    };
+
+    enum { max_entries = 16 };          // results kept per key
+
+    output_cache()
+    :   max_size(0)
+    {}
+
+    // use the given directory (which is created, if necessary), a maximal
+    // size of zero means no limit
+    bool open(std::string const &directory_, boost::uint64_t max_size_ = 0)
+    {
+        boost::system::error_code ec;
+        directory = boost::filesystem::path(directory_);
+        max_size = max_size_;
+        boost::filesystem::create_directories(directory, ec);
+        return boost::filesystem::is_directory(directory, ec);
+    }
+    bool is_open() const { return !directory.empty(); }
+
+    // find a result stored for the given key, whose inputs are unchanged
+    bool find(std::string const &key, result &r)
+    {
+        std::vector<entry> entries;
+        if (read_manifest(manifest_path(key), entries)) {
+            std::map<std::string, std::string> digests;
+            for (std::size_t i = 0; i < entries.size(); ++i) {
+                if (!is_current(entries[i], digests))
+                    continue;
+
+                boost::filesystem::path file(
+                    object_path(entries[i].result, ".result"));
+                if (read_result(file, r)) {
+                    // the most recently used files are kept longest
+                    touch(file);
+                    touch(manifest_path(key));
+                    ++counters.hits;
+                    return true;
+                }
+            }
+        }
+        ++counters.misses;
+        return false;
+    }
+
+    // store the result of a run started at the given time, which read the
+    // given files
+    bool insert(std::string const &key, std::vector<std::string> const &files,
+        result const &r, std::time_t started)
+    {
+        namespace fs = boost::filesystem;
+
+        entry e;
+        sha256 id;
+        id.update(key_digest(key));
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            boost::system::error_code ec;
+            fs::path p(files[i]);
+            input_file f;
+            f.path = files[i];
+            f.size = fs::file_size(p, ec);
+            if (!ec)
+                f.mtime = boost::int64_t(fs::last_write_time(p, ec));
+            if (ec || f.mtime >= boost::int64_t(started) ||
+                !digest_file(files[i], f.digest))
+            {
+                ++counters.uncacheable;     // modified while preprocessing
+                return false;
+            }
+            id.update(f.path);
+            id.update(f.digest);
+            e.files.push_back(f);
+        }
+        e.result = sha256::to_hex(id.finish());
+
+        // the result is stored first, so the manifest never refers to a
+        // result, which doesn't exist
+        std::string data;
+        fs::path result_file(object_path(e.result, ".result"));
+        boost::system::error_code ec;
+        if (!fs::exists(result_file, ec)) {
+            serialize(r, data);
+            if (!write_file(result_file, data))
+                return false;
+            counters.size += data.size();
+        }
+
+        fs::path manifest(manifest_path(key));
+        std::vector<entry> entries;
+        boost::uint64_t old_size = 0;
+        if (read_manifest(manifest, entries))
+            old_size = file_size(manifest);
+
+        std::vector<entry>::iterator it = entries.begin();
+        while (it != entries.end()) {
+            if ((*it).result == e.result)
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+        entries.insert(entries.begin(), e);
+        if (entries.size() > max_entries)
+            entries.resize(max_entries);
+
+        serialize(entries, data);
+        if (!write_file(manifest, data))
+            return false;
+        counters.size += data.size();
+        counters.size -= old_size;
+        ++counters.stored;
+        return true;
+    }
+
+    // count a run, whose result can't be stored (f.e. as it depends on the
+    // current time)
+    void count_uncacheable() { ++counters.uncacheable; }
+
+    // add the statistics of this object to the ones kept in the cache
+    // directory, removes the least recently used files if the cache grew
+    // too large
+    bool save_statistics()
+    {
+        statistics total;
+        read_statistics(directory.string(), total);
+        total.hits += counters.hits;
+        total.misses += counters.misses;
+        total.uncacheable += counters.uncacheable;
+        total.stored += counters.stored;
+        total.evicted += counters.evicted;
+        total.size += counters.size;
+        if (0 != max_size && total.size > max_size)
+            cleanup(total);
+        counters = statistics();
+
+        std::ostringstream data;
+        data << "hits " << total.hits << "\n"
+             << "misses " << total.misses << "\n"
+             << "uncacheable " << total.uncacheable << "\n"
+             << "stored " << total.stored << "\n"
+             << "evicted " << total.evicted << "\n"
+             << "size " << total.size << "\n";
+        return write_file(directory / "stats", data.str());
+    }
+    statistics const &get_statistics() const { return counters; }
+
+    static bool read_statistics(std::string const &directory_,
+        statistics &stats)
+    {
+        std::ifstream file((boost::filesystem::path(directory_) / "stats").
+            string().c_str());
+        if (!file.is_open())
+            return false;
+
+        std::string name;
+        boost::uint64_t value = 0;
+        while (file >> name >> value) {
+            if ("hits" == name)             stats.hits = value;
+            else if ("misses" == name)      stats.misses = value;
+            else if ("uncacheable" == name) stats.uncacheable = value;
+            else if ("stored" == name)      stats.stored = value;
+            else if ("evicted" == name)     stats.evicted = value;
+            else if ("size" == name)        stats.size = value;
+        }
+        return true;
+    }
+
+private:
+    struct input_file
+    {
+        input_file() : size(0), mtime(-1) {}
+
+        std::string path;
+        boost::uint64_t size;
+        boost::int64_t mtime;
+        std::string digest;
+    };
+
+    struct entry
+    {
+        std::vector<input_file> files;
+        std::string result;         // the name of the result (a digest)
+    };
+
+    static boost::uint64_t file_size(boost::filesystem::path const &p)
+    {
+        boost::system::error_code ec;
+        boost::uintmax_t size = boost::filesystem::file_size(p, ec);
+        return ec ? 0 : boost::uint64_t(size);
+    }
+    static void touch(boost::filesystem::path const &p)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::last_write_time(p, std::time(0), ec);
+    }
+
+    static bool digest_file(std::string const &path, std::string &digest)
+    {
+        std::string data;
+        if (!binary_file_io::read_file(path, data))
+            return false;
+        digest = sha256::hex_digest(data);
+        return true;
+    }
+
+    static bool write_file(boost::filesystem::path const &target,
+        std::string const &data)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(target.parent_path(), ec);
+        return binary_file_io::write_file(target, data);
+    }
+
+    // the results and manifests are spread over 256 subdirectories
+    static std::string key_digest(std::string const &key)
+    {
+        return sha256::hex_digest(key);
+    }
+    boost::filesystem::path object_path(std::string const &name,
+        char const *extension) const
+    {
+        boost::filesystem::path p(directory / name.substr(0, 2));
+        p /= name.substr(2) + extension;
+        return p;
+    }
+    boost::filesystem::path manifest_path(std::string const &key) const
+    {
+        return object_path(key_digest(key), ".manifest");
+    }
+
+    // the digests of the files compared so far are kept for the next entry
+    bool is_current(entry const &e,
+        std::map<std::string, std::string> &digests) const
+    {
+        namespace fs = boost::filesystem;
+
+        for (std::size_t i = 0; i < e.files.size(); ++i) {
+            input_file const &f = e.files[i];
+            std::map<std::string, std::string>::iterator it =
+                digests.find(f.path);
+            if (it == digests.end()) {
+                boost::system::error_code ec;
+                boost::uint64_t size = fs::file_size(fs::path(f.path), ec);
+                if (ec || size != f.size)
+                    return false;       // missing or obviously modified
+
+                // compare the contents, if the file was touched
+                std::string digest(f.digest);
+                if (binary_file_io::modification_time(f.path) != f.mtime &&
+                    !digest_file(f.path, digest))
+                {
+                    return false;
+                }
+                it = digests.insert(std::make_pair(f.path, digest)).first;
+            }
+            if ((*it).second != f.digest)
+                return false;
+        }
+        return true;
+    }
+
+    // remove the least recently used files until the cache is reduced to
+    // 90 percent of its maximal size
+    void cleanup(statistics &total)
+    {
+        namespace fs = boost::filesystem;
+
+        std::vector<std::pair<std::time_t, std::pair<fs::path, boost::uint64_t> > >
+            files;
+        boost::uint64_t size = 0;
+        boost::system::error_code ec;
+        for (fs::recursive_directory_iterator it(directory, ec), end;
+             !ec && it != end; it.increment(ec))
+        {
+            fs::path const &p = it->path();
+            if (p.extension() != ".result" && p.extension() != ".manifest")
+                continue;
+
+            boost::system::error_code fec;
+            boost::uint64_t file_size = fs::file_size(p, fec);
+            std::time_t mtime = fs::last_write_time(p, fec);
+            if (fec)
+                continue;
+            files.push_back(std::make_pair(mtime,
+                std::make_pair(p, file_size)));
+            size += file_size;
+        }
+
+        std::sort(files.begin(), files.end());
+        boost::uint64_t const limit = max_size / 10 * 9;
+        for (std::size_t i = 0; i < files.size() && size > limit; ++i) {
+            if (fs::remove(files[i].second.first, ec)) {
+                size -= files[i].second.second;
+                ++total.evicted;
+            }
+        }
+        total.size = size;
+    }
+
+    // file formats: "WOCM" (manifest) or "WOCR" (result), the version, then
+    // the entries of the manifest (each consisting of the files with their
+    // size, modification time and digest and the name of the result) or the
+    // parts of the result (see binary_file_io)
+    static void serialize(std::vector<entry> const &entries, std::string &out)
+    {
+        using binary_file_io::write_uint;
+        using binary_file_io::write_string;
+
+
+        out.assign("WOCM", 4);
+        write_uint(out, 1, 4);
+        write_uint(out, entries.size(), 4);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            entry const &e = entries[i];
+            write_uint(out, e.files.size(), 4);
+            for (std::size_t j = 0; j < e.files.size(); ++j) {
+                write_string(out, e.files[j].path);
+                write_uint(out, e.files[j].size, 8);
+                write_uint(out, boost::uint64_t(e.files[j].mtime), 8);
+                write_string(out, e.files[j].digest);
+            }
+            write_string(out, e.result);
+        }
+    }
+    static void serialize(result const &r, std::string &out)
+    {
+        using binary_file_io::write_uint;
+        using binary_file_io::write_string;
+
+        out.assign("WOCR", 4);
+        write_uint(out, 1, 4);
+        write_string(out, r.output);
+        write_string(out, r.dependencies);
+        write_string(out, r.messages);
+    }
+
+    static bool read_manifest(boost::filesystem::path const &p,
+        std::vector<entry> &entries)
+    {
+        std::string data;
+        if (!binary_file_io::read_file(p.string(), data) || data.size() < 4 ||
+            0 != data.compare(0, 4, "WOCM"))
+        {
+            return false;
+        }
+
+        binary_file_io::reader in(data, 4);
+        boost::uint64_t version = 0, count = 0;
+        if (!in.read_uint(version, 4) || 1 != version || !in.read_uint(count, 4))
+            return false;
+
+        for (boost::uint64_t n = 0; n < count; ++n) {
+            entry e;
+            boost::uint64_t files = 0;
+            if (!in.read_uint(files, 4))
+                return false;
+            for (boost::uint64_t i = 0; i < files; ++i) {
+                input_file f;
+                boost::uint64_t mtime = 0;
+                if (!in.read_string(f.path) || !in.read_uint(f.size, 8) ||
+                    !in.read_uint(mtime, 8) || !in.read_string(f.digest))
+                {
+                    return false;
+                }
+                f.mtime = boost::int64_t(mtime);
+                e.files.push_back(f);
+            }
+            if (!in.read_string(e.result))
+                return false;
+            entries.push_back(e);
+        }
+        return in.at_end();
+    }
+    static bool read_result(boost::filesystem::path const &p, result &r)
+    {
+        std::string data;
+        if (!binary_file_io::read_file(p.string(), data) || data.size() < 4 ||
+            0 != data.compare(0, 4, "WOCR"))
+        {
+            return false;
+        }
+
+        binary_file_io::reader in(data, 4);
+        boost::uint64_t version = 0;
+        return in.read_uint(version, 4) && 1 == version &&
+            in.read_string(r.output) && in.read_string(r.dependencies) &&
+            in.read_string(r.messages) && in.at_end();
+    }
+
+    boost::filesystem::path directory;
+    boost::uint64_t max_size;
+    statistics counters;            // of this object, see save_statistics()
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_CPP_OUTPUT_CACHE_HPP_6F2D8A47_C913_4E5B_B07A_3D9E1C64F820_INCLUDED)
@@ -1166,6 +1166,278 @@ public:
     { return allocator_type(); }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// class template SmallSharedStringStorage
+// Stores strings of up to 'threshold' characters inline, longer strings live
+// in a heap block which is shared between copies (copy on write). The use
+// count of the shared block is a plain integer, i.e. just like CowString
+// copies of the same string must not be used concurrently from different
+// threads.
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename E, class A = std::allocator<E>, unsigned int threshold = 23>
+class SmallSharedStringStorage
+{
+public:
+    typedef E value_type;
+    typedef E* iterator;
+    typedef const E* const_iterator;
+    typedef A allocator_type;
+    typedef typename boost::allocator_size_type<A>::type size_type;
+
+private:
+    struct Rep
+    {
+        std::size_t refs_;
+        size_type size_;
+        size_type capacity_;
+        E buffer_[1];           // room for the terminating zero
+    };
+
+    // the last element of the buffer holds the number of unused characters
+    // of a small string (doubling as the terminating zero of a string of
+    // maximal length) or 'magic' if the string is stored in a Rep
+    enum { temp = (sizeof(Rep*) + sizeof(E) - 1) / sizeof(E) };
+
+public:
+    enum { maxSmallString = threshold > static_cast<unsigned int>(temp)
+        ? threshold : static_cast<unsigned int>(temp) };
+
+private:
+    enum { magic = maxSmallString + 1 };
+
+    union
+    {
+        E buf_[maxSmallString + 1];
+        Rep* rep_;
+    };
+
+    bool Small() const
+    {
+        return buf_[maxSmallString] != E(magic);
+    }
+
+    void SetSmallSize(size_type n)
+    {
+        BOOST_ASSERT(n <= maxSmallString);
+        buf_[n] = E();
+        buf_[maxSmallString] = E(maxSmallString - n);
+    }
+
+    void SetRep(Rep* r)
+    {
+        rep_ = r;
+        buf_[maxSmallString] = E(magic);
+    }
+
+    static size_type RepUnits(size_type cap)
+    {
+        return (sizeof(Rep) + cap * sizeof(E) + sizeof(E) - 1) / sizeof(E);
+    }
+
+    static Rep* NewRep(size_type size, size_type cap)
+    {
+        BOOST_ASSERT(size <= cap);
+        A alloc;
+        Rep* r = reinterpret_cast<Rep*>(
+            boost::allocator_allocate(alloc, RepUnits(cap)));
+        r->refs_ = 1;
+        r->size_ = size;
+        r->capacity_ = cap;
+        r->buffer_[size] = E();
+        return r;
+    }
+
+    static void Release(Rep* r)
+    {
+        if (--r->refs_ == 0)
+        {
+            A alloc;
+            boost::allocator_deallocate(alloc, reinterpret_cast<E*>(r),
+                RepUnits(r->capacity_));
+        }
+    }
+
+    // replace the current representation by a new (unshared) Rep holding
+    // the current contents, keeps the capacity unless it has to grow
+    void Reallocate(size_type cap)
+    {
+        const size_type sz = size();
+        Rep* r = NewRep(sz, cap);
+        flex_string_details::pod_copy(data(), data() + sz, r->buffer_);
+        if (!Small()) Release(rep_);
+        SetRep(r);
+    }
+
+    E* MakeUnique()
+    {
+        if (Small()) return buf_;
+        if (rep_->refs_ != 1) Reallocate(rep_->capacity_);
+        return rep_->buffer_;
+    }
+
+public:
+    SmallSharedStringStorage(const SmallSharedStringStorage& rhs)
+    {
+        flex_string_details::pod_copy(rhs.buf_,
+            rhs.buf_ + maxSmallString + 1, buf_);
+        if (!Small()) ++rep_->refs_;
+    }
+
+    SmallSharedStringStorage(const A&)
+    {
+        SetSmallSize(0);
+    }
+
+    SmallSharedStringStorage(const E* s, size_type len, const A&)
+    {
+        if (len <= maxSmallString)
+        {
+            flex_string_details::pod_copy(s, s + len, buf_);
+            SetSmallSize(len);
+        }
+        else
+        {
+            Rep* r = NewRep(len, len);
+            flex_string_details::pod_copy(s, s + len, r->buffer_);
+            SetRep(r);
+        }
+    }
+
+    SmallSharedStringStorage(size_type len, E c, const A&)
+    {
+        if (len <= maxSmallString)
+        {
+            flex_string_details::pod_fill(buf_, buf_ + len, c);
+            SetSmallSize(len);
+        }
+        else
+        {
+            Rep* r = NewRep(len, len);
+            flex_string_details::pod_fill(r->buffer_, r->buffer_ + len, c);
+            SetRep(r);
+        }
+    }
+
+    SmallSharedStringStorage& operator=(const SmallSharedStringStorage& rhs)
+    {
+        if (this != &rhs)
+        {
+            if (!rhs.Small()) ++rhs.rep_->refs_;
+            if (!Small()) Release(rep_);
+            flex_string_details::pod_copy(rhs.buf_,
+                rhs.buf_ + maxSmallString + 1, buf_);
+        }
+        return *this;
+    }
+
+    ~SmallSharedStringStorage()
+    {
+        if (!Small()) Release(rep_);
+    }
+
+    iterator begin()
+    { return MakeUnique(); }
+
+    const_iterator begin() const
+    { return data(); }
+
+    iterator end()
+    { return MakeUnique() + size(); }
+
+    const_iterator end() const
+    { return data() + size(); }
+
+    size_type size() const
+    {
+        return Small()
+            ? size_type(maxSmallString - buf_[maxSmallString])
+            : rep_->size_;
+    }
+
+    size_type max_size() const
+    { return boost::allocator_max_size(A()) - RepUnits(0); }
+
+    size_type capacity() const
+    { return Small() ? size_type(maxSmallString) : rep_->capacity_; }
+
+    void reserve(size_type res_arg)
+    {
+        if (res_arg > capacity())
+            Reallocate(res_arg);
+    }
+
+    void append(const E* s, size_type sz)
+    {
+        append(s, s + sz);
+    }
+
+    template <class ForwardIterator>
+    void append(ForwardIterator b, ForwardIterator e)
+    {
+        const size_type
+            sz = size(),
+            neededCapacity = sz + std::distance(b, e);
+
+        if (neededCapacity > capacity() || (!Small() && rep_->refs_ != 1))
+        {
+            // build the new Rep before releasing the current contents, the
+            // appended range may refer to these
+            Rep* r = NewRep(neededCapacity,
+                (std::max)(neededCapacity, capacity()));
+            std::copy(b, e, flex_string_details::pod_copy(
+                data(), data() + sz, r->buffer_));
+            if (!Small()) Release(rep_);
+            SetRep(r);
+        }
+        else if (Small())
+        {
+            std::copy(b, e, buf_ + sz);
+            SetSmallSize(neededCapacity);
+        }
+        else
+        {
+            std::copy(b, e, rep_->buffer_ + sz);
+            rep_->size_ = neededCapacity;
+            rep_->buffer_[neededCapacity] = E();
+        }
+    }
+
+    void resize(size_type n, E c)
+    {
+        const size_type sz = size();
+        reserve(n);
+
+        E* p = MakeUnique();
+        if (n > sz)
+            flex_string_details::pod_fill(p + sz, p + n, c);
+
+        if (Small())
+        {
+            SetSmallSize(n);
+        }
+        else
+        {
+            rep_->size_ = n;
+            p[n] = E();
+        }
+    }
+
+    void swap(SmallSharedStringStorage& rhs)
+    {
+        std::swap_ranges(buf_, buf_ + maxSmallString + 1, rhs.buf_);
+    }
+
+    const E* c_str() const
+    { return data(); }
+
+    const E* data() const
+    { return Small() ? buf_ : rep_->buffer_; }
+
+    A get_allocator() const
+    { return A(); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // class template CowString
 // Implements Copy on Write over any storage
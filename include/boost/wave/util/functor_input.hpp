@@ -125,6 +125,21 @@ struct functor_input {
             data->was_initialized = true;
         }
 
+        // pass the current and all following tokens up to eof to the given
+        // consumer, calling the functor directly; if an exception is thrown,
+        // the current token is the last one passed
+        template <typename ConsumerT>
+        void consume_input(ConsumerT &consumer)
+        {
+            BOOST_ASSERT(0 != data);
+            ensure_initialized();
+            while (!(data->curtok == data->ftor.eof)) {
+                result_type const &token = data->curtok;
+                consumer(token);
+                data->curtok = (data->ftor)();
+            }
+        }
+
         bool input_at_eof() const
         {
             ensure_initialized();
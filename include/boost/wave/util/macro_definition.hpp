@@ -14,10 +14,10 @@
 #include <vector>
 #include <list>
 
-#include <boost/smart_ptr/detail/atomic_count.hpp>
 #include <boost/intrusive_ptr.hpp>
 
 #include <boost/wave/wave_config.hpp>
+#include <boost/wave/util/refcount.hpp>
 #if BOOST_WAVE_SERIALIZATION != 0
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/list.hpp>
@@ -147,7 +147,7 @@ struct macro_definition {
 #if BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
     bool has_ellipsis;
 #endif
-    boost::detail::atomic_count use_count;
+    refcount_type use_count;
 
 #if BOOST_WAVE_SERIALIZATION != 0
     // default constructor is needed for serialization only
@@ -0,0 +1,319 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Buffered sink for the generated output
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_WAVE_OUTPUT_SINK_HPP_9C41E7A2_3B6F_4D85_A0E9_52F8D1B7C364_INCLUDED)
+#define BOOST_WAVE_OUTPUT_SINK_HPP_9C41E7A2_3B6F_4D85_A0E9_52F8D1B7C364_INCLUDED
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#if defined(BOOST_WINDOWS)
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <boost/config.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <boost/wave/wave_config.hpp>
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#endif
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  output_sink: collects the text of the generated tokens in a large buffer,
+//  which is passed to the operating system (write(2)) as a whole once it is
+//  full, avoiding the overhead of the formatted stream output per token.
+//
+//  The text goes to the file opened by open() or, as long as there is none,
+//  to the stream given to the constructor (which may be redirected by its
+//  owner). If BOOST_WAVE_SUPPORT_THREADING is defined to something != 0,
+//  set_asynchronous(true) lets a background thread write the full buffers
+//  of the files opened afterwards, while the next buffer is filled.
+//
+//  Errors writing the file are remembered (see good() and error()), the
+//  text written afterwards is dropped. Errors of the stream are left to its
+//  owner.
+//
+///////////////////////////////////////////////////////////////////////////////
+class output_sink : private boost::noncopyable
+{
+public:
+    enum { default_buffer_size = 256 * 1024 };
+
+    explicit output_sink(std::ostream &stream_,
+            std::size_t buffer_size_ = default_buffer_size)
+    :   stream(stream_), buffer_size(buffer_size_), fd(-1), error_value(0)
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+      , asynchronous(false), has_pending(false), stop(false)
+#endif
+    {
+        buffer.reserve(buffer_size);
+    }
+    ~output_sink()
+    {
+        close();
+        flush();
+    }
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    // write the files opened from now on using a background thread
+    void set_asynchronous(bool asynchronous_) { asynchronous = asynchronous_; }
+#endif
+
+    // redirect the output into the given file, appending to it for
+    // mode == std::ios::out | std::ios::app
+    bool open(char const *filename, std::ios::openmode mode = std::ios::out)
+    {
+        close();
+        flush();
+
+        int flags = O_WRONLY | O_CREAT |
+            ((mode & std::ios::app) ? O_APPEND : O_TRUNC);
+#if defined(BOOST_WINDOWS)
+        fd = ::_open(filename, flags, _S_IREAD | _S_IWRITE);
+#else
+        fd = ::open(filename, flags, 0666);
+#endif
+        if (-1 == fd)
+            return false;
+
+        error_value = 0;
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        if (asynchronous) {
+            stop = false;
+            writer.reset(new boost::thread(&output_sink::write_pending, this));
+        }
+#endif
+        return true;
+    }
+    bool is_open() const { return -1 != fd; }
+
+    // write the rest of the output to the file and close it, the following
+    // output goes to the stream again
+    void close()
+    {
+        if (-1 == fd)
+            return;
+
+        flush();
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        if (writer) {
+            {
+                boost::lock_guard<boost::mutex> lock(mutex);
+                stop = true;
+            }
+            changed.notify_all();
+            writer->join();
+            writer.reset();
+        }
+#endif
+#if defined(BOOST_WINDOWS)
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+        fd = -1;
+    }
+
+    void write(char const *data, std::size_t size)
+    {
+        if (buffer.size() + size > buffer_size) {
+            flush_buffer();
+            if (size >= buffer_size) {
+                write_buffer(data, size);   // don't copy large pieces
+                return;
+            }
+        }
+        buffer.insert(buffer.end(), data, data + size);
+    }
+    void write(std::string const &text) { write(text.data(), text.size()); }
+
+    // pass the collected text to the file or the stream (without flushing
+    // the stream itself)
+    void flush()
+    {
+        flush_buffer();
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while (has_pending)
+            changed.wait(lock);
+#endif
+    }
+
+    // errors writing the current file, error() returns the errno value
+    bool good() const { return 0 == error(); }
+    int error() const
+    {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        boost::lock_guard<boost::mutex> lock(mutex);
+#endif
+        return error_value;
+    }
+
+private:
+    void flush_buffer()
+    {
+        if (buffer.empty())
+            return;
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        if (writer) {
+            // hand the buffer over to the background thread, as soon as it
+            // is done with the previous one
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                while (has_pending)
+                    changed.wait(lock);
+                pending.swap(buffer);
+                has_pending = true;
+            }
+            changed.notify_all();
+            buffer.clear();
+            buffer.reserve(buffer_size);
+            return;
+        }
+#endif
+        write_buffer(&buffer[0], buffer.size());
+        buffer.clear();
+    }
+
+    void write_buffer(char const *data, std::size_t size)
+    {
+        if (-1 == fd) {
+            stream.write(data, std::streamsize(size));
+            return;
+        }
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        if (writer) {
+            flush_buffer();
+            buffer.assign(data, data + size);
+            flush_buffer();
+            return;
+        }
+#endif
+        int const result = write_file(data, size);
+        if (0 != result)
+            set_error(result);
+    }
+
+    // write the whole data to the file, returns the errno value of a failure
+    int write_file(char const *data, std::size_t size)
+    {
+        if (!good())
+            return 0;       // drop the output after an error
+
+        while (size > 0) {
+#if defined(BOOST_WINDOWS)
+            int written = ::_write(fd, data, unsigned(
+                (std::min)(size, std::size_t(0x40000000))));
+#else
+            ssize_t written = ::write(fd, data, size);
+#endif
+            if (written < 0) {
+                if (EINTR == errno)
+                    continue;
+                return errno;
+            }
+            data += written;
+            size -= std::size_t(written);
+        }
+        return 0;
+    }
+
+    void set_error(int error_)
+    {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        boost::lock_guard<boost::mutex> lock(mutex);
+#endif
+        error_value = error_;
+    }
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    // the background thread writing the buffers handed over to it
+    void write_pending()
+    {
+        for (;;) {
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                while (!has_pending && !stop)
+                    changed.wait(lock);
+                if (!has_pending)
+                    return;         // stopped
+            }
+
+            int const result = write_file(&pending[0], pending.size());
+            {
+                boost::lock_guard<boost::mutex> lock(mutex);
+                if (0 != result)
+                    error_value = result;
+                pending.clear();
+                has_pending = false;
+            }
+            changed.notify_all();
+        }
+    }
+#endif
+
+    std::ostream &stream;           // the output while no file is open
+    std::size_t buffer_size;
+    std::vector<char> buffer;       // the text collected so far
+    int fd;                         // the current file (if any)
+    int error_value;
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    bool asynchronous;
+    boost::scoped_ptr<boost::thread> writer;
+    std::vector<char> pending;      // the buffer written by the writer
+    bool has_pending;
+    bool stop;
+    mutable boost::mutex mutex;
+    boost::condition_variable changed;
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_WAVE_OUTPUT_SINK_HPP_9C41E7A2_3B6F_4D85_A0E9_52F8D1B7C364_INCLUDED)
@@ -0,0 +1,77 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Reference counter used by the token and macro definition classes
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_WAVE_REFCOUNT_HPP_4E0C6A1B_52D7_4F0E_9C5B_7A3D2E8F1C60_INCLUDED)
+#define BOOST_WAVE_REFCOUNT_HPP_4E0C6A1B_52D7_4F0E_9C5B_7A3D2E8F1C60_INCLUDED
+
+#include <boost/wave/wave_config.hpp>
+
+#if BOOST_WAVE_ATOMIC_REFCOUNT != 0
+#include <boost/smart_ptr/detail/atomic_count.hpp>
+#endif
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  nonatomic_count
+//
+//      A reference counter exposing the same interface as
+//      boost::detail::atomic_count, but using a plain integer. It is used
+//      whenever the token and macro definition reference counts don't need
+//      to be updated atomically (see BOOST_WAVE_ATOMIC_REFCOUNT).
+//
+///////////////////////////////////////////////////////////////////////////////
+class nonatomic_count
+{
+public:
+    explicit nonatomic_count(long v) : value(v) {}
+
+    long operator++() { return ++value; }
+    long operator--() { return --value; }
+    operator long() const { return value; }
+
+private:
+    nonatomic_count(nonatomic_count const&);
+    nonatomic_count& operator=(nonatomic_count const&);
+
+    long value;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//  the reference counter type to use for the token data and the macro
+//  definitions
+#if BOOST_WAVE_ATOMIC_REFCOUNT != 0
+typedef boost::detail::atomic_count refcount_type;
+#else
+typedef nonatomic_count refcount_type;
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_WAVE_REFCOUNT_HPP_4E0C6A1B_52D7_4F0E_9C5B_7A3D2E8F1C60_INCLUDED)
@@ -0,0 +1,199 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Incremental SHA-256 message digest
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_WAVE_SHA256_HPP_4B7E2C91_5D3A_4F68_9E0B_7A1C6D2F8E35_INCLUDED)
+#define BOOST_WAVE_SHA256_HPP_4B7E2C91_5D3A_4F68_9E0B_7A1C6D2F8E35_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <boost/cstdint.hpp>
+
+#include <boost/wave/wave_config.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  sha256: computes the SHA-256 digest (FIPS 180-4) of the data passed in
+//  any number of pieces, used wherever a content has to be identified
+//  reliably (f.e. by the output cache of the wave driver)
+//
+///////////////////////////////////////////////////////////////////////////////
+class sha256
+{
+public:
+    enum { digest_size = 32 };
+
+    sha256() { reset(); }
+
+    void reset()
+    {
+        static boost::uint32_t const initial[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+        std::memcpy(state, initial, sizeof(state));
+        length = 0;
+        buffered = 0;
+    }
+
+    void update(char const *data, std::size_t size)
+    {
+        unsigned char const *p = reinterpret_cast<unsigned char const *>(data);
+        length += size;
+        if (0 != buffered) {
+            std::size_t n = (std::min)(size, std::size_t(64) - buffered);
+            std::memcpy(buffer + buffered, p, n);
+            buffered += n;
+            p += n;
+            size -= n;
+            if (64 != buffered)
+                return;
+            transform(buffer);
+            buffered = 0;
+        }
+        for (/**/; size >= 64; p += 64, size -= 64)
+            transform(p);
+        std::memcpy(buffer, p, size);
+        buffered = size;
+    }
+    void update(std::string const &data) { update(data.data(), data.size()); }
+
+    // returns the (binary) digest, the object has to be reset before it may
+    // be used again
+    std::string finish()
+    {
+        boost::uint64_t const bits = length * 8;
+        static unsigned char const padding[64] = { 0x80 };
+        update(reinterpret_cast<char const *>(padding),
+            buffered < 56 ? 56 - buffered : 120 - buffered);
+
+        unsigned char size[8];
+        for (int i = 0; i < 8; ++i)
+            size[i] = (unsigned char)(bits >> (56 - 8 * i));
+        update(reinterpret_cast<char const *>(size), 8);
+
+        std::string digest(digest_size, '\0');
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 4; ++j)
+                digest[4 * i + j] = char((state[i] >> (24 - 8 * j)) & 0xff);
+        }
+        return digest;
+    }
+
+    // the digest of the given data as a string of hex digits
+    static std::string hex_digest(std::string const &data)
+    {
+        sha256 h;
+        h.update(data);
+        return to_hex(h.finish());
+    }
+    static std::string to_hex(std::string const &digest)
+    {
+        static char const digits[] = "0123456789abcdef";
+        std::string result;
+        result.reserve(2 * digest.size());
+        for (std::size_t i = 0; i < digest.size(); ++i) {
+            result += digits[((unsigned char)digest[i]) >> 4];
+            result += digits[((unsigned char)digest[i]) & 0xf];
+        }
+        return result;
+    }
+
+private:
+    static boost::uint32_t rotate(boost::uint32_t x, int n)
+    {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    void transform(unsigned char const *block)
+    {
+        static boost::uint32_t const k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b,
+            0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+            0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+            0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
+            0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+            0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+            0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+            0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+            0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+            0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        boost::uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (boost::uint32_t(block[4 * i]) << 24) |
+                (boost::uint32_t(block[4 * i + 1]) << 16) |
+                (boost::uint32_t(block[4 * i + 2]) << 8) |
+                boost::uint32_t(block[4 * i + 3]);
+        }
+        for (int i = 16; i < 64; ++i) {
+            boost::uint32_t s0 = rotate(w[i - 15], 7) ^
+                rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            boost::uint32_t s1 = rotate(w[i - 2], 17) ^
+                rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        boost::uint32_t a = state[0], b = state[1], c = state[2],
+            d = state[3], e = state[4], f = state[5], g = state[6],
+            h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            boost::uint32_t t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^
+                rotate(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            boost::uint32_t t2 = (rotate(a, 2) ^ rotate(a, 13) ^
+                rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    boost::uint32_t state[8];
+    boost::uint64_t length;         // bytes passed to update()
+    unsigned char buffer[64];       // the incomplete block
+    std::size_t buffered;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_WAVE_SHA256_HPP_4B7E2C91_5D3A_4F68_9E0B_7A1C6D2F8E35_INCLUDED)
@@ -0,0 +1,370 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    Memory arena for tokens and token sequences
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#if !defined(BOOST_WAVE_TOKEN_ARENA_HPP_9D1B3F6E_0C2A_4B8E_A6F4_5E7C1D2B3A90_INCLUDED)
+#define BOOST_WAVE_TOKEN_ARENA_HPP_9D1B3F6E_0C2A_4B8E_A6F4_5E7C1D2B3A90_INCLUDED
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/pool/singleton_pool.hpp>
+
+#include <boost/wave/wave_config.hpp>
+
+// this must occur after all of the includes and before any code appears
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_PREFIX
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace boost {
+namespace wave {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  pool_allocation
+//
+//      The default allocation of the token data (see the AllocationT
+//      parameter of cpplexer::lex_token): the memory is taken from the
+//      process wide singleton pools.
+//
+///////////////////////////////////////////////////////////////////////////////
+struct pool_allocation
+{
+    //  size of the prefix of every allocation
+    BOOST_STATIC_CONSTANT(std::size_t, header_size = 0);
+
+    //  PoolT is the singleton pool handing out blocks of
+    //  'size + header_size' bytes
+    template <typename PoolT>
+    static void* allocate(std::size_t /*size*/)
+    {
+        void* p = PoolT::malloc();
+        if (0 == p)
+            boost::throw_exception(std::bad_alloc());
+        return p;
+    }
+
+    template <typename PoolT>
+    static void deallocate(void* p, std::size_t /*size*/)
+    {
+        PoolT::free(p);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  token_arena
+//
+//      A memory arena for the token data and the nodes of the token
+//      sequences. An arena is owned by a single context (see the
+//      allocation_policies::context_arena policy) and is not synchronized,
+//      so contexts running on different threads never contend for a lock.
+//
+//      The arena is used only by the token types selecting it, i.e.
+//      cpplexer::lex_token<PositionT, token_arena>, the sequences of these
+//      tokens use the token_allocator (see token_sequence_allocator).
+//
+//      While a context is working it installs its arena for the current
+//      thread (see token_arena_scope). Every allocation made through
+//      token_arena::allocate is prefixed with a pointer to the arena it was
+//      taken from (or a null pointer, if it was served from the global
+//      pools), which allows to hand it back to the right place regardless
+//      of the arena installed at the time it is freed.
+//
+//      All memory is returned to the system at once when the arena is
+//      destroyed. Consequently tokens allocated by a context using an arena
+//      must not outlive this context. Once none of its allocations is in use
+//      anymore, the arena may be rewound to reuse its memory from the start
+//      (see context::reset_macro_definitions()).
+//
+///////////////////////////////////////////////////////////////////////////////
+class token_arena : private boost::noncopyable
+{
+public:
+    //  size of the prefix of every allocation
+    BOOST_STATIC_CONSTANT(std::size_t, header_size = sizeof(token_arena*));
+
+    //  allocations larger than this are served from the global pools
+    BOOST_STATIC_CONSTANT(std::size_t, max_object_size = 1024);
+
+    explicit token_arena(std::size_t block_size_ = 32768)
+    :   block_size(block_size_), current(0), end(0), live(0)
+    {
+        BOOST_ASSERT(block_size >= max_object_size);
+        std::fill(free_lists, free_lists + free_list_count,
+            static_cast<free_node*>(0));
+    }
+    ~token_arena()
+    {
+        release();
+    }
+
+    //  return all memory owned by this arena to the system
+    void release()
+    {
+        std::vector<char*>::iterator end_blocks = blocks.end();
+        for (std::vector<char*>::iterator it = blocks.begin();
+             it != end_blocks; ++it)
+        {
+            ::operator delete(*it);
+        }
+        blocks.clear();
+        current = end = 0;
+        live = 0;
+        std::fill(free_lists, free_lists + free_list_count,
+            static_cast<free_node*>(0));
+    }
+
+    //  if none of the allocations is in use anymore, keep the first block
+    //  only and hand out the memory from its beginning again, returns
+    //  whether the arena was rewound
+    bool rewind()
+    {
+        if (0 != live)
+            return false;
+        if (!blocks.empty()) {
+            std::vector<char*>::iterator end_blocks = blocks.end();
+            for (std::vector<char*>::iterator it = blocks.begin() + 1;
+                 it != end_blocks; ++it)
+            {
+                ::operator delete(*it);
+            }
+            blocks.resize(1);
+            current = blocks.front();
+            end = current + block_size;
+        }
+        std::fill(free_lists, free_lists + free_list_count,
+            static_cast<free_node*>(0));
+        return true;
+    }
+
+    //  number of bytes currently held by this arena
+    std::size_t capacity() const { return blocks.size() * block_size; }
+
+    //  number of allocations currently in use
+    std::size_t in_use() const { return live; }
+
+    //  the arena installed for the current thread (if any)
+    static token_arena*& current_arena()
+    {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        static thread_local token_arena* arena = 0;
+#else
+        static token_arena* arena = 0;
+#endif
+        return arena;
+    }
+
+    //  Allocate 'size' bytes from the arena installed for the current thread.
+    //  If there is none, the memory is taken from the given singleton pool,
+    //  which must hand out blocks of 'size + header_size' bytes.
+    template <typename PoolT>
+    static void* allocate(std::size_t size)
+    {
+        token_arena* arena = current_arena();
+        void* p = (0 != arena) ? arena->do_allocate(size + header_size) : 0;
+        if (0 == p) {
+            arena = 0;
+            p = PoolT::malloc();
+            if (0 == p)
+                boost::throw_exception(std::bad_alloc());
+        }
+        *static_cast<token_arena**>(p) = arena;
+        return static_cast<char*>(p) + header_size;
+    }
+
+    template <typename PoolT>
+    static void deallocate(void* p, std::size_t size)
+    {
+        char* base = static_cast<char*>(p) - header_size;
+        token_arena* arena = *reinterpret_cast<token_arena**>(base);
+        if (0 != arena)
+            arena->do_deallocate(base, size + header_size);
+        else
+            PoolT::free(base);
+    }
+
+private:
+    struct free_node { free_node* next; };
+
+    BOOST_STATIC_CONSTANT(std::size_t, granularity = sizeof(free_node));
+    BOOST_STATIC_CONSTANT(std::size_t,
+        free_list_count = max_object_size / granularity + 1);
+
+    static std::size_t size_class(std::size_t size)
+    {
+        return (size + granularity - 1) / granularity;
+    }
+
+    void* do_allocate(std::size_t size)
+    {
+        if (size > max_object_size)
+            return 0;
+
+        std::size_t cls = size_class(size);
+        if (0 != free_lists[cls]) {
+            free_node* node = free_lists[cls];
+            free_lists[cls] = node->next;
+            ++live;
+            return node;
+        }
+
+        std::size_t bytes = cls * granularity;
+        if (std::size_t(end - current) < bytes) {
+            blocks.reserve(blocks.size() + 1);
+            current = static_cast<char*>(::operator new(block_size));
+            end = current + block_size;
+            blocks.push_back(current);
+        }
+
+        void* p = current;
+        current += bytes;
+        ++live;
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t size)
+    {
+        BOOST_ASSERT(0 != live);
+        --live;
+        std::size_t cls = size_class(size);
+        free_node* node = static_cast<free_node*>(p);
+        node->next = free_lists[cls];
+        free_lists[cls] = node;
+    }
+
+    std::size_t block_size;
+    char* current;                  // free space in the current block
+    char* end;
+    std::vector<char*> blocks;      // all blocks owned by this arena
+    std::size_t live;               // number of allocations in use
+    free_node* free_lists[free_list_count];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  token_arena_scope
+//
+//      Installs the given arena (which may be a null pointer) for the
+//      current thread during the lifetime of this object.
+//
+///////////////////////////////////////////////////////////////////////////////
+class token_arena_scope : private boost::noncopyable
+{
+public:
+    explicit token_arena_scope(token_arena* arena)
+    :   previous(token_arena::current_arena())
+    {
+        token_arena::current_arena() = arena;
+    }
+    ~token_arena_scope()
+    {
+        token_arena::current_arena() = previous;
+    }
+
+private:
+    token_arena* previous;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  token_allocator
+//
+//      Standard conforming (stateless) allocator used for the token
+//      sequences. Single objects are taken from the arena installed for the
+//      current thread, or from the pool used by boost::fast_pool_allocator
+//      otherwise.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class token_allocator
+{
+    BOOST_STATIC_ASSERT(
+        boost::alignment_of<T>::value <= token_arena::header_size);
+
+    typedef boost::singleton_pool<
+            boost::fast_pool_allocator_tag, sizeof(T) + token_arena::header_size
+        > pool_type;
+
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef T const* const_pointer;
+    typedef T& reference;
+    typedef T const& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind { typedef token_allocator<U> other; };
+
+    token_allocator() {}
+    template <typename U>
+    token_allocator(token_allocator<U> const&) {}
+
+    pointer allocate(size_type n, void const* = 0)
+    {
+        if (1 == n)
+            return static_cast<pointer>(token_arena::allocate<pool_type>(sizeof(T)));
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(pointer p, size_type n)
+    {
+        if (1 == n)
+            token_arena::deallocate<pool_type>(p, sizeof(T));
+        else
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(token_allocator const&, token_allocator const&)
+        { return true; }
+    friend bool operator!=(token_allocator const&, token_allocator const&)
+        { return false; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  token_sequence_allocator
+//
+//      The allocator of the token sequences holding tokens of the type
+//      TokenT. Token types allocating from the token_arena select the
+//      token_allocator by specializing this template.
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename TokenT>
+struct token_sequence_allocator
+{
+    typedef boost::fast_pool_allocator<TokenT> type;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+}   // namespace util
+}   // namespace wave
+}   // namespace boost
+
+// the suffix header occurs after all of the code
+#ifdef BOOST_HAS_ABI_HEADERS
+#include BOOST_ABI_SUFFIX
+#endif
+
+#endif // !defined(BOOST_WAVE_TOKEN_ARENA_HPP_9D1B3F6E_0C2A_4B8E_A6F4_5E7C1D2B3A90_INCLUDED)
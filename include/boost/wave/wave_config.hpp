@@ -91,6 +91,60 @@
 #define BOOST_WAVE_SUPPORT_INCLUDE_NEXT 1
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+//  Decide, whether to cache the results of the evaluated #if/#elif
+//  expressions. Configuration headers tend to evaluate the same (macro
+//  expanded) expressions over and over again.
+//
+//  To disable the cache, define the following constant as zero before
+//  including this file.
+//
+#if !defined(BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS)
+#define BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS 1
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//  Decide, whether to cache the results of the include file lookups. Every
+//  lookup tests the file name against all of the include directories, which
+//  needs several file system queries per directory.
+//
+//  To disable the cache, define the following constant as zero before
+//  including this file.
+//
+#if !defined(BOOST_WAVE_CACHE_INCLUDE_LOOKUPS)
+#define BOOST_WAVE_CACHE_INCLUDE_LOOKUPS 1
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//  Decide, whether to read the contents of the include directories once and
+//  to look up the include files in these snapshots instead of querying the
+//  file system for every candidate file.
+//
+//  The snapshots compare file names exactly, so they are disabled by default
+//  on systems with case insensitive file names. To change that, define the
+//  following constant as zero resp. non-zero before including this file.
+//
+#if !defined(BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES)
+#if defined(BOOST_WINDOWS) || defined(__APPLE__)
+#define BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES 0
+#else
+#define BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES 1
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//  Decide, whether to support header maps (see util/cpp_header_map.hpp), i.e.
+//  index files mapping the include file names to the files, which may be
+//  added to the include search paths. The header maps are memory mapped
+//  using Boost.Interprocess.
+//
+//  To disable the support for header maps, define the following constant as
+//  zero before including this file.
+//
+#if !defined(BOOST_WAVE_SUPPORT_HEADER_MAPS)
+#define BOOST_WAVE_SUPPORT_HEADER_MAPS 1
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Decide, whether to support C++11
 //
@@ -264,6 +318,20 @@
 #define BOOST_NO_MT 1
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+//  Decide, whether the reference counts of the token data and of the macro
+//  definitions need to be updated atomically. Tokens are copied very often
+//  during macro expansion, which makes the locked increments and decrements
+//  a measurable cost for single threaded applications.
+//
+//  If BOOST_WAVE_ATOMIC_REFCOUNT is not defined, it follows the
+//  BOOST_WAVE_SUPPORT_THREADING setting. Define it to zero to use plain
+//  integers even in a threaded build, which is safe as long as tokens and
+//  contexts are never shared between threads.
+#if !defined(BOOST_WAVE_ATOMIC_REFCOUNT)
+#define BOOST_WAVE_ATOMIC_REFCOUNT BOOST_WAVE_SUPPORT_THREADING
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //  Define the string type to be used to store the token values and the file
 //  names inside a file_position template class
@@ -285,15 +353,21 @@
 
 #else
 
-// use the following, if you have a fast std::allocator<char>
+// short token values (operators, keywords, most identifiers) are stored inline,
+// longer ones are shared between copies
 #define BOOST_WAVE_STRINGTYPE boost::wave::util::flex_string<                 \
         char, std::char_traits<char>, std::allocator<char>,                   \
-        boost::wave::util::CowString<                                         \
-            boost::wave::util::AllocatorStringStorage<char>                   \
-        >                                                                     \
+        boost::wave::util::SmallSharedStringStorage<char>                     \
     >                                                                         \
     /**/
 
+// Earlier versions of the library stored all token values in reference counted
+// heap blocks, define BOOST_WAVE_STRINGTYPE as
+//     boost::wave::util::flex_string<char, std::char_traits<char>,
+//         std::allocator<char>, boost::wave::util::CowString<
+//             boost::wave::util::AllocatorStringStorage<char> > >
+// to get this behavior back.
+
 //  This include is needed for the flex_string class used in the
 //  BOOST_WAVE_STRINGTYPE above.
 #include <boost/wave/util/flex_string.hpp>
@@ -301,6 +375,19 @@
 #endif // BOOST_WORKAROUND(__MWERKS__, < 0x3200) et.al.
 #endif // !defined(BOOST_WAVE_STRINGTYPE)
 
+///////////////////////////////////////////////////////////////////////////////
+//  Decide, which container type to use for the token sequences (macro
+//  definitions, macro arguments, pending tokens etc.). By default these are
+//  stored in the chunked_token_sequence container, which keeps the tokens in
+//  contiguous blocks. Define BOOST_WAVE_TOKEN_SEQUENCE_USE_LIST to 1 to use a
+//  std::list instead, as did earlier versions of the library.
+//
+//  Note: this setting has to be the same for the library and for the code
+//        using it.
+#if !defined(BOOST_WAVE_TOKEN_SEQUENCE_USE_LIST)
+#define BOOST_WAVE_TOKEN_SEQUENCE_USE_LIST 0
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //  The following definition forces the Spirit tree code to use list's instead
 //  of vectors, which may be more efficient on some platforms
@@ -23,6 +23,7 @@
 
 #include "lexertl_iterator.hpp"
 
+#include <boost/wave/util/chunked_token_sequence.hpp>
 #include <boost/wave/grammars/cpp_grammar.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,7 +37,7 @@
 
 typedef boost::wave::cpplexer::lex_token<> token_type;
 typedef boost::wave::cpplexer::lexertl::lex_iterator<token_type> lexer_type;
-typedef std::list<token_type, boost::fast_pool_allocator<token_type> > 
+typedef boost::wave::util::default_token_sequence<token_type>::type 
     token_sequence_type;
     
 template struct boost::wave::grammars::cpp_grammar_gen<lexer_type, token_sequence_type>;
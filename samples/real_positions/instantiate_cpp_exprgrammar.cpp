@@ -28,7 +28,7 @@
 //  
 //  Explicit instantiation of the expression_grammar_gen template with the 
 //  correct token type. This instantiates the corresponding parse function, 
-//  which in turn instantiates the expression_grammar object (see 
+//  which in turn instantiates the expression_evaluator (see 
 //  wave/grammars/cpp_expression_grammar.hpp)
 //
 ///////////////////////////////////////////////////////////////////////////////
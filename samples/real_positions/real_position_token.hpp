@@ -17,7 +17,7 @@
 #include <boost/wave/util/file_position.hpp>
 #include <boost/wave/token_ids.hpp>  
 #include <boost/wave/language_support.hpp>
-#include <boost/smart_ptr/detail/atomic_count.hpp>
+#include <boost/wave/util/refcount.hpp>
 #include <boost/optional.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -95,7 +95,7 @@ private:
     position_type pos;            // the original file position
     position_type corrected_pos;  // the original file position
     boost::optional<position_type> expand_pos;  // where this token was expanded
-    boost::detail::atomic_count refcnt;
+    boost::wave::util::refcount_type refcnt;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,7 @@
 #include <boost/wave/cpplexer/cpp_lex_token.hpp>
 #include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
 
+#include <boost/wave/util/chunked_token_sequence.hpp>
 #include <boost/wave/grammars/cpp_grammar.hpp>
 
 // this must occur after all of the includes and before any code appears
@@ -42,7 +43,7 @@ typedef boost::wave::cpplexer::lex_token<> token_type;
 
 // no need to change anything below
 typedef boost::wave::cpplexer::lex_iterator<token_type> lexer_type;
-typedef std::list<token_type, boost::fast_pool_allocator<token_type> >
+typedef boost::wave::util::default_token_sequence<token_type>::type
     token_sequence_type;
 
 template struct BOOST_SYMBOL_VISIBLE boost::wave::grammars::cpp_grammar_gen<lexer_type, token_sequence_type>;
@@ -0,0 +1,171 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Exercise the chunked container used for the token sequences by applying
+// the same (pseudo random) sequence of operations to it and to a std::list,
+// comparing the contents after every step. Sequences are kept short enough
+// for the operations to hit chunk boundaries frequently.
+
+#include <boost/wave/util/chunked_token_sequence.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <random>
+#include <string>
+#include <utility>
+
+using seq_t = boost::wave::util::chunked_token_sequence<
+    std::string, boost::wave::util::token_allocator<std::string> >;
+using list_t = std::list<std::string>;
+
+template <typename Container>
+typename Container::iterator nth(Container& c, std::size_t n)
+{
+    typename Container::iterator it = c.begin();
+    std::advance(it, n);
+    return it;
+}
+
+bool same(seq_t const& s, list_t const& l)
+{
+    return s.size() == l.size() &&
+        std::equal(l.begin(), l.end(), s.begin()) &&
+        std::equal(l.rbegin(), l.rend(), s.rbegin());
+}
+
+template <typename SeqIter, typename ListIter>
+bool same_position(seq_t const& s, SeqIter sit, list_t const& l, ListIter lit)
+{
+    if (lit == l.end())
+        return sit == s.end();
+    return sit != s.end() && *sit == *lit;
+}
+
+int main() {
+    std::mt19937 rng(4711);
+    int value = 0;
+
+    for (int round = 0; round != 50; ++round) {
+        seq_t s, other;
+        list_t l, other_l;
+
+        for (int step = 0; step != 500; ++step) {
+            std::string v = std::to_string(value++);
+            std::size_t pos = rng() % (l.size() + 1);
+
+            switch (rng() % 10) {
+            case 0:
+                s.push_back(v);
+                l.push_back(v);
+                break;
+
+            case 1:
+                s.push_front(v);
+                l.push_front(v);
+                break;
+
+            case 2:
+                if (!l.empty()) {
+                    s.pop_front();
+                    l.pop_front();
+                }
+                break;
+
+            case 3:
+                if (!l.empty()) {
+                    s.pop_back();
+                    l.pop_back();
+                }
+                break;
+
+            case 4:
+                {
+                    auto sit = s.insert(nth(s, pos), v);
+                    auto lit = l.insert(nth(l, pos), v);
+                    if (!same_position(s, sit, l, lit))
+                        return 1;
+                }
+                break;
+
+            case 5:
+                {
+                    std::size_t last = rng() % (l.size() + 1);
+                    if (pos > last)
+                        std::swap(pos, last);
+                    auto sit = s.erase(nth(s, pos), nth(s, last));
+                    auto lit = l.erase(nth(l, pos), nth(l, last));
+                    if (!same_position(s, sit, l, lit))
+                        return 2;
+                }
+                break;
+
+            case 6:
+                // splicing a whole sequence keeps iterators to its elements
+                for (int i = rng() % 20; i != 0; --i) {
+                    other.push_back(std::to_string(value));
+                    other_l.push_back(std::to_string(value++));
+                }
+                if (!other.empty()) {
+                    auto first = other.begin();
+                    std::string front = *first;
+                    s.splice(nth(s, pos), other);
+                    l.splice(nth(l, pos), other_l);
+                    if (*first != front || !other.empty())
+                        return 3;
+                }
+                break;
+
+            case 7:
+                {
+                    std::size_t last = rng() % (l.size() + 1);
+                    if (pos > last)
+                        std::swap(pos, last);
+                    std::size_t target = rng() % (other_l.size() + 1);
+                    std::size_t moved = last - pos;
+                    seq_t::iterator front, back;
+                    if (0 != moved) {
+                        front = nth(s, pos);
+                        back = nth(s, last - 1);
+                    }
+                    other.splice(nth(other, target), s, nth(s, pos), nth(s, last));
+                    other_l.splice(nth(other_l, target), l, nth(l, pos), nth(l, last));
+
+                    // splicing a range keeps iterators to its elements
+                    if (0 != moved && (front != nth(other, target) ||
+                        back != nth(other, target + moved - 1)))
+                    {
+                        return 6;
+                    }
+                }
+                break;
+
+            case 8:
+                {
+                    seq_t copy(s);
+                    seq_t moved(std::move(copy));
+                    if (!copy.empty() || !same(moved, l))
+                        return 4;
+                    other.swap(moved);
+                    other_l = l;
+                }
+                break;
+
+            case 9:
+                if (rng() % 10 == 0) {
+                    s.clear();
+                    l.clear();
+                }
+                break;
+            }
+
+            if (!same(s, l) || !same(other, other_l))
+                return 5;
+        }
+    }
+    return 0;
+}
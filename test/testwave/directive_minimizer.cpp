@@ -0,0 +1,232 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the reduction of the source files to their directives: the
+// directives are kept verbatim and the line numbers are preserved, and
+// scanning the files of the testwave corpus (given as the argument) for
+// their dependencies gives the same results with and without the
+// load_minimized_file_to_string input policy.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+#include <boost/wave/util/cpp_directive_minimizer.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+
+// record the names of the opened include files
+struct dependency_hooks
+:   boost::wave::context_policies::eat_whitespace<token_t>
+{
+    explicit dependency_hooks(std::string* names_)
+    :   names(names_)
+    {}
+
+    template <typename ContextT>
+    void opened_include_file(ContextT const&, std::string const&,
+        std::string const& absname, bool)
+    {
+        *names += absname;
+        *names += '\n';
+    }
+
+    std::string* names;
+};
+
+static bool check(std::string const& text, std::string const& expected,
+    bool raw_strings = true)
+{
+    std::string result;
+    boost::wave::util::minimize_directives(text, result, raw_strings);
+    if (result != expected) {
+        std::cerr << "minimizing:\n" << text << "\ngives:\n" << result
+                  << "\ninstead of:\n" << expected << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// scan the given file for its dependencies, returns the opened files, the
+// errors (with their line numbers) and the resulting macro definitions
+template <typename InputPolicyT>
+static std::string scan(std::string const& name, std::string const& content,
+    fs::path const& dir, bool minimize,
+    boost::wave::shared_resources* resources = 0)
+{
+    using ctx_t = boost::wave::context<std::string::iterator, lex_iter_t,
+        InputPolicyT, dependency_hooks>;
+
+    boost::wave::language_support const language(
+        boost::wave::enable_scan_dependencies(boost::wave::language_support(
+            boost::wave::support_cpp20 |
+            boost::wave::support_option_long_long |
+            boost::wave::support_option_convert_trigraphs |
+            boost::wave::support_option_include_guard_detection)));
+
+    std::string text(minimize ?
+        boost::wave::util::minimize_directives(content, language) : content);
+    std::string result;
+    ctx_t ctx(text.begin(), text.end(), name.c_str(),
+        dependency_hooks(&result));
+    ctx.set_language(language);
+    ctx.add_sysinclude_path(dir.string().c_str());
+    ctx.add_include_path(dir.string().c_str());
+    ctx.set_shared_resources(resources);
+
+    auto it = ctx.begin();
+    for (;;) {
+        try {
+            if (it == ctx.end())
+                break;
+            ++it;
+        }
+        catch (boost::wave::cpp_exception const& e) {
+            std::ostringstream error;
+            error << "error(" << e.line_no() << "): " << e.description()
+                  << '\n';
+            result += error.str();
+            if (!e.is_recoverable())
+                break;
+        }
+        catch (std::exception const& e) {
+            result += "exception: ";
+            result += e.what();
+            break;
+        }
+    }
+
+    for (auto name_it = ctx.macro_names_begin();
+         name_it != ctx.macro_names_end(); ++name_it)
+    {
+        bool has_params = false;
+        bool is_predefined = false;
+        typename ctx_t::position_type pos;
+        std::vector<token_t> parameters;
+        typename ctx_t::token_sequence_type definition;
+        ctx.get_macro_definition(*name_it, has_params, is_predefined, pos,
+            parameters, definition);
+        if (is_predefined)
+            continue;
+
+        result += name_it->c_str();
+        result += has_params ? "(" : " ";
+        for (token_t const& parameter : parameters) {
+            result += parameter.get_value().c_str();
+            result += ',';
+        }
+        result += " = ";
+        for (token_t const& token : definition)
+            result += token.get_value().c_str();
+        result += '\n';
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "usage: directive_minimizer <testwave testfiles directory>"
+                  << std::endl;
+        return 1;
+    }
+
+    // directives are kept, everything else is replaced by its newlines
+    if (!check("int a;\n  # define A 1 /* one */\nint b; # not\n",
+            "\n# define A 1 /* one */\n\n") ||
+        !check("#define B \\\n  2\nx \\\n# no\n%:if 1\n?\?=endif",
+            "#define B \\\n  2\n\n\n%:if 1\n?\?=endif") ||
+        !check("/* license\n */\n/* a */ #include \"a.h\"\r\nend\r",
+            "\n\n#include \"a.h\"\r\n\n") ||
+        !check("#define C /* spanning\n lines */ 3\n// #no\n",
+            "#define C /* spanning\n lines */ 3\n\n") ||
+        !check("x;\nx /* unterminated\n#no\n", "\n/* unterminated\n#no\n"))
+    {
+        return 2;
+    }
+
+    // comments and literals hide the directives
+    if (!check("/* #no\n #no */ #yes\nx /* a\n */ #yes\nx /* */ #no\n",
+            "\n#yes\n\n#yes\n\n") ||
+        !check("s = \"/*\";\n#yes\nc = '\"'; /* */\n#yes\n",
+            "\n#yes\n\n#yes\n") ||
+        !check("don't /* \n#no */\n#yes\n", "\n\n#yes\n") ||
+        !check("n = 1'000; /*\n#no */\n#yes\n", "\n\n#yes\n") ||
+        !check("// line \\\n#no\n#yes\n", "\n\n#yes\n"))
+    {
+        return 3;
+    }
+
+    // raw string literals span several lines in C++11 and newer only
+    if (!check("s = R\"x(\n#no\n)\";\n)x\";\n#yes\n", "\n\n\n\n#yes\n") ||
+        !check("s = u8R\"(\n#no)\";\n#yes\n", "\n\n#yes\n") ||
+        !check("s = R\"(\n#yes\n", "\n#yes\n", false) ||
+        !check("#define R \"(\n#yes\n)\"\n", "#define R \"(\n#yes\n\n"))
+    {
+        return 4;
+    }
+
+    // scanning the corpus gives the same results for the minimized files
+    fs::path dir(fs::canonical(argv[1]));
+    std::vector<fs::path> files;
+    for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it)
+    {
+        if (it->path().extension() == ".cpp")
+            files.push_back(it->path());
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cerr << "no test files found in " << dir << std::endl;
+        return 5;
+    }
+
+    // the minimized files are made once, if cached
+    boost::wave::shared_resources resources;
+    int mismatches = 0;
+    for (fs::path const& file : files) {
+        fs::ifstream in(file);
+        std::string content((std::istreambuf_iterator<char>(in.rdbuf())),
+            std::istreambuf_iterator<char>());
+
+        std::string expected(scan<
+                boost::wave::iteration_context_policies::load_file_to_string>(
+            file.string(), content, dir, false));
+        for (int i = 0; i < 2; ++i) {
+            std::string result(scan<
+                    boost::wave::iteration_context_policies::
+                        load_minimized_file_to_string>(
+                file.string(), content, dir, true, &resources));
+            if (result != expected) {
+                std::cerr << "different results for " << file << ":\n"
+                          << expected << "\nminimized:\n" << result
+                          << std::endl;
+                ++mismatches;
+            }
+        }
+    }
+    if (0 != mismatches)
+        return 6;
+    if (0 == resources.minimized_size() ||
+        resources.get_minimized_misses() != resources.minimized_size() ||
+        0 == resources.get_minimized_hits())
+    {
+        return 7;
+    }
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the directives only mode (support_option_directives_only): the
+// #include directives and the conditionals are evaluated, the macro
+// definitions are passed through and the text is returned without expanding
+// any macros. The output starts with the macros (un)defined on the command
+// line. Preprocessing the result once more gives the same tokens as
+// preprocessing the input in the normal mode.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <iostream>
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string>;
+
+// preprocess the given text, returns the generated text and (separated by
+// spaces) the significant tokens, optionally the macros are (un)defined as on
+// the command line
+static std::string preprocess(std::string text, fs::path const& root,
+    bool directives_only, std::string* significant = 0,
+    bool command_line = false)
+{
+    std::string main_file = (root / "main.cpp").string();
+    ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+    ctx.set_language(boost::wave::enable_directives_only(
+        boost::wave::language_support(
+            boost::wave::support_cpp20 |
+            boost::wave::support_option_include_guard_detection |
+            boost::wave::support_option_emit_pragma_directives),
+        directives_only));
+    ctx.add_include_path(root.string().c_str());
+    if (command_line) {
+        ctx.add_macro_definition(std::string("SCALE=7"));
+        ctx.add_macro_definition(std::string("G(x, y)=(x * y)"), true);
+        ctx.add_macro_definition(std::string("EMPTY="));
+        ctx.add_macro_definition(std::string("DROPPED"));
+        ctx.remove_macro_definition(std::string("DROPPED"));
+        ctx.remove_macro_definition(std::string("UNKNOWN"));
+    }
+
+    std::string result;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        result += it->get_value().c_str();
+        if (0 != significant &&
+            !IS_CATEGORY(*it, boost::wave::WhiteSpaceTokenType) &&
+            !IS_CATEGORY(*it, boost::wave::EOLTokenType) &&
+            !IS_CATEGORY(*it, boost::wave::EOFTokenType))
+        {
+            *significant += it->get_value().c_str();
+            *significant += ' ';
+        }
+    }
+    return result;
+}
+
+int main()
+{
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    write_file(root / "config.h",
+        "#ifndef CONFIG_H\n#define CONFIG_H\n"
+        "#define VALUE 42\nint config = VALUE;\n#endif\n");
+
+    std::string const text(
+        "#include \"config.h\"\n"
+        "#define F(x) (x + 1)\n"
+        "int a = F(VALUE);\n"
+        "#if VALUE == 42\n"
+        "int b = F(2);\n"
+        "#else\n"
+        "int c;\n"
+        "#endif\n"
+        "#pragma unknown\n"
+        "#undef F\n"
+        "#define F 3\n"
+        "int d = F;\n");
+
+    // the macros are defined as usual but not expanded, the definitions are
+    // part of the output
+    int result = 0;
+    std::string const expected(
+        "#define CONFIG_H\n"
+        "#define VALUE 42\n"
+        "int config = VALUE;\n"
+        "#define F(x) (x + 1)\n"
+        "int a = F(VALUE);\n"
+        "int b = F(2);\n"
+        "#pragma unknown\n"
+        "#undef F\n"
+        "#define F 3\n"
+        "int d = F;\n");
+    std::string const output(preprocess(text, root, true));
+    if (output != expected) {
+        std::cerr << "unexpected output:\n" << output << std::endl;
+        result = 1;
+    }
+
+    // the compiler finishes the job
+    std::string tokens;
+    std::string finished;
+    preprocess(text, root, false, &tokens);
+    preprocess(output, root, false, &finished);
+    if (0 == result && tokens != finished) {
+        std::cerr << "different tokens:\n" << tokens << "\n" << finished
+                  << std::endl;
+        result = 2;
+    }
+
+    // the output starts with the macros (un)defined on the command line
+    std::string const used(
+        "#if defined(DROPPED) || defined(UNKNOWN)\n"
+        "#error undefined\n"
+        "#endif\n"
+        "int e = G(SCALE, 2) EMPTY;\n");
+    std::string const used_output(preprocess(used, root, true, 0, true));
+    if (0 == result && used_output !=
+            "#undef DROPPED\n"
+            "#undef UNKNOWN\n"
+            "#define EMPTY\n"
+            "#define G(x,y) (x * y)\n"
+            "#define SCALE 7\n"
+            "int e = G(SCALE, 2) EMPTY;\n")
+    {
+        std::cerr << "unexpected output:\n" << used_output << std::endl;
+        result = 3;
+    }
+
+    std::string used_tokens;
+    std::string used_finished;
+    preprocess(used, root, false, &used_tokens, true);
+    preprocess(used_output, root, false, &used_finished);
+    if (0 == result && used_tokens != used_finished) {
+        std::cerr << "different tokens:\n" << used_tokens << "\n"
+                  << used_finished << std::endl;
+        result = 4;
+    }
+
+    return result;
+}
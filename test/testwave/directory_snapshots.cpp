@@ -0,0 +1,131 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the snapshots of the include directory contents: files and files
+// in subdirectories are found, directories and missing files aren't, every
+// directory is read once and only if needed, symbolic links and '..' are
+// left to the file system, and a context finds the same include files with
+// and without the snapshots.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+#include <boost/wave/util/cpp_directory_snapshots.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    boost::wave::context_policies::eat_whitespace<token_t> >;
+
+int main()
+{
+    using boost::wave::util::directory_snapshots;
+
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    fs::create_directories(root / "inc" / "sub" / "deeper");
+    fs::create_directories(root / "other");
+    write_file(root / "inc" / "a.h", "a\n");
+    write_file(root / "inc" / "sub" / "b.h", "b\n");
+    write_file(root / "inc" / "sub" / "deeper" / "c.h", "c\n");
+    write_file(root / "other" / "d.h", "d\n");
+
+    bool have_symlink = true;
+    boost::system::error_code ec;
+    fs::create_symlink(root / "other" / "d.h", root / "inc" / "link.h", ec);
+    if (ec)
+        have_symlink = false;
+
+    int result = 0;
+    fs::path inc = root / "inc";
+
+    {
+        directory_snapshots snapshots;
+
+        if (snapshots.lookup(inc, "a.h") != directory_snapshots::file_present ||
+            snapshots.lookup(inc, "sub/b.h") != directory_snapshots::file_present ||
+            snapshots.lookup(inc, "sub/deeper/c.h") != directory_snapshots::file_present ||
+            snapshots.lookup(inc, "b.h") != directory_snapshots::file_absent ||
+            snapshots.lookup(inc, "sub") != directory_snapshots::file_absent ||
+            snapshots.lookup(inc, "a.h/x.h") != directory_snapshots::file_absent ||
+            snapshots.lookup(inc, "missing/x.h") != directory_snapshots::file_absent ||
+            snapshots.lookup(inc, "../other/d.h") != directory_snapshots::file_unknown ||
+            snapshots.lookup(root / "missing", "a.h") != directory_snapshots::file_unknown)
+        {
+            result = 1;
+        }
+        else if (have_symlink &&
+            snapshots.lookup(inc, "link.h") != directory_snapshots::file_unknown)
+        {
+            result = 2;
+        }
+
+        // inc, inc/sub and inc/sub/deeper were read (once), 'other' wasn't
+        // touched and the missing directory couldn't be read
+        if (0 == result && snapshots.size() != 4)
+            result = 3;
+    }
+
+    std::string const source =
+        "#include <a.h>\n"
+        "#include <sub/b.h>\n"
+        "#include \"sub/deeper/c.h\"\n"
+        "#include <../other/d.h>\n"
+        "#if __has_include(<sub/missing.h>)\n"
+        "missing\n"
+        "#endif\n";
+    std::string const main_file = (root / "main.cpp").string();
+
+    for (int enabled = 0; enabled != 2 && 0 == result; ++enabled) {
+        std::string text(source);
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.set_language(boost::wave::support_cpp17);
+        ctx.add_sysinclude_path(inc.string().c_str());
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+        ctx.get_directory_snapshots().enable(enabled != 0);
+#endif
+
+        if (preprocess(ctx) != "abcd")
+            result = 4;
+    }
+
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+    if (0 == result) {
+        // a file created after the directory was read isn't seen, unless the
+        // snapshots are cleared
+        std::string text;
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.add_sysinclude_path(inc.string().c_str());
+        ctx.get_include_lookup_cache().enable(false);
+
+        std::string name("new.h");
+        std::string dir;
+        bool found_early = ctx.find_include_file(name, dir, true, 0);
+        write_file(inc / "new.h", "new\n");
+        name = "new.h";
+        bool found_stale = ctx.find_include_file(name, dir, true, 0);
+        ctx.get_directory_snapshots().clear();
+        name = "new.h";
+        bool found_late = ctx.find_include_file(name, dir, true, 0);
+
+        if (found_early || found_stale || !found_late)
+            result = 5;
+    }
+#endif
+
+    return result;
+}
@@ -0,0 +1,139 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the cache of evaluated #if/#elif expressions: repeated expressions
+// are answered from the cache, the evaluated_conditional_expression hook
+// is called for every directive nevertheless, a hook requesting the
+// re-evaluation of an expression disables the cache, and ill formed
+// expressions are reported in active blocks even if the same expression
+// was seen in a skipped block before.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <string>
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+
+struct counting_hooks
+:   boost::wave::context_policies::eat_whitespace<token_t>
+{
+    counting_hooks() : calls(0), reevaluate(0) {}
+
+    template <typename ContextT, typename TokenT, typename ContainerT>
+    bool evaluated_conditional_expression(ContextT const&,
+        TokenT const&, ContainerT const&, bool)
+    {
+        ++calls;
+        if (reevaluate == 0)
+            return false;
+        --reevaluate;
+        return true;
+    }
+
+    int calls;
+    int reevaluate;     // number of re-evaluations to request
+};
+
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    counting_hooks>;
+
+static std::string const repeated =
+    "#define A 3\n"
+    "#define B A\n"
+    "#if defined(A) && A > 2\n"
+    "one\n"
+    "#endif\n"
+    "#if defined(A) && A > 2\n"
+    "two\n"
+    "#endif\n"
+    "#if defined(B) && B > 2\n"       // expands to the same expression
+    "three\n"
+    "#endif\n"
+    "#if A == 4\n"
+    "#elif defined(A) && A > 2\n"
+    "four\n"
+    "#endif\n";
+
+std::string preprocess(ctx_t& ctx)
+{
+    std::string result;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        if (boost::wave::T_IDENTIFIER == boost::wave::token_id(*it))
+            result += it->get_value().c_str();
+    }
+    return result;
+}
+
+int main()
+{
+    using boost::wave::util::conditional_expression_cache;
+
+    {
+        std::string text(repeated);
+        ctx_t ctx(text.begin(), text.end(), "repeated.cpp");
+
+        if (preprocess(ctx) != "onetwothreefour")
+            return 1;
+
+        conditional_expression_cache const& cache =
+            ctx.get_conditional_expression_cache();
+
+        // "1 && 3 > 2" is evaluated once in an active block and once for the
+        // #elif following a false #if, "3 == 4" is evaluated once
+        if (ctx.get_hooks().calls != 5 || cache.get_hits() != 2 ||
+            cache.get_misses() != 3 || cache.size() != 3 || !cache.is_enabled())
+        {
+            return 2;
+        }
+    }
+
+    {
+        std::string text(repeated);
+        ctx_t ctx(text.begin(), text.end(), "reevaluate.cpp");
+        ctx.get_hooks().reevaluate = 1;
+
+        if (preprocess(ctx) != "onetwothreefour")
+            return 3;
+
+        // the first expression is evaluated twice, then the cache is off
+        conditional_expression_cache const& cache =
+            ctx.get_conditional_expression_cache();
+        if (ctx.get_hooks().calls != 6 || cache.get_hits() != 0 ||
+            cache.get_misses() != 1 || cache.is_enabled())
+        {
+            return 4;
+        }
+    }
+
+    {
+        std::string text(
+            "#if 0\n"
+            "#if 1 +\n"
+            "#endif\n"
+            "#endif\n"
+            "#if 1 +\n"
+            "#endif\n");
+        ctx_t ctx(text.begin(), text.end(), "illformed.cpp");
+
+        bool reported = false;
+        try {
+            preprocess(ctx);
+        }
+        catch (boost::wave::preprocess_exception const& e) {
+            reported = (boost::wave::preprocess_exception::ill_formed_expression ==
+                e.get_errorcode());
+        }
+        if (!reported)
+            return 5;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the header maps: a written map finds all of its entries (including
+// colliding ones) and nothing else, invalid files are rejected, and a context
+// resolves include files through a header map before the directories
+// following it in the search path, falling back to these for names missing
+// from the map or mapped to files which don't exist. An #include_next in a
+// mapped file continues the search after the map.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+#include <boost/wave/util/cpp_header_map.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <sstream>
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    boost::wave::context_policies::eat_whitespace<token_t> >;
+
+int main()
+{
+    using boost::wave::util::header_map;
+    using boost::wave::util::header_map_builder;
+
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    fs::create_directories(root / "inc");
+    fs::create_directories(root / "elsewhere" / "deep");
+    write_file(root / "elsewhere" / "deep" / "mapped.h", "mapped\n");
+    write_file(root / "inc" / "plain.h", "plain\n");
+    write_file(root / "inc" / "stale.h", "stale\n");
+    write_file(root / "inc" / "mapped.h", "shadowed\n");
+
+    int result = 0;
+
+    {
+        // many entries, so that some of them share their initial bucket
+        header_map_builder builder;
+        for (int i = 0; i < 1000; ++i) {
+            std::ostringstream name, path;
+            name << "dir" << i % 7 << "/file" << i << ".h";
+            path << "/path/to/file" << i << ".h";
+            builder.add(name.str(), path.str());
+        }
+        if (builder.add("dir0/file0.h", "/other") || builder.size() != 1000)
+            result = 1;
+
+        std::string file = (root / "many.hmap").string();
+        header_map map;
+        if (0 == result && (!builder.write(file) || !map.load(file) ||
+            map.size() != 1000))
+        {
+            result = 2;
+        }
+
+        for (int i = 0; i < 1000 && 0 == result; ++i) {
+            std::ostringstream name, path;
+            name << "dir" << i % 7 << "/file" << i << ".h";
+            path << "/path/to/file" << i << ".h";
+            std::string found;
+            if (!map.find(name.str(), found) || found != path.str())
+                result = 3;
+        }
+
+        std::string found;
+        if (0 == result && (map.find("dir1/file0.h", found) ||
+            map.find("file0.h", found) || map.find("", found)))
+        {
+            result = 4;
+        }
+    }
+
+    if (0 == result) {
+        // files which aren't header maps, or which are truncated, are rejected
+        header_map_builder builder;
+        builder.add("a.h", "/a.h");
+        std::string file = (root / "truncated.hmap").string();
+        builder.write(file);
+        fs::resize_file(file, fs::file_size(file) - 2);
+
+        header_map map;
+        if (map.load((root / "inc" / "plain.h").string()) ||
+            map.load((root / "missing.hmap").string()) || map.load(file) ||
+            map.is_loaded())
+        {
+            result = 5;
+        }
+    }
+
+    if (0 == result) {
+        header_map_builder builder;
+        builder.add("proj/mapped.h",
+            (root / "elsewhere" / "deep" / "mapped.h").string());
+        builder.add("stale.h", (root / "elsewhere" / "stale.h").string());
+        std::string file = (root / "proj.hmap").string();
+        builder.write(file);
+
+        std::string text(
+            "#include <proj/mapped.h>\n"
+            "#include <plain.h>\n"
+            "#include <stale.h>\n"
+            "#if __has_include(<proj/missing.h>)\n"
+            "missing\n"
+            "#endif\n");
+        std::string main_file = (root / "main.cpp").string();
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.set_language(boost::wave::support_cpp17);
+        if (ctx.add_header_map((root / "inc" / "plain.h").string().c_str()) ||
+            !ctx.add_header_map(file.c_str(), true))
+        {
+            result = 6;
+        }
+        ctx.add_sysinclude_path((root / "inc").string().c_str());
+
+        if (0 == result && preprocess(ctx) != "mappedplainstale")
+            result = 7;
+    }
+
+    if (0 == result) {
+        // #include_next in a file found through the map continues with the
+        // entries following the map
+        write_file(root / "elsewhere" / "deep" / "next.h",
+            "mapped_next\n#include_next <next.h>\n");
+        write_file(root / "inc" / "next.h", "plain_next\n");
+
+        header_map_builder builder;
+        builder.add("next.h",
+            (root / "elsewhere" / "deep" / "next.h").string());
+        std::string file = (root / "next.hmap").string();
+        builder.write(file);
+
+        std::string text("#include <next.h>\n");
+        std::string main_file = (root / "main.cpp").string();
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.add_header_map(file.c_str(), true);
+        ctx.add_sysinclude_path((root / "inc").string().c_str());
+
+        try {
+            if (preprocess(ctx) != "mapped_nextplain_next")
+                result = 8;
+        }
+        catch (boost::wave::preprocess_exception const&) {
+            result = 9;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,135 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the persistent database of include file lookups: a later run reuses
+// the stored lookups without searching, a change to a directory the lookup
+// depends on drops it, different include search lists are kept apart and a
+// corrupt database file is rejected.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <ctime>
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    boost::wave::context_policies::eat_whitespace<token_t> >;
+
+// preprocess an #include <a.h> using the given database and search list
+static std::string run(boost::wave::util::include_database& db,
+    fs::path const& root, bool both_dirs)
+{
+    std::string text("#include <a.h>\n");
+    std::string main_file = (root / "main.cpp").string();
+    ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+    if (both_dirs)
+        ctx.add_sysinclude_path((root / "first").string().c_str());
+    ctx.add_sysinclude_path((root / "second").string().c_str());
+    ctx.set_include_database(&db);
+
+    std::string result;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        if (boost::wave::T_IDENTIFIER == boost::wave::token_id(*it))
+            result += it->get_value().c_str();
+    }
+    return result;
+}
+
+int main()
+{
+    using boost::wave::util::include_database;
+
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    fs::create_directories(root / "first");
+    fs::create_directories(root / "second");
+    write_file(root / "second" / "a.h", "a\n");
+
+    // directories modified in the second the database is written aren't
+    // trusted, so move them into the past
+    std::time_t past = std::time(0) - 100;
+    fs::last_write_time(root / "first", past);
+    fs::last_write_time(root / "second", past);
+
+    std::string const file = (root / "includes.db").string();
+    int result = 0;
+
+    {
+        include_database db;
+        if (!db.load(file) || run(db, root, true) != "a" ||
+            db.get_hits() != 0 || db.get_misses() != 1 || db.size() != 1 ||
+            !db.save())
+        {
+            result = 1;
+        }
+    }
+
+    if (0 == result) {
+        include_database db;
+        if (!db.load(file) || run(db, root, true) != "a" ||
+            db.get_hits() != 1 || db.get_misses() != 0 ||
+            db.get_invalidated() != 0)
+        {
+            result = 2;
+        }
+    }
+
+    if (0 == result) {
+        // a file shadowing the one found before changes the directory
+        write_file(root / "first" / "a.h", "b\n");
+        fs::last_write_time(root / "first", past + 10);
+
+        include_database db;
+        if (!db.load(file) || run(db, root, true) != "b" ||
+            db.get_hits() != 0 || db.get_invalidated() != 1 || !db.save())
+        {
+            result = 3;
+        }
+    }
+
+    if (0 == result) {
+        // another search list is stored separately
+        include_database db;
+        if (!db.load(file) || run(db, root, false) != "a" ||
+            db.get_hits() != 0 || !db.save())
+        {
+            result = 4;
+        }
+
+        include_database reloaded;
+        if (0 == result && (!reloaded.load(file) ||
+            reloaded.get_configurations() != 2 ||
+            run(reloaded, root, true) != "b" || reloaded.get_hits() != 1))
+        {
+            result = 5;
+        }
+    }
+
+    if (0 == result) {
+        write_file(root / "includes.db", "WIDB garbage");
+
+        include_database db;
+        if (db.load(file) || db.get_configurations() != 0 ||
+            run(db, root, true) != "b" || db.get_misses() != 1)
+        {
+            result = 6;
+        }
+    }
+
+    return result;
+}
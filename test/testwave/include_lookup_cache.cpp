@@ -0,0 +1,116 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the cache of include file lookups: repeated #include directives and
+// __has_include expressions are answered from the cache, files not found in
+// an include directory are remembered, adding an include path invalidates
+// the cached lookups and a disabled cache isn't used at all.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    boost::wave::context_policies::eat_whitespace<token_t> >;
+
+int main()
+{
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    fs::create_directories(root / "first");
+    fs::create_directories(root / "second");
+    write_file(root / "second" / "a.h", "a\n");
+    write_file(root / "late.h", "late\n");
+
+    int result = 0;
+    std::string const source =
+        "#include <a.h>\n"
+        "#include <a.h>\n"
+        "#if __has_include(<missing.h>)\n"
+        "missing\n"
+        "#endif\n"
+        "#if __has_include(<missing.h>) || __has_include(<a.h>)\n"
+        "found\n"
+        "#endif\n";
+    std::string const main_file = (root / "main.cpp").string();
+
+    {
+        std::string text(source);
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.set_language(boost::wave::support_cpp17);
+        ctx.add_sysinclude_path((root / "first").string().c_str());
+        ctx.add_sysinclude_path((root / "second").string().c_str());
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+        ctx.get_directory_snapshots().enable(false);     // test the probes
+#endif
+
+        if (preprocess(ctx) != "aafound") {
+            result = 1;
+        }
+        else {
+            boost::wave::util::include_lookup_cache const& cache =
+                ctx.get_include_lookup_cache();
+
+            // two distinct lookups (a.h and missing.h), all others are hits;
+            // the probes remember that neither file is in 'first'
+            if (cache.get_hits() != 3 || cache.get_misses() != 2 ||
+                cache.size() != 2 || cache.probes_size() != 4 ||
+                cache.get_negative_probes() != 3)
+            {
+                result = 2;
+            }
+        }
+    }
+
+    {
+        // a file not found before is found after adding its directory
+        std::string text("#if __has_include(<late.h>)\nearly\n#endif\n");
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.set_language(boost::wave::support_cpp17);
+        ctx.add_sysinclude_path((root / "second").string().c_str());
+
+        std::string name("late.h");
+        std::string dir;
+        bool found_early = ctx.find_include_file(name, dir, true, 0);
+        ctx.add_sysinclude_path(root.string().c_str());
+        name = "late.h";
+        bool found_late = ctx.find_include_file(name, dir, true, 0);
+
+        if (found_early || !found_late)
+            result = 3;
+    }
+
+    {
+        std::string text(source);
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.set_language(boost::wave::support_cpp17);
+        ctx.add_sysinclude_path((root / "second").string().c_str());
+        ctx.get_include_lookup_cache().enable(false);
+
+        boost::wave::util::include_lookup_cache const& cache =
+            ctx.get_include_lookup_cache();
+        if (preprocess(ctx) != "aafound" || cache.get_hits() != 0 ||
+            cache.get_misses() != 0 || cache.size() != 0)
+        {
+            result = 4;
+        }
+    }
+
+    return result;
+}
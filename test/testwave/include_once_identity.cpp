@@ -0,0 +1,101 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify that files containing a #pragma once or include guards are
+// recognized by their identity: reaching such a file again through a
+// symbolic link, a hard link or a different spelling of its path doesn't
+// include it a second time, while #undef'ing the guard still does.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+#include <boost/wave/util/cpp_file_identity.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    boost::wave::context_policies::eat_whitespace<token_t> >;
+
+int main()
+{
+    using boost::wave::util::get_file_identity;
+
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    fs::path inc = root / "inc";
+    fs::create_directories(inc / "sub");
+    write_file(inc / "once.h", "#pragma once\nonce\n");
+    write_file(inc / "guarded.h",
+        "#ifndef GUARDED_H\n#define GUARDED_H\nguarded\n#endif\n");
+
+    bool have_links = true;
+    boost::system::error_code ec;
+    fs::create_symlink(inc / "once.h", inc / "alias.h", ec);
+    if (!ec)
+        fs::create_hard_link(inc / "guarded.h", inc / "hard.h", ec);
+    if (ec)
+        have_links = false;
+
+    int result = 0;
+
+    // a file has the same identity under all of its names, different files
+    // have different identities
+    if (get_file_identity((inc / "once.h").string()) ==
+        get_file_identity((inc / "guarded.h").string()))
+    {
+        result = 1;
+    }
+    if (have_links && get_file_identity((inc / "alias.h").string()) !=
+        get_file_identity((inc / "once.h").string()))
+    {
+        result = 2;
+    }
+
+    std::string const main_file = (root / "main.cpp").string();
+    if (0 == result) {
+        std::string text(
+            "#include <once.h>\n"
+            "#include <sub/../once.h>\n"
+            "#include <guarded.h>\n"
+            "#include <sub/../guarded.h>\n");
+        if (have_links) {
+            text +=
+                "#include <alias.h>\n"
+                "#include <hard.h>\n";
+        }
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.add_sysinclude_path(inc.string().c_str());
+
+        if (preprocess(ctx) != "onceguarded")
+            result = 3;
+    }
+
+    if (0 == result) {
+        // removing the include guard makes the file includable again
+        std::string text(
+            "#include <guarded.h>\n"
+            "#undef GUARDED_H\n"
+            "#include <sub/../guarded.h>\n");
+        ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+        ctx.add_sysinclude_path(inc.string().c_str());
+
+        if (preprocess(ctx) != "guardedguarded")
+            result = 4;
+    }
+
+    return result;
+}
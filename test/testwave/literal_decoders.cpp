@@ -0,0 +1,195 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the decoders for the integer and character literals used in
+// #if/#elif expressions: all bases, digit separators, suffixes, the exact
+// detection of overflowing values, escape sequences, encoding prefixes and
+// the rejection of ill formed literals.
+
+#include <boost/wave/grammars/cpp_literal_decoders.hpp>
+
+#include <climits>
+#include <limits>
+#include <string>
+
+using boost::wave::uint_literal_type;
+using boost::wave::int_literal_type;
+using boost::wave::grammars::impl::decode_intlit;
+using boost::wave::grammars::impl::decode_chlit;
+
+static int failures = 0;
+
+static void check_int(std::string const& lit, uint_literal_type expected,
+    bool expected_unsigned)
+{
+    uint_literal_type value = 0;
+    bool is_unsigned = false;
+    if (!decode_intlit(lit.begin(), lit.end(), value, is_unsigned) ||
+        value != expected || is_unsigned != expected_unsigned)
+    {
+        ++failures;
+    }
+}
+
+static void check_int_error(std::string const& lit)
+{
+    uint_literal_type value = 0;
+    bool is_unsigned = false;
+    if (decode_intlit(lit.begin(), lit.end(), value, is_unsigned))
+        ++failures;
+}
+
+static void check_char(std::string const& lit, boost::uint32_t expected,
+    bool expected_overflow = false)
+{
+    boost::uint32_t value = 0;
+    boost::uint32_t max_value = 0;
+    bool overflow = false;
+    if (!decode_chlit(lit.begin(), lit.end(), value, overflow, max_value) ||
+        overflow != expected_overflow ||
+        (!expected_overflow && value != expected))
+    {
+        ++failures;
+    }
+}
+
+static void check_char_error(std::string const& lit)
+{
+    boost::uint32_t value = 0;
+    boost::uint32_t max_value = 0;
+    bool overflow = false;
+    if (decode_chlit(lit.begin(), lit.end(), value, overflow, max_value))
+        ++failures;
+}
+
+int main()
+{
+    uint_literal_type const umax =
+        (std::numeric_limits<uint_literal_type>::max)();
+    uint_literal_type const imax =
+        uint_literal_type((std::numeric_limits<int_literal_type>::max)());
+    std::string const umax_dec = std::to_string(umax);
+    std::string const imax_dec = std::to_string(imax);
+
+    // bases
+    check_int("0", 0, false);
+    check_int("00", 0, false);
+    check_int("42", 42, false);
+    check_int("017", 15, false);
+    check_int("0x1F", 31, false);
+    check_int("0XfF", 255, false);
+    check_int("0b101", 5, false);
+    check_int("0B0", 0, false);
+
+    // digit separators
+    check_int("1'000'000", 1000000, false);
+    check_int("0x1'0", 16, false);
+    check_int("0b1'0'1", 5, false);
+    check_int("0'7", 7, false);
+    check_int_error("1''0");
+    check_int_error("1'");
+    check_int_error("0x'1");
+
+    // suffixes
+    check_int("1u", 1, true);
+    check_int("1U", 1, true);
+    check_int("1l", 1, false);
+    check_int("1ul", 1, true);
+    check_int("1LU", 1, true);
+    check_int("1ll", 1, false);
+    check_int("1ULL", 1, true);
+    check_int("1llu", 1, true);
+    check_int("1z", 1, false);
+    check_int("1uz", 1, true);
+    check_int("1Zu", 1, true);
+    check_int("1i64", 1, false);
+    check_int("1ui64", 1, true);
+    check_int("1I64", 1, false);
+    check_int("1UI64", 1, true);
+    check_int_error("1lL");
+    check_int_error("1lll");
+    check_int_error("1uu");
+    check_int_error("1lz");
+    check_int_error("1i32");
+    check_int_error("1i64l");
+
+    // signedness follows from the value, if there is no 'u' suffix
+    check_int(imax_dec, imax, false);
+    check_int(std::to_string(imax + 1), imax + 1, true);
+    check_int(umax_dec, umax, true);
+
+    // exact overflow detection for all bases
+    check_int_error(umax_dec + "0");
+    check_int_error(std::to_string(umax / 10 + 1) + "0");
+    {
+        std::string hex("0x");
+        std::string bin("0b");
+        for (std::size_t i = 0; i < sizeof(uint_literal_type) * CHAR_BIT; ++i) {
+            bin += '1';
+            if (i % 4 == 0)
+                hex += 'f';
+        }
+        check_int(hex, umax, true);
+        check_int(bin, umax, true);
+        check_int_error(hex + "0");
+        check_int_error(bin + "0");
+        check_int_error("0x1" + hex.substr(2));
+    }
+
+    // pp-numbers, which aren't integer literals
+    check_int_error("");
+    check_int_error("0x");
+    check_int_error("0b");
+    check_int_error("0b2");
+    check_int_error("08");
+    check_int_error("1e5");
+    check_int_error("0x1p3");
+    check_int_error("1.0");
+    check_int_error("123abc");
+
+    // character literals
+    check_char("'a'", 'a');
+    check_char("'\\n'", 0x0a);
+    check_char("'\\e'", 0x1b);
+    check_char("'\\''", '\'');
+    check_char("'\\\\'", '\\');
+    check_char("'\\0'", 0);
+    check_char("'\\101'", 'A');
+    check_char("'\\1011'", 0x4131);           // '\101' '1'
+    check_char("'\\777'", 0, true);
+    check_char("'\\x41'", 'A');
+    check_char("'\\x141'", 0, true);
+    check_char("'\\x0000041'", 'A');
+    check_char("'\\u0041'", 'A');
+    check_char("'\\u00e9'", 0, true);
+    check_char("'ab'", 0x6162);
+    check_char("'abcd'", 0x61626364);
+    check_char("'abcde'", 0, true);
+    check_char("u8'a'", 'a');
+    check_char("u'\\u1234'", 0x1234);
+    check_char("u'\\U00012345'", 0, true);
+    check_char("U'\\U00012345'", 0x12345);
+    check_char("U'\\xffffffff'", 0xffffffff);
+    check_char("U'\\x100000000'", 0, true);
+    check_char("L'\\x41'", 'A');
+    check_char("u'\xc3\xa9'", 0xe9);                // UTF-8 encoded e acute
+    check_char("U'\xf0\x9f\x98\x80'", 0x1f600);
+    check_char("'\xc3\xa9'", 0xc3a9);               // two narrow chars
+
+    check_char_error("");
+    check_char_error("a");
+    check_char_error("''");
+    check_char_error("'a");
+    check_char_error("'a'b");
+    check_char_error("'\\q'");
+    check_char_error("'\\x'");
+    check_char_error("'\\u12'");
+    check_char_error("'\\U1234'");
+    check_char_error("u9'a'");
+
+    return failures;
+}
@@ -0,0 +1,164 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the persistent cache of the preprocessed output: a stored result is
+// found for the same key as long as the recorded files are unchanged (a
+// touched but unmodified file doesn't matter), files modified after the run
+// started prevent storing the result, and the least recently used results
+// are removed once the cache exceeds its maximal size.
+
+#include <boost/wave/util/cpp_output_cache.hpp>
+#include <boost/wave/util/sha256.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using boost::wave::util::output_cache;
+
+static output_cache::result make_result(std::string const& output)
+{
+    output_cache::result r;
+    r.output = output;
+    r.messages = "warning\n";
+    return r;
+}
+
+int main()
+{
+    // the digest itself
+    if (boost::wave::util::sha256::hex_digest("abc") !=
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")
+    {
+        return 1;
+    }
+
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    write_file(root / "a.h", "int a;\n", 100);
+    write_file(root / "b.h", "int b;\n", 100);
+
+    std::vector<std::string> files;
+    files.push_back((root / "a.h").string());
+    files.push_back((root / "b.h").string());
+
+    int result = 0;
+    {
+        output_cache cache;
+        output_cache::result r;
+        if (!cache.open((root / "cache").string()) ||
+            cache.find("key", r) ||
+            !cache.insert("key", files, make_result("int a; int b;"),
+                std::time(0)))
+        {
+            result = 2;
+        }
+
+        // found for the same key only
+        if (0 == result && (!cache.find("key", r) ||
+                r.output != "int a; int b;" || r.messages != "warning\n" ||
+                cache.find("other key", r)))
+        {
+            result = 3;
+        }
+
+        // a touched file is compared by its content
+        fs::last_write_time(root / "a.h", std::time(0) - 50);
+        if (0 == result && !cache.find("key", r))
+            result = 4;
+
+        // a modified one invalidates the result
+        write_file(root / "b.h", "int c;\n", 50);
+        if (0 == result && cache.find("key", r))
+            result = 5;
+
+        // several results are kept per key
+        if (0 == result && (!cache.insert("key", files,
+                make_result("int a; int c;"), std::time(0)) ||
+                !cache.find("key", r) || r.output != "int a; int c;"))
+        {
+            result = 6;
+        }
+        write_file(root / "b.h", "int b;\n", 40);
+        if (0 == result && (!cache.find("key", r) || r.output != "int a; int b;"))
+            result = 7;
+
+        // inputs modified after the run started aren't trusted
+        write_file(root / "b.h", "int d;\n", 0);
+        if (0 == result && cache.insert("key", files,
+                make_result("int a; int d;"), std::time(0) - 10))
+        {
+            result = 8;
+        }
+
+        output_cache::statistics const& stats = cache.get_statistics();
+        if (0 == result && (stats.hits != 4 || stats.misses != 3 ||
+                stats.stored != 2 || stats.uncacheable != 1))
+        {
+            result = 9;
+        }
+        if (0 == result && !cache.save_statistics())
+            result = 10;
+
+        output_cache::statistics saved;
+        if (0 == result && (!output_cache::read_statistics(
+                (root / "cache").string(), saved) ||
+                saved.hits != 4 || saved.stored != 2 || 0 == saved.size))
+        {
+            result = 11;
+        }
+    }
+
+    // the least recently used results are removed first
+    if (0 == result) {
+        output_cache cache;
+        cache.open((root / "limited").string(), 30000);
+        std::vector<std::string> none;
+        std::string const output(10000, 'x');
+        for (int i = 0; i < 5 && 0 == result; ++i) {
+            if (!cache.insert("key" + std::string(1, char('0' + i)), none,
+                    make_result(output), std::time(0)) ||
+                !cache.save_statistics())
+            {
+                result = 12;
+            }
+
+            // make the order of the results unambiguous
+            for (fs::recursive_directory_iterator it(root / "limited"), end;
+                 it != end; ++it)
+            {
+                std::time_t const t = std::time(0) - 100 + 10 * i;
+                if (fs::is_regular_file(it->path()) &&
+                    it->path().filename() != "stats" &&
+                    fs::last_write_time(it->path()) > t)
+                {
+                    fs::last_write_time(it->path(), t);
+                }
+            }
+        }
+
+        output_cache::result r;
+        if (0 == result && (cache.find("key0", r) || !cache.find("key4", r)))
+            result = 13;
+
+        output_cache::statistics saved;
+        if (0 == result && (!output_cache::read_statistics(
+                (root / "limited").string(), saved) ||
+                0 == saved.evicted || saved.size > 30000))
+        {
+            result = 14;
+        }
+    }
+
+    return result;
+}
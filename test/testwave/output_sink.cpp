@@ -0,0 +1,139 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the buffered output sink: the text goes to the stream until a file
+// is opened and back to the stream after closing it, pieces larger than the
+// buffer and appending to a file work, the asynchronous writer produces the
+// same files, and context::preprocess_to() generates the same text as the
+// iterator interface.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+#include <boost/wave/util/output_sink.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+using boost::wave::util::output_sink;
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string>;
+
+static std::string read_file(fs::path const& p)
+{
+    fs::ifstream in(p, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+// write the same pieces of text (some of them larger than the buffer) into
+// a file, returns the expected content
+static std::string write_pieces(output_sink& sink)
+{
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        std::string piece(std::size_t(i % 7 == 0 ? 100 : i % 13),
+            char('a' + i % 26));
+        sink.write(piece);
+        expected += piece;
+    }
+    return expected;
+}
+
+int main()
+{
+    fs::path root = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(root);
+
+    int result = 0;
+    std::ostringstream stream;
+    {
+        output_sink sink(stream, 64);
+        sink.write("before ");
+        if (!sink.open((root / "a.txt").string().c_str()))
+            result = 1;
+        std::string const expected(write_pieces(sink));
+        sink.close();
+        sink.write("after");
+        sink.flush();
+
+        if (0 == result && (!sink.good() ||
+                read_file(root / "a.txt") != expected ||
+                stream.str() != "before after"))
+        {
+            result = 2;
+        }
+
+        // appending to an existing file
+        if (0 == result && (!sink.open((root / "a.txt").string().c_str(),
+                std::ios::out | std::ios::app)))
+        {
+            result = 3;
+        }
+        sink.write("appended");
+        sink.close();
+        if (0 == result && read_file(root / "a.txt") != expected + "appended")
+            result = 4;
+    }
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    // the background thread writes the same content
+    if (0 == result) {
+        output_sink sink(stream, 64);
+        sink.set_asynchronous(true);
+        std::string expected;
+        if (!sink.open((root / "b.txt").string().c_str()))
+            result = 5;
+        else
+            expected = write_pieces(sink);
+        sink.close();
+        if (0 == result && (!sink.good() || read_file(root / "b.txt") != expected))
+            result = 6;
+    }
+#endif
+
+    // preprocess_to() gives the same text as iterating over the tokens
+    if (0 == result) {
+        std::string text(
+            "#define F(x) (x + 1)\n"
+            "int a = F(2);\n"
+            "#if F(0)\n"
+            "int b;\n"
+            "#endif\n");
+
+        std::string iterated;
+        {
+            ctx_t ctx(text.begin(), text.end(), "main.cpp");
+            for (auto it = ctx.begin(); it != ctx.end(); ++it)
+                iterated += it->get_value().c_str();
+        }
+
+        std::ostringstream pushed;
+        {
+            ctx_t ctx(text.begin(), text.end(), "main.cpp");
+            output_sink sink(pushed, 8);
+            ctx.preprocess_to(sink);
+        }
+        if (pushed.str() != iterated ||
+            iterated.find("int a = (2 + 1);") == std::string::npos)
+        {
+            result = 7;
+        }
+    }
+
+    fs::remove_all(root);
+    return result;
+}
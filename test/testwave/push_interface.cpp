@@ -0,0 +1,181 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the push interface: context::run() and context::run_batched()
+// deliver the same tokens as the iterator interface, pp_iterator::run()
+// continues where the iteration stopped, leaving the iterator at the end,
+// also if the iterator was copied before, and preprocessing continues after
+// a recoverable error by incrementing the iterator.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <string>
+#include <vector>
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string>;
+
+// collects the ids and values of the tokens
+struct collector
+{
+    explicit collector(std::string& text_) : text(text_) {}
+
+    void operator()(token_t const& token) const
+    {
+        text += std::to_string(int(boost::wave::token_id(token))) + ':' +
+            token.get_value().c_str() + ' ';
+    }
+    void operator()(std::vector<token_t> const& batch) const
+    {
+        if (batch.empty() || batch.size() > 3)
+            text += "<bad batch>";
+        for (auto const& token : batch)
+            (*this)(token);
+    }
+
+    std::string& text;
+};
+
+int main()
+{
+    std::string text(
+        "#define F(x) (x + 1)\n"
+        "int a = F(2);\n"
+        "#if F(0)\n"
+        "int b = __LINE__;\n"
+        "#endif\n");
+
+    std::string iterated;
+    {
+        ctx_t ctx(text.begin(), text.end(), "main.cpp");
+        collector const collect(iterated);
+        for (auto it = ctx.begin(); it != ctx.end(); ++it)
+            collect(*it);
+    }
+    if (iterated.find(":b ") == std::string::npos)
+        return 1;
+
+    std::string pushed;
+    {
+        ctx_t ctx(text.begin(), text.end(), "main.cpp");
+        ctx.run(collector(pushed));
+    }
+    if (pushed != iterated)
+        return 2;
+
+    std::string batched;
+    {
+        ctx_t ctx(text.begin(), text.end(), "main.cpp");
+        ctx.run_batched(collector(batched), 3);
+    }
+    if (batched != iterated)
+        return 3;
+
+    // continue iterating by pushing the remaining tokens
+    std::string continued;
+    {
+        ctx_t ctx(text.begin(), text.end(), "main.cpp");
+        collector const collect(continued);
+        ctx_t::iterator_type it = ctx.begin();
+        for (int i = 0; i < 5; ++i, ++it)
+            collect(*it);
+        it.run(collect);
+        if (it != ctx.end())
+            return 4;
+    }
+    if (continued != iterated)
+        return 5;
+
+    // push the tokens, while a copy of the iterator is still used
+    std::string shared;
+    {
+        ctx_t ctx(text.begin(), text.end(), "main.cpp");
+        collector const collect(shared);
+        ctx_t::iterator_type it = ctx.begin();
+        ctx_t::iterator_type copy = it;
+        for (int i = 0; i < 5; ++i)
+            ++copy;
+        it.run(collect);
+        if (it != ctx.end())
+            return 6;
+    }
+    if (shared != iterated)
+        return 6;
+
+    // push the tokens buffered by a copy of the iterator, which is gone
+    std::string buffered;
+    {
+        ctx_t ctx(text.begin(), text.end(), "main.cpp");
+        collector const collect(buffered);
+        ctx_t::iterator_type it = ctx.begin();
+        {
+            ctx_t::iterator_type copy = it;
+            for (int i = 0; i < 5; ++i)
+                ++copy;
+        }
+        it.run(collect);
+        if (it != ctx.end())
+            return 7;
+    }
+    if (buffered != iterated)
+        return 7;
+
+    // recover from errors as when iterating
+    std::string erroneous(
+        "int a;\n"
+        "#warning careful\n"
+        "int b;\n");
+    std::string expected;
+    int errors = 0;
+    {
+        ctx_t ctx(erroneous.begin(), erroneous.end(), "main.cpp");
+        ctx_t::iterator_type it = ctx.begin();
+        ctx_t::iterator_type end = ctx.end();
+        collector const collect(expected);
+        while (it != end) {
+            try {
+                collect(*it);
+                ++it;
+            }
+            catch (boost::wave::preprocess_exception const&) {
+                ++errors;
+                ++it;
+            }
+        }
+    }
+
+    if (0 == errors)
+        return 8;
+
+    std::string recovered;
+    {
+        ctx_t ctx(erroneous.begin(), erroneous.end(), "main.cpp");
+        ctx_t::iterator_type it = ctx.begin();
+        bool finished = false;
+        while (!finished) {
+            try {
+                it.run(collector(recovered));
+                finished = true;
+            }
+            catch (boost::wave::preprocess_exception const&) {
+                --errors;
+                ++it;
+            }
+        }
+    }
+    if (recovered != expected || 0 != errors ||
+        recovered.find(":b ") == std::string::npos)
+    {
+        return 9;
+    }
+    return 0;
+}
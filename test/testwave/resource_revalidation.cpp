@@ -0,0 +1,152 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the revalidation of the shared_resources: the cached files and
+// include file lookups are reused until revalidate() is called, afterwards
+// the modified files are read again and the lookups depending on modified
+// directories are repeated, while everything else is still reused. Also
+// verify, that clear() drops all of the cached items and that the caches
+// stay within their limit by dropping the items used least recently.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string>;
+
+// preprocess the given text, returns the significant tokens
+static std::string preprocess(fs::path const& root,
+    boost::wave::shared_resources& resources)
+{
+    std::string text("#include <h.h>\n#include <f.h>\n");
+    std::string main_file = (root / "main.cpp").string();
+    ctx_t ctx(text.begin(), text.end(), main_file.c_str());
+    ctx.set_language(boost::wave::enable_emit_line_directives(
+        ctx.get_language(), false));
+    ctx.add_sysinclude_path((root / "a").string().c_str());
+    ctx.add_sysinclude_path((root / "b").string().c_str());
+    ctx.set_shared_resources(&resources);
+
+    std::string result;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        if (!IS_CATEGORY(*it, boost::wave::WhiteSpaceTokenType) &&
+            !IS_CATEGORY(*it, boost::wave::EOLTokenType) &&
+            !IS_CATEGORY(*it, boost::wave::EOFTokenType))
+        {
+            result += it->get_value().c_str();
+        }
+    }
+    return result;
+}
+
+int main()
+{
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    fs::create_directories(root / "a");
+    fs::create_directories(root / "b");
+    write_file(root / "b" / "h.h", "int b;\n", 100);
+    write_file(root / "a" / "f.h", "int f;\n", 100);
+
+    int result = 0;
+    boost::wave::shared_resources resources;
+    if (preprocess(root, resources) != "intb;intf;")
+        result = 1;
+
+    // a header shadowing h.h is added and f.h is modified, the cached data
+    // is used until the resources are revalidated
+    write_file(root / "a" / "h.h", "int a;\n", 50);
+    write_file(root / "a" / "f.h", "int modified;\n", 50);
+    if (0 == result && preprocess(root, resources) != "intb;intf;")
+        result = 2;
+
+    resources.revalidate();
+    if (0 == result && preprocess(root, resources) != "inta;intmodified;")
+        result = 3;
+    if (0 == result && 0 == resources.get_invalidated())
+        result = 4;
+
+    // without any further modifications everything is reused
+    std::size_t const file_misses = resources.get_file_misses();
+    std::size_t const resolution_misses = resources.get_resolution_misses();
+    resources.revalidate();
+    if (0 == result && preprocess(root, resources) != "inta;intmodified;")
+        result = 5;
+    if (0 == result && (file_misses != resources.get_file_misses() ||
+            resolution_misses != resources.get_resolution_misses()))
+    {
+        result = 6;
+    }
+
+    // after clearing the caches the files are read again
+    resources.clear();
+    if (0 == result && 0 != resources.cached_bytes())
+        result = 7;
+    if (0 == result && (preprocess(root, resources) != "inta;intmodified;" ||
+            file_misses == resources.get_file_misses()))
+    {
+        result = 8;
+    }
+
+    // a cache exceeding its limit drops its items
+    boost::wave::shared_resources bounded;
+    bounded.set_max_size(1);
+    if (0 == result && preprocess(root, bounded) != "inta;intmodified;")
+        result = 9;
+    if (0 == result &&
+        (0 == bounded.get_evicted() || bounded.cached_bytes() > 1))
+    {
+        result = 10;
+    }
+
+    // without any revalidation, the items accessed least recently are
+    // dropped first
+    boost::wave::shared_resources lru;
+    lru.set_max_size(3600);
+    std::string const names[] = { "x.h", "y.h", "z.h", "w.h" };
+    for (std::string const& name : names)
+        write_file(root / name, std::string(1000, 'x'), 100);
+
+    std::string content;
+    for (int i = 0; 0 == result && i < 4; ++i) {
+        if (!lru.load_file((root / names[i]).string(), content))
+            result = 11;
+        if (0 == i)
+            lru.load_file((root / names[i]).string(), content);
+        if (2 == i)
+            lru.load_file((root / names[0]).string(), content);
+    }
+    std::size_t const misses = lru.get_file_misses();
+    if (0 == result && (0 == lru.get_evicted() ||
+            !lru.load_file((root / names[0]).string(), content) ||
+            misses != lru.get_file_misses()))
+    {
+        result = 12;
+    }
+    if (0 == result &&
+        (!lru.load_file((root / names[1]).string(), content) ||
+            misses == lru.get_file_misses()))
+    {
+        result = 13;
+    }
+
+    return result;
+}
@@ -0,0 +1,146 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify the dependency scanning mode (support_option_scan_dependencies):
+// the directives are evaluated as usual, including the macro expansion in
+// conditionals and computed #includes, while the text in between is skipped
+// without being macro expanded and no tokens are generated.
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <vector>
+
+#include "temp_directory.hpp"
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+
+// record the names of the opened include files
+struct dependency_hooks
+:   boost::wave::context_policies::eat_whitespace<token_t>
+{
+    explicit dependency_hooks(std::vector<std::string>* names_)
+    :   names(names_)
+    {}
+
+    template <typename ContextT>
+    void opened_include_file(ContextT const&, std::string const&,
+        std::string const& absname, bool)
+    {
+        names->push_back(fs::path(absname).filename().string());
+    }
+
+    std::vector<std::string>* names;
+};
+
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    dependency_hooks>;
+
+// preprocess the given text, returns the significant tokens generated
+static std::string preprocess(std::string text, fs::path const& root,
+    bool scan_only, std::vector<std::string>& names)
+{
+    std::string main_file = (root / "main.cpp").string();
+    ctx_t ctx(text.begin(), text.end(), main_file.c_str(),
+        dependency_hooks(&names));
+    // the #line directives are enabled while scanning only, to verify that
+    // these aren't generated
+    ctx.set_language(boost::wave::enable_scan_dependencies(
+        boost::wave::enable_emit_line_directives(
+            boost::wave::language_support(
+                boost::wave::support_cpp20 |
+                boost::wave::support_option_include_guard_detection |
+                boost::wave::support_option_emit_pragma_directives |
+                boost::wave::support_option_insert_whitespace),
+            scan_only),
+        scan_only));
+    ctx.add_include_path(root.string().c_str());
+
+    std::string result;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        if (!IS_CATEGORY(*it, boost::wave::WhiteSpaceTokenType) &&
+            !IS_CATEGORY(*it, boost::wave::EOLTokenType) &&
+            !IS_CATEGORY(*it, boost::wave::EOFTokenType))
+        {
+            result += it->get_value().c_str();
+        }
+    }
+    return result;
+}
+
+int main()
+{
+    temp_directory temp;
+    fs::path const& root = temp.path();
+    write_file(root / "config.h",
+        "#ifndef CONFIG_H\n#define CONFIG_H\n"
+        "#define HEADER \"computed.h\"\n#define USE_EXTRA 1\n"
+        "int config;\n#endif\n");
+    write_file(root / "computed.h", "computed\n");
+    write_file(root / "extra.h", "#include \"config.h\"\nextra\n");
+    write_file(root / "skipped.h", "skipped\n");
+
+    // the text contains a macro invocation with a wrong number of arguments,
+    // which must not be expanded while scanning
+    std::string const text(
+        "#include \"config.h\"\n"
+        "#define F(x) x\n"
+        "F(1, 2)\n"
+        "/* a comment ending\n"
+        "   on the next line */ #include HEADER\n"
+        "#if USE_EXTRA\n"
+        "#pragma unknown\n"
+        "#include \"extra.h\"\n"
+        "#else\n"
+        "#include \"skipped.h\"\n"
+        "#endif\n"
+        "#pragma once\n"
+        "text\n");
+
+    int result = 0;
+    std::vector<std::string> names;
+    if (!preprocess(text, root, true, names).empty())
+        result = 1;
+
+    std::vector<std::string> expected;
+    expected.push_back("config.h");
+    expected.push_back("computed.h");
+    expected.push_back("extra.h");
+    if (0 == result && names != expected)
+        result = 2;
+
+    // without scanning the same files are included and the text is expanded
+    if (0 == result) {
+        std::vector<std::string> all_names;
+        try {
+            preprocess(text, root, false, all_names);
+            result = 3;
+        }
+        catch (boost::wave::preprocess_exception const&) {
+            // F(1, 2) has too many arguments
+        }
+        std::string valid_text(text);
+        valid_text.replace(valid_text.find("F(1, 2)"), 7, "F(1)");
+        all_names.clear();
+        if (0 == result && (preprocess(valid_text, root, false, all_names) !=
+                "intconfig;1computed#pragmaunknownextratext" || all_names != expected))
+        {
+            result = 4;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,183 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Stress test for contexts running concurrently: preprocess all files of the
+// testwave corpus (given as the argument) on 32 threads at once, all of them
+// attached to the same shared_resources object, and verify that the output
+// is byte-identical to the one of a single context running alone (the
+// expansions of __DATE__ and __TIME__ are normalized, as these may change
+// while the test runs).
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using lex_iter_t = boost::wave::cpplexer::lex_iterator<token_t>;
+using ctx_t = boost::wave::context<
+    std::string::iterator, lex_iter_t,
+    boost::wave::iteration_context_policies::load_file_to_string>;
+
+struct input_file
+{
+    std::string name;
+    std::string content;
+};
+
+// the expansions of __DATE__ and __TIME__ depend on the time the context
+// was created
+static std::string normalize(std::string const& value)
+{
+    static std::regex const date(
+        "\"(\\w{3} [ \\d]\\d \\d{4}|\\?{3} \\?{2} \\?{4})\"");
+    static std::regex const time(
+        "\"(\\d{2}:\\d{2}:\\d{2}|\\?{2}:\\?{2}:\\?{2})\"");
+    if (std::regex_match(value, date))
+        return "__DATE__";
+    if (std::regex_match(value, time))
+        return "__TIME__";
+    return value;
+}
+
+// preprocess a file, the errors are part of the output
+static std::string preprocess(input_file const& file, fs::path const& dir,
+    boost::wave::shared_resources* resources)
+{
+    std::string content(file.content);
+    ctx_t ctx(content.begin(), content.end(), file.name.c_str());
+    ctx.set_language(boost::wave::language_support(
+        boost::wave::support_cpp20 |
+        boost::wave::support_option_long_long |
+        boost::wave::support_option_convert_trigraphs |
+        boost::wave::support_option_emit_line_directives |
+        boost::wave::support_option_include_guard_detection |
+        boost::wave::support_option_insert_whitespace));
+    ctx.add_sysinclude_path(dir.string().c_str());
+    ctx.add_include_path(dir.string().c_str());
+    ctx.set_shared_resources(resources);
+
+    std::string result;
+    auto it = ctx.begin();
+    for (;;) {
+        try {
+            if (it == ctx.end())
+                break;
+            if (boost::wave::T_STRINGLIT == boost::wave::token_id(*it))
+                result += normalize(it->get_value().c_str());
+            else
+                result += it->get_value().c_str();
+            ++it;
+        }
+        catch (boost::wave::cpp_exception const& e) {
+            result += "error: ";
+            result += e.description();
+            result += '\n';
+            if (!e.is_recoverable())
+                break;
+        }
+        catch (std::exception const& e) {
+            result += "exception: ";
+            result += e.what();
+            break;
+        }
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "usage: shared_resources <testwave testfiles directory>"
+                  << std::endl;
+        return 1;
+    }
+
+    fs::path dir(fs::canonical(argv[1]));
+    std::vector<input_file> files;
+    for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it)
+    {
+        if (it->path().extension() != ".cpp")
+            continue;
+
+        fs::ifstream in(it->path());
+        input_file file;
+        file.name = it->path().string();
+        file.content.assign(std::istreambuf_iterator<char>(in.rdbuf()),
+            std::istreambuf_iterator<char>());
+        files.push_back(file);
+    }
+
+    // the corpus doesn't expand these
+    input_file date_time;
+    date_time.name = (dir / "date_time.cpp").string();
+    date_time.content = "__DATE__ __TIME__\n";
+    files.push_back(date_time);
+    std::sort(files.begin(), files.end(),
+        [](input_file const& lhs, input_file const& rhs)
+        { return lhs.name < rhs.name; });
+    if (files.size() < 2) {
+        std::cerr << "no test files found in " << dir << std::endl;
+        return 2;
+    }
+
+    // the expected results
+    std::vector<std::string> expected;
+    for (input_file const& file : files)
+        expected.push_back(preprocess(file, dir, 0));
+
+    // every thread preprocesses all files, starting at a different one
+    unsigned int const thread_count = 32;
+    boost::wave::shared_resources resources;
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            std::size_t const start = t * files.size() / thread_count;
+            for (std::size_t i = 0; i < files.size(); ++i) {
+                std::size_t current = (start + i) % files.size();
+                if (preprocess(files[current], dir, &resources) !=
+                    expected[current])
+                {
+                    if (0 == mismatches++) {
+                        std::cerr << "different output for "
+                                  << files[current].name << std::endl;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (0 != mismatches) {
+        std::cerr << mismatches << " outputs differ" << std::endl;
+        return 3;
+    }
+
+    // the included files were read once and the lookups shared
+    if (0 == resources.get_file_hits() || 0 == resources.files_size())
+        return 4;
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    if (0 == resources.get_resolution_hits())
+        return 5;
+#endif
+    return 0;
+}
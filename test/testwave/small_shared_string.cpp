@@ -0,0 +1,128 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Exercise the SmallSharedStringStorage policy of flex_string by applying the
+// same (pseudo random) sequence of operations to a flex_string and to a
+// std::string. The strings grow and shrink across the inline threshold and
+// are copied around, so that shared and aliased cases are hit frequently.
+
+#include <boost/wave/util/flex_string.hpp>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using string_t = boost::wave::util::flex_string<
+    char, std::char_traits<char>, std::allocator<char>,
+    boost::wave::util::SmallSharedStringStorage<char> >;
+
+bool same(string_t const& s, std::string const& r)
+{
+    return s.size() == r.size() &&
+        std::strlen(s.c_str()) == r.size() &&
+        0 == std::memcmp(s.data(), r.data(), r.size());
+}
+
+int main() {
+    std::mt19937 rng(4711);
+
+    // up to 23 characters are stored inline
+    if (sizeof(string_t) != 24)
+        return 1;
+
+    for (int round = 0; round != 50; ++round) {
+        std::vector<string_t> s(4);
+        std::vector<std::string> r(4);
+
+        for (int step = 0; step != 500; ++step) {
+            std::size_t i = rng() % s.size();
+            std::size_t j = rng() % s.size();
+            std::string v(rng() % 24, char('a' + step % 26));
+
+            switch (rng() % 9) {
+            case 0:
+                s[i] = string_t(v.c_str());
+                r[i] = v;
+                break;
+
+            case 1:
+                s[i] += v.c_str();
+                r[i] += v;
+                break;
+
+            case 2:
+                // copies share long strings, modifying one must not touch
+                // the other
+                s[i] = s[j];
+                r[i] = r[j];
+                s[i] += 'x';
+                r[i] += 'x';
+                break;
+
+            case 3:
+                {
+                    std::size_t n = rng() % (r[i].size() + 1);
+                    s[i].resize(n, 'y');
+                    r[i].resize(n, 'y');
+                    n = rng() % 40;
+                    s[i].resize(n, 'z');
+                    r[i].resize(n, 'z');
+                }
+                break;
+
+            case 4:
+                // append (part of) the string to itself
+                {
+                    std::size_t n = rng() % (r[i].size() + 1);
+                    s[i].append(s[i].data(), n);
+                    r[i].append(r[i].data(), n);
+                }
+                break;
+
+            case 5:
+                {
+                    std::size_t pos = rng() % (r[i].size() + 1);
+                    s[i].insert(pos, v.c_str());
+                    r[i].insert(pos, v);
+                }
+                break;
+
+            case 6:
+                {
+                    std::size_t pos = rng() % (r[i].size() + 1);
+                    std::size_t n = rng() % 10;
+                    s[i].erase(pos, n);
+                    r[i].erase(pos, n);
+                }
+                break;
+
+            case 7:
+                s[i].swap(s[j]);
+                r[i].swap(r[j]);
+                break;
+
+            case 8:
+                {
+                    string_t copy(s[i]);
+                    std::string const old(r[i]);
+                    s[i] = s[j] + copy;
+                    r[i] = r[j] + r[i];
+                    if (!same(copy, old))
+                        return 2;
+                }
+                break;
+            }
+
+            for (std::size_t k = 0; k != s.size(); ++k) {
+                if (!same(s[k], r[k]))
+                    return 3;
+            }
+        }
+    }
+    return 0;
+}
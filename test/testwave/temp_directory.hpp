@@ -0,0 +1,86 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Helpers for the tests, which preprocess files created in a temporary
+// directory.
+
+#if !defined(BOOST_WAVE_LIBS_WAVE_TEST_TEMP_DIRECTORY_HPP)
+#define BOOST_WAVE_LIBS_WAVE_TEST_TEMP_DIRECTORY_HPP
+
+#include <boost/wave/token_ids.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <ctime>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+// a uniquely named directory below the temporary directory of the system,
+// which is removed together with its contents at the end of the test
+class temp_directory
+{
+public:
+    temp_directory()
+    :   root(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path())
+    {
+        boost::filesystem::create_directories(root);
+    }
+    ~temp_directory()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(root, ec);
+    }
+
+    boost::filesystem::path const& path() const { return root; }
+
+private:
+    temp_directory(temp_directory const&);
+    temp_directory& operator=(temp_directory const&);
+
+    boost::filesystem::path root;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// create (or replace) the given file
+inline void write_file(boost::filesystem::path const& p,
+    std::string const& content)
+{
+    boost::filesystem::ofstream out(p);
+    out << content;
+}
+
+// create (or replace) the given file and set the modification times of the
+// file and of its directory to the given number of seconds in the past, as
+// files and directories modified during the second these are read aren't
+// trusted by the caches
+inline void write_file(boost::filesystem::path const& p,
+    std::string const& content, std::time_t age)
+{
+    write_file(p, content);
+    boost::filesystem::last_write_time(p, std::time(0) - age);
+    boost::filesystem::last_write_time(p.parent_path(), std::time(0) - age);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// preprocess the input of the given context, returns the identifiers
+// generated
+template <typename ContextT>
+std::string preprocess(ContextT& ctx)
+{
+    std::string result;
+    for (typename ContextT::iterator_type it = ctx.begin(); it != ctx.end();
+         ++it)
+    {
+        if (boost::wave::T_IDENTIFIER == boost::wave::token_id(*it))
+            result += it->get_value().c_str();
+    }
+    return result;
+}
+
+#endif // !defined(BOOST_WAVE_LIBS_WAVE_TEST_TEMP_DIRECTORY_HPP)
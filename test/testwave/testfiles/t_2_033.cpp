@@ -0,0 +1,16 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+// Tests the #warning directive, if its support is disabled during the
+// compilation (it is reported as an ill formed directive then)
+
+//D __TESTWAVE_NO_WARNING_DIRECTIVE__
+//R
+//E t_2_033.cpp(16): error: ill formed preprocessor directive: This
+#warning This is not a warning
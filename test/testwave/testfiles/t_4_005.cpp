@@ -0,0 +1,53 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+// Tests operator precedence and associativity, short circuit evaluation and
+// the alternative operator spellings in #if expressions
+
+//R #line 16 "t_4_005.cpp"
+//R true1
+#if 1 + 2 * 3 == 7 && 10 - 4 - 3 == 3 && 64 / 4 / 2 == 8 && 1 << 2 + 1 == 8
+true1
+#else
+false1
+#endif
+
+//R #line 24 "t_4_005.cpp"
+//R true2
+#if (1 | 2 ^ 3 & 4) == 3 && (0 ? 1 : 0 ? 2 : 3) == 3 && -1 < 0 && -1 > 0u
+true2
+#else
+false2
+#endif
+
+// the right operand of || and && isn't evaluated if the result is known
+//R #line 33 "t_4_005.cpp"
+//R true3
+#if (1 || 1 / 0) && !(0 && 1 % 0)
+true3
+#else
+false3
+#endif
+
+//R #line 41 "t_4_005.cpp"
+//R true4
+#if (1 bitor 2) == 3 and not (1 bitand 2) and (3 xor 1) == 2 and compl 0 == -1 and 1 not_eq 2
+true4
+#else
+false4
+#endif
+
+// the bool result of a comparison is promoted to int when shifted
+//R #line 50 "t_4_005.cpp"
+//R true5
+#if ((1 == 1) << 3) == 8 && ((2 > 1) >> 1) == 0 && ((1 < 2) << 62) > 0
+true5
+#else
+false5
+#endif
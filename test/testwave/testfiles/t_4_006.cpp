@@ -0,0 +1,39 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+// Tests the evaluation of integer and character literals in #if expressions:
+// binary literals, digit separators, the signedness of hexadecimal and octal
+// literals and the character literal encoding prefixes
+
+//O --c++11
+
+//R #line 19 "t_4_006.cpp"
+//R true1
+#if 0b101 == 5 && 0B1'0000 == 16 && 1'000 == 1000 && 0x1'0 == 020
+true1
+#else
+false1
+#endif
+
+// hexadecimal and octal literals are signed, if their value fits
+//R #line 28 "t_4_006.cpp"
+//R true2
+#if 0x10 - 17 < 0 && 010 - 9 < 0 && 0xffffffffffffffff > 0
+true2
+#else
+false2
+#endif
+
+//R #line 36 "t_4_006.cpp"
+//R true3
+#if u'a' == 97 && U'\U00012345' == 0x12345
+true3
+#else
+false3
+#endif
@@ -0,0 +1,14 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+// Tests error reporting: #if directive containing whitespace and comments only.
+
+//E t_6_071.cpp(13): error: ill formed preprocessor expression: <empty expression>
+#if /* nothing */  
+#endif
@@ -0,0 +1,13 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+// Tests error reporting: #define directive with a malformed parameter list.
+
+//E t_6_073.cpp(13): error: ill formed preprocessor directive: #define FOO(a b) a
+#define FOO(a b) a
@@ -0,0 +1,60 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+// Tests the recognition of directives with comments and whitespace between
+// their parts, and of function like macros with an empty parameter list
+
+#define/**/F(/**/a/**/,b)/**/a+b/**/  
+#define G( ) 2
+#define H (x)
+#define E
+#  ifdef/**/F /* comment */
+F(1,2) G() H E;
+#endif // comment
+#ifndef	E
+#error E should be defined
+#else
+#undef/**/E
+#endif
+#ifdef E
+#error E should not be defined
+#endif
+
+//R #line 18 "t_9_029.cpp"
+//R 1+2 2 (x) ;
+//H 10: t_9_029.cpp(13): #define
+//H 08: t_9_029.cpp(13): F(a, b)=a+b
+//H 10: t_9_029.cpp(14): #define
+//H 08: t_9_029.cpp(14): G()=2
+//H 10: t_9_029.cpp(15): #define
+//H 08: t_9_029.cpp(15): H=(x)
+//H 10: t_9_029.cpp(16): #define
+//H 08: t_9_029.cpp(16): E=
+//H 10: t_9_029.cpp(17): #  ifdef
+//H 11: t_9_029.cpp(17): #  ifdef F: 1
+//H 00: t_9_029.cpp(18): F(1,2), [t_9_029.cpp(13): F(a, b)=a+b]
+//H 02: 1+2
+//H 03: 1+2
+//H 00: t_9_029.cpp(18): G(), [t_9_029.cpp(14): G()=2]
+//H 02: 2
+//H 03: 2
+//H 01: t_9_029.cpp(15): H
+//H 02: (x)
+//H 03: (x)
+//H 01: t_9_029.cpp(16): E
+//H 02: 
+//H 03: _
+//H 10: t_9_029.cpp(19): #endif
+//H 10: t_9_029.cpp(20): #ifndef
+//H 11: t_9_029.cpp(20): #ifndef E: 1
+//H 10: t_9_029.cpp(23): #undef
+//H 09: t_9_029.cpp(23): E
+//H 10: t_9_029.cpp(24): #endif
+//H 10: t_9_029.cpp(25): #ifdef
+//H 11: t_9_029.cpp(25): #ifdef E: 0
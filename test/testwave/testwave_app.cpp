@@ -476,7 +476,7 @@ testwave_app::test_a_file(std::string filename)
             if (!extract_special_information(filename, instr, 'E', expected_error))
                 return false;
 
-            if (!expected_error.empty() &&
+            if (!suppressed && !expected_error.empty() &&
                 !got_expected_result(filename, error, expected_error))
             {
                 // we expected an error but got none (or a different one)
@@ -1410,6 +1410,27 @@ testwave_app::add_support_ms_extensions_definition(Context& ctx)
 }
 #endif
 
+#if BOOST_WAVE_SUPPORT_WARNING_DIRECTIVE == 0
+//  Predefine __TESTWAVE_NO_WARNING_DIRECTIVE__
+template <typename Context>
+inline bool
+testwave_app::add_no_warning_directive_definition(Context& ctx)
+{
+    std::string macro("__TESTWAVE_NO_WARNING_DIRECTIVE__=1");
+    if (!ctx.add_macro_definition(macro, true)) {
+        std::cerr << "testwave: failed to predefine macro: " << macro
+                  << std::endl;
+        return false;
+    }
+    else if (9 == debuglevel) {
+        std::cerr << "add_no_warning_directive_definition: predefined macro: "
+                  << macro
+                  << std::endl;
+    }
+    return true;
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 //  Add special predefined macros to the context object.
@@ -1482,6 +1503,16 @@ testwave_app::add_predefined_macros(Context& ctx)
     }
 #endif
 
+#if BOOST_WAVE_SUPPORT_WARNING_DIRECTIVE == 0
+//  Predefine __TESTWAVE_NO_WARNING_DIRECTIVE__
+    if (!add_no_warning_directive_definition(ctx))
+    {
+        std::cerr << "testwave: failed to add a predefined macro "
+                     "(__TESTWAVE_NO_WARNING_DIRECTIVE__)."
+                  << std::endl;
+    }
+#endif
+
 #if BOOST_WAVE_USE_STRICT_LEXER != 0
     return add_strict_lexer_definition(ctx);
 #else
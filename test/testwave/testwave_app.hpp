@@ -127,6 +127,12 @@ protected:
     bool add_support_ms_extensions_definition(Context& ctx);
 #endif
 
+#if BOOST_WAVE_SUPPORT_WARNING_DIRECTIVE == 0
+    //  Predefine __TESTWAVE_NO_WARNING_DIRECTIVE__
+    template <typename Context>
+    bool add_no_warning_directive_definition(Context& ctx);
+#endif
+
 private:
     int debuglevel;
     boost::program_options::options_description desc_options;
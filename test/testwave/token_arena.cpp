@@ -0,0 +1,168 @@
+// Copyright 2026 Jeff Trull.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Verify that contexts allocating their tokens from a private arena produce
+// the same output as contexts using the global pools, also when several of
+// them are running concurrently, that the default token type doesn't use the
+// arena, and that resetting the macros rewinds the arena once none of its
+// tokens is referenced anymore.
+
+// the lexer and the grammars are instantiated here for the token type
+// allocating from the arena
+#define BOOST_WAVE_SEPARATE_LEXER_INSTANTIATION 0
+#define BOOST_WAVE_SEPARATE_GRAMMAR_INSTANTIATION 0
+
+#include <boost/wave.hpp>
+#include <boost/wave/cpplexer/cpp_lex_token.hpp>
+#include <boost/wave/cpplexer/cpp_lex_iterator.hpp>
+#include <boost/wave/cpplexer/re2clex/cpp_re2c_lexer.hpp>
+#include <boost/wave/grammars/cpp_intlit_grammar.hpp>
+#include <boost/wave/grammars/cpp_chlit_grammar.hpp>
+#include <boost/wave/grammars/cpp_grammar.hpp>
+#include <boost/wave/grammars/cpp_expression_grammar.hpp>
+#include <boost/wave/grammars/cpp_predef_macros_grammar.hpp>
+#include <boost/wave/grammars/cpp_defined_grammar.hpp>
+#include <boost/wave/grammars/cpp_has_include_grammar.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename Token, typename AllocationPolicy>
+using ctx_t = boost::wave::context<
+    std::string::iterator, boost::wave::cpplexer::lex_iterator<Token>,
+    boost::wave::iteration_context_policies::load_file_to_string,
+    boost::wave::context_policies::eat_whitespace<Token>,
+    boost::wave::this_type, AllocationPolicy>;
+
+using token_t = boost::wave::cpplexer::lex_token<>;
+using arena_token_t = boost::wave::cpplexer::lex_token<
+    boost::wave::util::file_position_type, boost::wave::util::token_arena>;
+
+using global_ctx_t =
+    ctx_t<token_t, boost::wave::allocation_policies::global_pool>;
+using arena_ctx_t =
+    ctx_t<arena_token_t, boost::wave::allocation_policies::context_arena>;
+using unused_arena_ctx_t =
+    ctx_t<token_t, boost::wave::allocation_policies::context_arena>;
+
+static std::string const input =
+    "#define CAT(a, b) a ## b\n"
+    "#define STR(a) #a\n"
+    "#define XSTR(a) STR(a)\n"
+    "#define LIST(x) x(1) x(2) x(3) x(4) x(5) x(6) x(7) x(8)\n"
+    "#define ITEM(n) CAT(item, n) = XSTR(CAT(n, n));\n"
+    "#if defined(CAT) && (LIST(+) > 0)\n"
+    "LIST(ITEM)\n"
+    "#else\n"
+    "#error unexpected\n"
+    "#endif\n"
+    "#undef LIST\n"
+    "#define LIST(x) x(9)\n"
+    "LIST(ITEM)\n";
+
+template <typename Context>
+std::string preprocess(bool& used_arena)
+{
+    std::string text(input);
+    Context ctx(text.begin(), text.end(), "arena.cpp");
+
+    std::string result;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        result += it->get_value().c_str();
+    }
+
+    boost::wave::util::token_arena* arena = ctx.get_token_arena();
+    used_arena = (nullptr != arena && arena->capacity() > 0);
+    return result;
+}
+
+// resetting the macros rewinds the arena only, if none of its tokens is left
+int reset_rewinds_arena(std::string const& expected)
+{
+    std::string text;
+    for (int i = 0; i != 1000; ++i) {
+        text += "#define UNUSED" + std::to_string(i) +
+            "(a, b) a + b * (a - b) / 2\n";
+    }
+    text += input;
+
+    arena_ctx_t ctx(text.begin(), text.end(), "arena.cpp");
+    arena_ctx_t::token_type held;
+    for (auto it = ctx.begin(); it != ctx.end(); ++it) {
+        if (boost::wave::T_IDENTIFIER == boost::wave::token_id(*it))
+            held = *it;
+    }
+
+    boost::wave::util::token_arena* arena = ctx.get_token_arena();
+    std::size_t const capacity = arena->capacity();
+    if (capacity <= 32768)
+        return 7;
+
+    // a token is still referenced
+    ctx.reset_macro_definitions();
+    if (arena->capacity() != capacity || 0 == arena->in_use() ||
+        held.get_value() != "item9")
+    {
+        return 8;
+    }
+
+    held = arena_ctx_t::token_type();
+    ctx.reset_macro_definitions();
+    if (arena->capacity() >= capacity)
+        return 9;
+
+    // the context is still usable afterwards
+    std::string result;
+    text = input;
+    for (auto it = ctx.begin(text.begin(), text.end()); it != ctx.end(); ++it)
+        result += it->get_value().c_str();
+    return result == expected ? 0 : 10;
+}
+
+int main() {
+    bool used_arena = false;
+
+    std::string const expected = preprocess<global_ctx_t>(used_arena);
+    if (used_arena)
+        return 1;
+
+    if (preprocess<arena_ctx_t>(used_arena) != expected)
+        return 2;
+    if (!used_arena)
+        return 3;
+
+    // the default token type is allocated from the global pools only
+    if (preprocess<unused_arena_ctx_t>(used_arena) != expected || used_arena)
+        return 6;
+
+    if (int result = reset_rewinds_arena(expected))
+        return result;
+
+    // no arena must be left installed after the context has finished
+    if (nullptr != boost::wave::util::token_arena::current_arena())
+        return 4;
+
+    // run contexts with private arenas on several threads at once
+    std::vector<std::string> results(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i != results.size(); ++i) {
+        threads.emplace_back([&results, i]() {
+            bool arena_used = false;
+            for (int j = 0; j != 20; ++j)
+                results[i] = preprocess<arena_ctx_t>(arena_used);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+
+    for (auto const& r : results) {
+        if (r != expected)
+            return 5;
+    }
+    return 0;
+}
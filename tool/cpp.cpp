@@ -25,10 +25,14 @@
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/end.hpp>
 #include <boost/foreach.hpp>
+#include <boost/scoped_ptr.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
 //  Include Wave itself
 #include <boost/wave.hpp>
+#include <boost/wave/util/cpp_output_cache.hpp>       // output cache
+#include <boost/wave/util/sha256.hpp>                 // --hash-output
+#include <boost/wave/util/output_sink.hpp>            // buffered output
 
 ///////////////////////////////////////////////////////////////////////////////
 //  Include the lexer related stuff
@@ -36,6 +40,40 @@
 #include <boost/wave/cpplexer/cpp_lex_iterator.hpp>   // lexer type
 
 #include <iostream>
+#include <sstream>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+///////////////////////////////////////////////////////////////////////////////
+//  Include the local sockets used by the server mode, if available
+#include <boost/asio/local/stream_protocol.hpp>
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/placeholders.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <csignal>
+#include <cstdlib>
+
+extern char **environ;
+#endif
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/condition_variable.hpp>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 //  Include serialization support, if requested
@@ -114,7 +152,7 @@ using std::istreambuf_iterator;
 //  define different parameters of the actual preprocessing.
     typedef boost::wave::context<
             std::string::iterator, lex_iterator_type,
-            boost::wave::iteration_context_policies::load_file_to_string,
+            boost::wave::iteration_context_policies::load_minimized_file_to_string,
             trace_macro_expansion<token_type> >
         context_type;
 
@@ -139,7 +177,7 @@ int print_interactive_version()
 
 ///////////////////////////////////////////////////////////////////////////////
 // print the copyright statement
-int print_copyright()
+int print_copyright(std::ostream &outstream = cout)
 {
     char const *copyright[] = {
         "",
@@ -153,7 +191,7 @@ int print_copyright()
     };
 
     for (int i = 0; 0 != copyright[i]; ++i)
-        cout << copyright[i] << endl;
+        outstream << copyright[i] << endl;
 
     return 0;                       // exit app
 }
@@ -191,6 +229,46 @@ namespace cmd_line_utils {
             return pair<std::string, std::string>();
     }
 
+    // Additional command line parser which interprets the gcc style options
+    // '-M' (as --scan-deps), '-MD', '-MF file' and '-MT target', these don't
+    // fit the short options known to program_options. The original tokens are
+    // kept to pass the options on to a server (see --connect).
+    inline vector<po::option>
+    dependency_option_parser(vector<std::string> &args)
+    {
+        vector<po::option> result;
+        std::string const arg(args.front());
+        if ("-M" == arg) {
+            result.push_back(po::option("scan-deps", vector<std::string>()));
+            result.back().original_tokens.push_back(arg);
+            args.erase(args.begin());
+        }
+        else if ("-MD" == arg) {
+            result.push_back(po::option("MD", vector<std::string>()));
+            result.back().original_tokens.push_back(arg);
+            args.erase(args.begin());
+        }
+        else if (0 == arg.compare(0, 3, "-MF") || 0 == arg.compare(0, 3, "-MT")) {
+            vector<std::string> tokens(1, arg);
+            std::string value(arg.substr(3));
+            args.erase(args.begin());
+            if (value.empty()) {
+                if (args.empty()) {
+                    throw po::invalid_command_line_syntax(
+                        po::invalid_command_line_syntax::missing_parameter,
+                        arg.substr(1), arg);
+                }
+                value = args.front();
+                tokens.push_back(value);
+                args.erase(args.begin());
+            }
+            result.push_back(po::option(arg.substr(1, 2),
+                vector<std::string>(1, value)));
+            result.back().original_tokens = tokens;
+        }
+        return result;
+    }
+
     // class, which keeps include file information read from the command line
     class include_paths {
     public:
@@ -231,13 +309,13 @@ namespace cmd_line_utils {
     // given variables_map
     bool read_config_file_options(std::string const &filename,
         po::options_description const &desc, po::variables_map &vm,
-        bool may_fail = false)
+        bool may_fail = false, std::ostream &errstream = cerr)
     {
         ifstream ifs(filename.c_str());
 
         if (!ifs.is_open()) {
             if (!may_fail) {
-                cerr << filename
+                errstream << filename
                     << ": command line warning: config file not found"
                     << endl;
             }
@@ -340,23 +418,11 @@ namespace {
 
     ///////////////////////////////////////////////////////////////////////////
     inline std::string
-    report_iostate_error(std::ios::iostate state)
+    report_write_error(int error)
     {
-        BOOST_ASSERT(state & (std::ios::badbit | std::ios::failbit | std::ios::eofbit));
-        std::string result;
-        if (state & std::ios::badbit) {
-            result += "      the reported problem was: "
-                      "loss of integrity of the stream buffer\n";
-        }
-        if (state & std::ios::failbit) {
-            result += "      the reported problem was: "
-                      "an operation was not processed correctly\n";
-        }
-        if (state & std::ios::eofbit) {
-            result += "      the reported problem was: "
-                      "end-of-file while writing to the stream\n";
-        }
-        return result;
+        BOOST_ASSERT(0 != error);
+        return std::string("      the reported problem was: ") +
+            std::strerror(error) + "\n";
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -380,10 +446,11 @@ namespace {
     //  Generate some meaningful error messages
     template <typename Exception>
     inline int
-    report_error_message(Exception const &e, bool treat_warnings_as_error)
+    report_error_message(Exception const &e, bool treat_warnings_as_error,
+        std::ostream &errstream = cerr)
     {
         // default error reporting
-        cerr
+        errstream
             << e.file_name() << ":" << e.line_no() << ":" << e.column_no()
             << ": " << e.description() << endl;
 
@@ -396,10 +463,10 @@ namespace {
     template <typename Context>
     inline int
     report_error_message(Context &ctx, boost::wave::cpp_exception const &e,
-        bool treat_warnings_as_error)
+        bool treat_warnings_as_error, std::ostream &errstream = cerr)
     {
         // default error reporting
-        int result = report_error_message(e, treat_warnings_as_error);
+        int result = report_error_message(e, treat_warnings_as_error, errstream);
 
         using boost::wave::preprocess_exception;
         switch(e.get_errorcode()) {
@@ -408,14 +475,14 @@ namespace {
                 // report the point of the initial macro definition
                 typename Context::position_type pos;
                 if (get_macro_position(ctx, e.get_related_name(), pos)) {
-                    cerr
+                    errstream
                         << pos << ": "
                         << preprocess_exception::severity_text(e.get_severity())
                         << ": this is the location of the previous definition."
                         << endl;
                 }
                 else {
-                    cerr
+                    errstream
                         << e.file_name() << ":" << e.line_no() << ":"
                         << e.column_no() << ": "
                         << preprocess_exception::severity_text(e.get_severity())
@@ -541,27 +608,29 @@ namespace {
 
     ///////////////////////////////////////////////////////////////////////////
     // list all defined macros
-    bool list_macro_names(context_type const& ctx, std::string filename)
+    bool list_macro_names(context_type const& ctx, std::string filename,
+        std::ostream &outstream = cout, std::ostream &errstream = cerr)
     {
     // open file for macro names listing
         ofstream macronames_out;
         fs::path macronames_file (boost::wave::util::create_path(filename));
 
         if (macronames_file != "-") {
-            macronames_file = boost::wave::util::complete_path(macronames_file);
+            macronames_file = boost::wave::util::complete_path(macronames_file,
+                ctx.get_base_directory());
             boost::wave::util::create_directories(
                 boost::wave::util::branch_path(macronames_file));
             macronames_out.open(macronames_file.string().c_str());
             if (!macronames_out.is_open()) {
-                cerr << "wave: could not open file for macro name listing: "
+                errstream << "wave: could not open file for macro name listing: "
                      << macronames_file.string() << endl;
                 return false;
             }
         }
         else {
-            macronames_out.copyfmt(cout);
-            macronames_out.clear(cout.rdstate());
-            static_cast<std::basic_ios<char> &>(macronames_out).rdbuf(cout.rdbuf());
+            macronames_out.copyfmt(outstream);
+            macronames_out.clear(outstream.rdstate());
+            static_cast<std::basic_ios<char> &>(macronames_out).rdbuf(outstream.rdbuf());
         }
 
     // simply list all defined macros and its definitions
@@ -611,27 +680,29 @@ namespace {
 
     ///////////////////////////////////////////////////////////////////////////
     // list macro invocation counts
-    bool list_macro_counts(context_type const& ctx, std::string filename)
+    bool list_macro_counts(context_type const& ctx, std::string filename,
+        std::ostream &outstream = cout, std::ostream &errstream = cerr)
     {
     // open file for macro invocation count listing
         ofstream macrocounts_out;
         fs::path macrocounts_file (boost::wave::util::create_path(filename));
 
         if (macrocounts_file != "-") {
-            macrocounts_file = boost::wave::util::complete_path(macrocounts_file);
+            macrocounts_file = boost::wave::util::complete_path(macrocounts_file,
+                ctx.get_base_directory());
             boost::wave::util::create_directories(
                 boost::wave::util::branch_path(macrocounts_file));
             macrocounts_out.open(macrocounts_file.string().c_str());
             if (!macrocounts_out.is_open()) {
-                cerr << "wave: could not open file for macro invocation count listing: "
+                errstream << "wave: could not open file for macro invocation count listing: "
                      << macrocounts_file.string() << endl;
                 return false;
             }
         }
         else {
-            macrocounts_out.copyfmt(cout);
-            macrocounts_out.clear(cout.rdstate());
-            static_cast<std::basic_ios<char> &>(macrocounts_out).rdbuf(cout.rdbuf());
+            macrocounts_out.copyfmt(outstream);
+            macrocounts_out.clear(outstream.rdstate());
+            static_cast<std::basic_ios<char> &>(macrocounts_out).rdbuf(outstream.rdbuf());
         }
 
         // list all expanded macro names and their counts in alphabetical order
@@ -646,6 +717,195 @@ namespace {
         return true;
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    // print the statistics of the internal caches to stderr
+    void print_cache_statistics(context_type const& ctx,
+        std::ostream &errstream = cerr)
+    {
+#if BOOST_WAVE_CACHE_CONDITIONAL_EXPRESSIONS != 0
+        boost::wave::util::conditional_expression_cache const& condexprs =
+            ctx.get_conditional_expression_cache();
+        std::size_t lookups = condexprs.get_hits() + condexprs.get_misses();
+
+        errstream << "wave: #if/#elif expression cache: "
+             << condexprs.get_hits() << " hits, "
+             << condexprs.get_misses() << " misses ("
+             << (lookups ? 100.0 * condexprs.get_hits() / lookups : 0.0)
+             << "% hit rate), " << condexprs.size() << " entries";
+        if (!condexprs.is_enabled())
+            errstream << " (disabled)";
+        errstream << endl;
+#else
+        errstream << "wave: #if/#elif expression cache: not configured" << endl;
+#endif
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        boost::wave::util::include_lookup_cache const& includes =
+            ctx.get_include_lookup_cache();
+        std::size_t include_lookups = includes.get_hits() + includes.get_misses();
+        std::size_t probes = includes.get_probe_hits() + includes.get_probe_misses();
+
+        errstream << "wave: include lookup cache: "
+             << includes.get_hits() << " hits, "
+             << includes.get_misses() << " misses ("
+             << (include_lookups ? 100.0 * includes.get_hits() / include_lookups : 0.0)
+             << "% hit rate), " << includes.size() << " entries";
+        if (!includes.is_enabled())
+            errstream << " (disabled)";
+        errstream << endl;
+        errstream << "wave: include file probes: "
+             << includes.get_probe_hits() << " hits, "
+             << includes.get_probe_misses() << " misses ("
+             << (probes ? 100.0 * includes.get_probe_hits() / probes : 0.0)
+             << "% hit rate), " << includes.probes_size() << " entries ("
+             << includes.get_negative_probes() << " negative)" << endl;
+#else
+        errstream << "wave: include lookup cache: not configured" << endl;
+#endif
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        boost::wave::util::include_database const* database =
+            ctx.get_include_database();
+        if (0 != database) {
+            std::size_t database_lookups =
+                database->get_hits() + database->get_misses();
+
+            errstream << "wave: include database: "
+                 << database->get_hits() << " hits, "
+                 << database->get_misses() << " misses ("
+                 << (database_lookups ?
+                        100.0 * database->get_hits() / database_lookups : 0.0)
+                 << "% hit rate), " << database->size() << " entries, "
+                 << database->get_directories() << " directories, "
+                 << database->get_invalidated() << " outdated entries dropped ("
+                 << database->get_configurations() << " configurations)"
+                 << endl;
+        }
+#endif
+
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+        boost::wave::util::directory_snapshots const& snapshots =
+            ctx.get_directory_snapshots();
+
+        errstream << "wave: include directory snapshots: "
+             << snapshots.size() << " directories, "
+             << snapshots.get_entries() << " entries, "
+             << snapshots.get_lookups() << " lookups ("
+             << snapshots.get_unknown() << " left to the file system)";
+        if (!snapshots.is_enabled())
+            errstream << " (disabled)";
+        errstream << endl;
+#else
+        errstream << "wave: include directory snapshots: not configured" << endl;
+#endif
+
+        // the caches shared with other contexts (f.e. in batch or server
+        // mode), these count the lookups of all contexts so far
+        boost::wave::shared_resources const* resources =
+            ctx.get_shared_resources();
+        if (0 != resources) {
+            errstream << "wave: shared caches: "
+                 << resources->get_file_hits() << " file hits, "
+                 << resources->get_file_misses() << " file misses, "
+                 << resources->get_resolution_hits() << " lookup hits, "
+                 << resources->get_resolution_misses() << " lookup misses, "
+                 << resources->get_invalidated() << " outdated entries dropped, "
+                 << resources->get_evicted() << " entries evicted"
+                 << endl;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the name of the output file generated for an input file, if no output
+    // file is specified: <input_base_name>.i
+    fs::path auto_output_name(std::string const &file_name)
+    {
+        fs::path out_file(boost::wave::util::create_path(file_name));
+        std::string basename(boost::wave::util::leaf(out_file));
+        std::string::size_type pos = basename.find_last_of(".");
+
+        if (std::string::npos != pos)
+            basename = basename.substr(0, pos);
+        return boost::wave::util::branch_path(out_file) / (basename + ".i");
+    }
+
+    // replace the extension of the given file name (or add one)
+    std::string replace_extension(std::string const &file_name,
+        std::string const &extension)
+    {
+        fs::path file(boost::wave::util::create_path(file_name));
+        std::string basename(boost::wave::util::leaf(file));
+        std::string::size_type pos = basename.find_last_of(".");
+
+        if (std::string::npos != pos)
+            basename = basename.substr(0, pos);
+        return (boost::wave::util::branch_path(file) /
+            (basename + extension)).string();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // write the names of the files the input depends on as a make rule
+    std::string escape_make_name(std::string const &name)
+    {
+        std::string result;
+        for (std::string::size_type i = 0; i < name.size(); ++i) {
+            if (' ' == name[i] || '#' == name[i])
+                result += '\\';
+            else if ('$' == name[i])
+                result += '$';
+            result += name[i];
+        }
+        return result;
+    }
+
+    void write_make_dependencies(std::ostream &out, std::string const &target,
+        std::vector<std::string> const &dependencies)
+    {
+        out << escape_make_name(target) << ":";
+        for (std::size_t i = 0; i < dependencies.size(); ++i) {
+            if (i > 0)
+                out << " \\\n ";
+            out << " " << escape_make_name(dependencies[i]);
+        }
+        out << "\n";
+    }
+
+    // write the names of the files the input depends on as a JSON object
+    std::string escape_json_string(std::string const &str)
+    {
+        std::string result("\"");
+        for (std::string::size_type i = 0; i < str.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(str[i]);
+            if ('"' == c || '\\' == c) {
+                result += '\\';
+                result += c;
+            }
+            else if (c < 0x20) {
+                char buffer[8];
+                std::sprintf(buffer, "\\u%04x", c);
+                result += buffer;
+            }
+            else {
+                result += c;
+            }
+        }
+        return result + "\"";
+    }
+
+    void write_json_dependencies(std::ostream &out, std::string const &input,
+        std::string const &target, std::vector<std::string> const &dependencies)
+    {
+        out << "{\n"
+            << "  \"input\": " << escape_json_string(input) << ",\n"
+            << "  \"target\": " << escape_json_string(target) << ",\n"
+            << "  \"dependencies\": [";
+        for (std::size_t i = 0; i < dependencies.size(); ++i) {
+            out << (i > 0 ? ",\n    " : "\n    ")
+                << escape_json_string(dependencies[i]);
+        }
+        out << (dependencies.empty() ? "]\n" : "\n  ]\n") << "}\n";
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // read all of a file into a string
     std::string read_entire_file(std::istream& instream)
@@ -665,21 +925,361 @@ namespace {
 #endif
         return content;
     }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // write a string to a file, creating its directory if necessary
+    bool write_entire_file(fs::path const &file, std::string const &content)
+    {
+        boost::wave::util::create_directories(
+            boost::wave::util::branch_path(file));
+        ofstream out(file.string().c_str(), std::ios::out | std::ios::binary);
+        out.write(content.data(), std::streamsize(content.size()));
+        return out.good();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // collect the text written to a stream while passing it on (the output
+    // and the messages of a run are stored in the output cache)
+    class stream_capture
+    :   public std::streambuf
+    {
+    public:
+        explicit stream_capture(std::ostream &stream_)
+        :   stream(stream_), target(stream_.rdbuf())
+        {
+            stream.rdbuf(this);
+        }
+        ~stream_capture()
+        {
+            stream.rdbuf(target);
+        }
+
+        std::string const &get_text() const { return text; }
+
+    protected:
+        int_type overflow(int_type c)
+        {
+            if (traits_type::eq_int_type(c, traits_type::eof()))
+                return traits_type::not_eof(c);
+            text += traits_type::to_char_type(c);
+            return target->sputc(traits_type::to_char_type(c));
+        }
+        std::streamsize xsputn(char const *s, std::streamsize n)
+        {
+            text.append(s, std::size_t(n));
+            return target->sputn(s, n);
+        }
+        int sync()
+        {
+            return target->pubsync();
+        }
+
+    private:
+        std::ostream &stream;
+        std::streambuf *target;
+        std::string text;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the incremental digest of the generated output (--hash-output), fed
+    // with the token values instead of writing them
+    class output_digest
+    {
+    public:
+        static bool is_valid_algorithm(std::string const &name)
+        {
+            return "sha256" == name || "fnv1a" == name;
+        }
+
+        explicit output_digest(std::string const &algorithm_)
+        :   use_sha256("sha256" == algorithm_), fnv1a(14695981039346656037ULL)
+        {}
+
+        void update(char const *data, std::size_t size)
+        {
+            if (use_sha256) {
+                sha256.update(data, size);
+            }
+            else {
+                for (std::size_t i = 0; i < size; ++i) {
+                    fnv1a ^= (unsigned char)data[i];
+                    fnv1a *= 1099511628211ULL;
+                }
+            }
+        }
+        template <typename String>
+        void update(String const &value) { update(value.data(), value.size()); }
+
+        // the digest as a string of hex digits
+        std::string finish()
+        {
+            if (use_sha256)
+                return boost::wave::util::sha256::to_hex(sha256.finish());
+
+            std::string digest(8, '\0');
+            for (int i = 0; i < 8; ++i)
+                digest[i] = char((fnv1a >> (56 - 8 * i)) & 0xff);
+            return boost::wave::util::sha256::to_hex(digest);
+        }
+
+    private:
+        bool use_sha256;
+        boost::wave::util::sha256 sha256;
+        boost::uint64_t fnv1a;      // 64 bit FNV-1a
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // passes the generated tokens to the output (or to its digest), storing
+    // the position of the last one for error reports
+    class output_writer
+    {
+    public:
+        output_writer(boost::wave::util::output_sink &output_,
+                output_digest *digest_, bool const &allow_output_,
+                bool scan_only_,
+                boost::wave::util::file_position_type &current_position_)
+        :   output(output_), digest(digest_), allow_output(allow_output_),
+            scan_only(scan_only_), current_position(current_position_)
+        {}
+
+        void operator()(token_type const &token) const
+        {
+            // store the last known good token position
+            current_position = token.get_position();
+
+            // print out the current token value (allow_output may be changed
+            // by the hooks)
+            if (!allow_output || scan_only)
+                return;
+
+            token_type::string_type const &value = token.get_value();
+            if (0 != digest)
+                digest->update(value.data(), value.size());
+            else
+                output.write(value.data(), value.size());
+        }
+
+    private:
+        boost::wave::util::output_sink &output;
+        output_digest *digest;
+        bool const &allow_output;
+        bool scan_only;
+        boost::wave::util::file_position_type &current_position;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the options not influencing the generated output, these aren't part of
+    // the key of the output cache
+    bool is_irrelevant_for_output_cache(std::string const &option)
+    {
+        static char const *const names[] = {
+            "output-cache", "output-cache-size", "output-cache-stats",
+            "cachestats", "timer", "jobs", "batch", "batch-list",
+            "config-file", "output", "async-output", "serve-cache-size", 0
+        };
+        for (int i = 0; 0 != names[i]; ++i) {
+            if (option == names[i])
+                return true;
+        }
+        return false;
+    }
+
+    // describe all the output of a run depends on apart from the included
+    // files, returns false if an option can't be described
+    bool describe_output_cache_key(context_type &ctx,
+        po::variables_map const &vm, std::string const &file_name,
+        std::string const &out_name, std::string const &instring,
+        std::string &key)
+    {
+        // the name of the output file matters only as the target of the
+        // list of dependencies
+        std::string output("<file>");
+        if (out_name.empty() || "-" == out_name || vm.count("MD"))
+            output = out_name;
+
+        std::ostringstream description;
+        description << "wave " << get_version() << '\0'
+            << ctx.get_base_directory().string() << '\0'
+            << file_name << '\0' << output << '\0'
+            << boost::wave::util::sha256::hex_digest(instring) << '\0'
+            << unsigned(ctx.get_language()) << '\0';
+
+        // the options
+        po::variables_map::const_iterator end = vm.end();
+        for (po::variables_map::const_iterator it = vm.begin(); it != end; ++it)
+        {
+            if (is_irrelevant_for_output_cache((*it).first))
+                continue;
+
+            boost::any const &value = (*it).second.value();
+            description << (*it).first << '=';
+            if (value.empty()) {
+                // a switch
+            }
+            else if (std::string const *s = boost::any_cast<std::string>(&value)) {
+                description << *s;
+            }
+            else if (int const *i = boost::any_cast<int>(&value)) {
+                description << *i;
+            }
+            else if (unsigned int const *u = boost::any_cast<unsigned int>(&value)) {
+                description << *u;
+            }
+            else if (std::vector<std::string> const *v =
+                boost::any_cast<std::vector<std::string> >(&value))
+            {
+                for (std::size_t i = 0; i < v->size(); ++i)
+                    description << (*v)[i] << '\0';
+            }
+            else if (cmd_line_utils::include_paths const *p =
+                boost::any_cast<cmd_line_utils::include_paths>(&value))
+            {
+                for (std::size_t i = 0; i < p->paths.size(); ++i)
+                    description << p->paths[i] << '\0';
+                description << "-I-" << p->seen_separator << '\0';
+                for (std::size_t i = 0; i < p->syspaths.size(); ++i)
+                    description << p->syspaths[i] << '\0';
+            }
+            else {
+                return false;
+            }
+            description << '\0';
+        }
+
+        // the initial macro definitions (except for the current time)
+        typedef context_type::const_name_iterator name_iterator;
+        name_iterator names_end = ctx.macro_names_end();
+        for (name_iterator it = ctx.macro_names_begin(); it != names_end; ++it)
+        {
+            if (*it == "__DATE__" || *it == "__TIME__")
+                continue;
+
+            bool has_parameters = false;
+            bool is_predefined = false;
+            context_type::position_type pos;
+            std::vector<context_type::token_type> parameters;
+            context_type::token_sequence_type definition;
+            if (!ctx.get_macro_definition(*it, has_parameters, is_predefined,
+                    pos, parameters, definition))
+            {
+                continue;
+            }
+
+            description << *it << (is_predefined ? "=P" : "=D");
+            if (has_parameters) {
+                description << '(';
+                for (std::size_t i = 0; i < parameters.size(); ++i)
+                    description << parameters[i].get_value() << ',';
+                description << ')';
+            }
+            context_type::token_sequence_type::const_iterator dend =
+                definition.end();
+            for (context_type::token_sequence_type::const_iterator dit =
+                    definition.begin(); dit != dend; ++dit)
+            {
+                description << (*dit).get_value();
+            }
+            description << '\0';
+        }
+
+        key = description.str();
+        return true;
+    }
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    // the statistics of the output cache are updated by one thread at a time
+    boost::mutex output_cache_mutex;
+#endif
+
+    void save_output_cache_statistics(
+        boost::wave::util::output_cache &output_cache)
+    {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        boost::lock_guard<boost::mutex> lock(output_cache_mutex);
+#endif
+        output_cache.save_statistics();
+    }
+
+    // emit the result of an earlier run as if the input was preprocessed
+    int write_cached_output(
+        boost::wave::util::output_cache::result const &cached,
+        std::string const &file_name, std::string const &out_name,
+        std::string const &deps_name, po::variables_map const &vm,
+        fs::path const &base_dir, std::ostream &outstream,
+        std::ostream &errstream)
+    {
+        fs::path out_file;
+        if (!out_name.empty() && "-" != out_name) {
+            out_file = boost::wave::util::complete_path(
+                boost::wave::util::create_path(out_name), base_dir);
+        }
+        else if (out_name.empty() && vm.count("autooutput")) {
+            out_file = auto_output_name(file_name);
+        }
+        else if (out_name.empty()) {
+            outstream << cached.output;     // anything written to stdout
+        }
+
+        if (!out_file.empty() && !write_entire_file(out_file, cached.output)) {
+            errstream << "wave: could not write output file: "
+                 << out_file.string() << endl;
+            return -1;
+        }
+        if (!cached.dependencies.empty() && !deps_name.empty() &&
+            "-" != deps_name)
+        {
+            fs::path deps_file(boost::wave::util::create_path(deps_name));
+            if (!write_entire_file(deps_file, cached.dependencies)) {
+                errstream << "wave: could not open dependency file: "
+                     << deps_file.string() << endl;
+                return -1;
+            }
+        }
+        errstream << cached.messages;
+        return 0;
+    }
+
+    // print the statistics kept in the given cache directory
+    void print_output_cache_statistics(std::string const &directory,
+        std::ostream &outstream)
+    {
+        typedef boost::wave::util::output_cache::statistics statistics;
+
+        statistics stats;
+        boost::wave::util::output_cache::read_statistics(directory, stats);
+        boost::uint64_t const lookups = stats.hits + stats.misses;
+        outstream << "output cache: " << directory << "\n"
+            << "  hits:        " << stats.hits << " ("
+            << (lookups ? 100.0 * stats.hits / lookups : 0.0)
+            << "% hit rate)\n"
+            << "  misses:      " << stats.misses << "\n"
+            << "  uncacheable: " << stats.uncacheable << "\n"
+            << "  stored:      " << stats.stored << "\n"
+            << "  evicted:     " << stats.evicted << "\n"
+            << "  size:        " << stats.size / 1024 << " KB" << endl;
+    }
 }   // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////
 //  do the actual preprocessing
 int
 do_actual_work (std::string file_name, std::istream &instream,
-    po::variables_map const &vm, bool input_is_stdin)
+    po::variables_map const &vm, bool input_is_stdin,
+    std::string const &output_name = std::string(),
+    std::ostream &outstream = cout, std::ostream &errstream = cerr,
+    boost::wave::shared_resources *resources = 0,
+    fs::path const &base_dir = boost::wave::util::initial_path())
 {
     // current file position is saved for exception handling
     boost::wave::util::file_position_type current_position;
-    auto_stop_watch elapsed_time(cerr);
+    auto_stop_watch elapsed_time(errstream);
     int error_count = 0;
     const bool treat_warnings_as_error = vm.count("warning") &&
                                          boost::algorithm::any_of_equal(
                                              vm["warning"].as<std::vector<std::string> >(), "error");
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+    boost::wave::util::include_database include_db;
+#endif
 
     try {
         // process the given file
@@ -691,7 +1291,10 @@ do_actual_work (std::string file_name, std::istream &instream,
 
         // The preprocessing of the input stream is done on the fly behind the
         // scenes during iteration over the context_type::iterator_type stream.
-        ofstream output;
+        boost::wave::util::output_sink output(outstream);
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        output.set_asynchronous(vm.count("async-output") > 0);
+#endif
         ofstream traceout;
         ofstream includelistout;
         ofstream listguardsout;
@@ -708,7 +1311,7 @@ do_actual_work (std::string file_name, std::istream &instream,
                     boost::wave::util::branch_path(trace_file));
                 traceout.open(trace_file.string().c_str());
                 if (!traceout.is_open()) {
-                    cerr << "wave: could not open trace file: " << trace_file
+                    errstream << "wave: could not open trace file: " << trace_file
                          << endl;
                     return -1;
                 }
@@ -717,9 +1320,9 @@ do_actual_work (std::string file_name, std::istream &instream,
         }
         if ((enable_trace & trace_macros) && !traceout.is_open()) {
             // by default trace to std::cerr
-            traceout.copyfmt(cerr);
-            traceout.clear(cerr.rdstate());
-            static_cast<std::basic_ios<char> &>(traceout).rdbuf(cerr.rdbuf());
+            traceout.copyfmt(errstream);
+            traceout.clear(errstream.rdstate());
+            static_cast<std::basic_ios<char> &>(traceout).rdbuf(errstream.rdbuf());
         }
 
         // Open the stream where to output the list of included file names
@@ -733,7 +1336,7 @@ do_actual_work (std::string file_name, std::istream &instream,
                     boost::wave::util::branch_path(includes_file));
                 includelistout.open(includes_file.string().c_str());
                 if (!includelistout.is_open()) {
-                    cerr << "wave: could not open include list file: "
+                    errstream << "wave: could not open include list file: "
                          << includes_file.string() << endl;
                     return -1;
                 }
@@ -742,10 +1345,10 @@ do_actual_work (std::string file_name, std::istream &instream,
         }
         if ((enable_trace & trace_includes) && !includelistout.is_open()) {
             // by default list included names to std::cout
-            includelistout.copyfmt(cout);
-            includelistout.clear(cout.rdstate());
+            includelistout.copyfmt(outstream);
+            includelistout.clear(outstream.rdstate());
             static_cast<std::basic_ios<char> &>(includelistout).
-                rdbuf(cout.rdbuf());
+                rdbuf(outstream.rdbuf());
         }
 
         // Open the stream where to output the list of included file names
@@ -759,7 +1362,7 @@ do_actual_work (std::string file_name, std::istream &instream,
                     boost::wave::util::branch_path(listguards_file));
                 listguardsout.open(listguards_file.string().c_str());
                 if (!listguardsout.is_open()) {
-                    cerr << "wave: could not open include guard list file: "
+                    errstream << "wave: could not open include guard list file: "
                          << listguards_file.string() << endl;
                     return -1;
                 }
@@ -768,10 +1371,69 @@ do_actual_work (std::string file_name, std::istream &instream,
         }
         if ((enable_trace & trace_guards) && !listguardsout.is_open()) {
             // by default list included names to std::cout
-            listguardsout.copyfmt(cout);
-            listguardsout.clear(cout.rdstate());
+            listguardsout.copyfmt(outstream);
+            listguardsout.clear(outstream.rdstate());
             static_cast<std::basic_ios<char> &>(listguardsout).
-                rdbuf(cout.rdbuf());
+                rdbuf(outstream.rdbuf());
+        }
+
+        // collect the names of the included files, if a list of the
+        // dependencies is requested
+        bool const scan_only = vm.count("scan-deps") > 0;
+        std::string deps_format("make");
+        if (vm.count("deps-format")) {
+            deps_format = vm["deps-format"].as<std::string>();
+            if ("make" != deps_format && "json" != deps_format) {
+                errstream << "wave: bogus value for --deps-format command line "
+                    << "option: " << deps_format << ", should be make or json"
+                    << endl;
+                return -1;
+            }
+        }
+        if (scan_only || vm.count("MD"))
+            enable_trace = trace_flags(enable_trace | trace_dependencies);
+
+        // write the digest of the output only, if requested
+        boost::scoped_ptr<output_digest> digest;
+        if (vm.count("hash-output")) {
+            std::string const algorithm(vm["hash-output"].as<std::string>());
+            if (!output_digest::is_valid_algorithm(algorithm)) {
+                errstream << "wave: bogus value for --hash-output command line "
+                    << "option: " << algorithm << ", should be sha256 or fnv1a"
+                    << endl;
+                return -1;
+            }
+            if (!scan_only)
+                digest.reset(new output_digest(algorithm));
+        }
+
+        // reuse the output of earlier runs with the same inputs, unless
+        // anything but the output (and the list of dependencies) is requested
+        boost::wave::util::output_cache output_cache;
+        bool const use_output_cache = vm.count("output-cache") &&
+            !input_is_stdin && !scan_only && !vm.count("traceto") &&
+            !vm.count("listincludes") && !vm.count("listguards") &&
+            !vm.count("macronames") && !vm.count("macrocounts") &&
+            !vm.count("extended") && !vm.count("state");
+        if (vm.count("output-cache")) {
+            std::string const directory(vm["output-cache"].as<std::string>());
+            unsigned int max_size = 1024;       // MB
+            if (vm.count("output-cache-size"))
+                max_size = vm["output-cache-size"].as<unsigned int>();
+            if (!output_cache.open(directory,
+                    boost::uint64_t(max_size) * 1024 * 1024))
+            {
+                errstream << "wave: could not open the output cache: "
+                    << directory << endl;
+                return -1;
+            }
+            if (use_output_cache) {
+                enable_trace = trace_flags(enable_trace | trace_inputs);
+            }
+            else {
+                output_cache.count_uncacheable();
+                save_output_cache_statistics(output_cache);
+            }
         }
 
         // enable preserving comments mode
@@ -800,7 +1462,7 @@ do_actual_work (std::string file_name, std::istream &instream,
                 break;
 
             default:
-                cerr << "wave: bogus preserve whitespace option value: "
+                errstream << "wave: bogus preserve whitespace option value: "
                      << preserve << ", should be 0, 1, 2, or 3" << endl;
                 return -1;
             }
@@ -836,7 +1498,7 @@ do_actual_work (std::string file_name, std::istream &instream,
             ifstream license_stream(license_file.c_str());
 
             if (!license_stream.is_open()) {
-                cerr << "wave: could not open specified license file: "
+                errstream << "wave: could not open specified license file: "
                       << license_file << endl;
                 return -1;
             }
@@ -846,12 +1508,16 @@ do_actual_work (std::string file_name, std::istream &instream,
 
         context_type ctx(instring.begin(), instring.end(), file_name.c_str(), hooks);
 
+        // complete the relative paths against the directory of this run (the
+        // server runs the requests in the directories of their clients)
+        ctx.set_base_directory(base_dir);
+
 #if BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
         // enable C99 mode, if appropriate (implies variadics)
         if (vm.count("c99")) {
 #if BOOST_WAVE_SUPPORT_CPP0X != 0
             if (vm.count("c++11")) {
-                cerr << "wave: multiple language options specified: --c99 "
+                errstream << "wave: multiple language options specified: --c99 "
                         "and --c++11" << endl;
                 return -1;
             }
@@ -878,7 +1544,7 @@ do_actual_work (std::string file_name, std::istream &instream,
 #if BOOST_WAVE_SUPPORT_CPP0X != 0
         if (vm.count("c++11")) {
             if (vm.count("c99")) {
-                cerr << "wave: multiple language options specified: --c99 "
+                errstream << "wave: multiple language options specified: --c99 "
                         "and --c++11" << endl;
                 return -1;
             }
@@ -986,6 +1652,34 @@ do_actual_work (std::string file_name, std::istream &instream,
         }
 #endif
 
+        // disable the snapshots of the include directories and the cached
+        // include file lookups, both would miss files created meanwhile
+        if (vm.count("nosnapshots")) {
+#if BOOST_WAVE_SNAPSHOT_INCLUDE_DIRECTORIES != 0
+            ctx.get_directory_snapshots().enable(false);
+#endif
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+            ctx.get_include_lookup_cache().enable(false);
+#endif
+        }
+        else if (0 != resources) {
+            // share the included files and the include file lookups with the
+            // other files of the batch
+            ctx.set_shared_resources(resources);
+        }
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        // reuse the include file lookups of earlier runs
+        if (vm.count("include-db")) {
+            std::string db_file(vm["include-db"].as<std::string>());
+            if (!include_db.load(db_file)) {
+                errstream << "wave: ignoring the corrupt include database: "
+                     << db_file << endl;
+            }
+            ctx.set_include_database(&include_db);
+        }
+#endif
+
         // enable preserving comments mode
         if (preserve_comments) {
             ctx.set_language(
@@ -996,7 +1690,7 @@ do_actual_work (std::string file_name, std::istream &instream,
         if (vm.count("line")) {
             int lineopt = vm["line"].as<int>();
             if (0 != lineopt && 1 != lineopt && 2 != lineopt) {
-                cerr << "wave: bogus value for --line command line option: "
+                errstream << "wave: bogus value for --line command line option: "
                     << lineopt << endl;
                 return -1;
             }
@@ -1012,7 +1706,7 @@ do_actual_work (std::string file_name, std::istream &instream,
         if (vm.count("disambiguate")) {
             int disambiguateopt = vm["disambiguate"].as<int>();
             if (0 != disambiguateopt && 1 != disambiguateopt) {
-                cerr << "wave: bogus value for --disambiguate command line option: "
+                errstream << "wave: bogus value for --disambiguate command line option: "
                     << disambiguateopt << endl;
                 return -1;
             }
@@ -1021,6 +1715,41 @@ do_actual_work (std::string file_name, std::istream &instream,
                     disambiguateopt != 0));
         }
 
+        // scan for the dependencies only: evaluate the directives and skip
+        // everything else, this doesn't generate any output
+        if (scan_only) {
+            boost::wave::language_support lang = ctx.get_language();
+            lang = boost::wave::enable_scan_dependencies(lang);
+            lang = boost::wave::enable_emit_line_directives(lang, false);
+            lang = boost::wave::enable_insert_whitespace(lang, false);
+            ctx.set_language(lang);
+        }
+        else if (vm.count("directives-only")) {
+            // evaluate the directives and pass the text through unchanged
+            ctx.set_language(
+                boost::wave::enable_directives_only(ctx.get_language()));
+        }
+
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+        // add header maps to the system include search paths, these are
+        // searched before the system include directories
+        if (vm.count("headermap")) {
+            vector<std::string> maps = vm["headermap"].as<vector<std::string> >();
+
+            vector<std::string>::const_iterator end = maps.end();
+            for (vector<std::string>::const_iterator cit = maps.begin();
+                 cit != end; ++cit)
+            {
+                std::string map(cmd_line_utils::trim_quotes(*cit));
+                if (!ctx.add_header_map(map.c_str(), true)) {
+                    errstream << "wave: could not load header map: " << map
+                        << endl;
+                    return -1;
+                }
+            }
+        }
+#endif
+
         // add include directories to the system include search paths
         if (vm.count("sysinclude")) {
             vector<std::string> syspaths = vm["sysinclude"].as<vector<std::string> >();
@@ -1109,64 +1838,129 @@ do_actual_work (std::string file_name, std::istream &instream,
         if (vm.count("nesting")) {
             int max_depth = vm["nesting"].as<int>();
             if (max_depth < 1 || max_depth > 100000) {
-                cerr << "wave: bogus maximal include nesting depth: "
+                errstream << "wave: bogus maximal include nesting depth: "
                     << max_depth << endl;
                 return -1;
             }
             ctx.set_max_include_nesting_depth(max_depth);
         }
 
-        // open the output file
-        if (vm.count("output")) {
+        // open the output file (the batch mode passes the name of the output
+        // file for every input file)
+        std::string out_name(output_name);
+        if (out_name.empty() && vm.count("output"))
+            out_name = vm["output"].as<std::string>();
+
+        // the list of dependencies goes to the file given by -MF, to the
+        // output file if scanning for the dependencies only, or to a file
+        // named <output_basename>.d
+        std::string deps_name;
+        std::string deps_target;
+        if (vm.count("MF"))
+            deps_name = vm["MF"].as<std::string>();
+        else if (scan_only)
+            deps_name = out_name;
+        else if (vm.count("MD")) {
+            if (!out_name.empty() && "-" != out_name)
+                deps_name = replace_extension(out_name, ".d");
+            else if (!input_is_stdin)
+                deps_name = replace_extension(file_name, ".d");
+        }
+
+        // the target of the make rule is the output file or <input_basename>.o
+        if (vm.count("MT"))
+            deps_target = vm["MT"].as<std::string>();
+        else if (!scan_only && !out_name.empty() && "-" != out_name)
+            deps_target = out_name;
+        else if (!scan_only && !input_is_stdin && vm.count("autooutput"))
+            deps_target = auto_output_name(file_name).string();
+        else {
+            deps_target = boost::wave::util::leaf(boost::wave::util::create_path(
+                replace_extension(file_name, ".o")));
+        }
+
+        // look for the result of an earlier run, otherwise collect the text
+        // written to stdout and stderr to store it later
+        std::string cache_key;
+        std::time_t const started = std::time(0);
+        bool store_output = false;
+        boost::scoped_ptr<stream_capture> captured_output;
+        boost::scoped_ptr<stream_capture> captured_messages;
+        if (use_output_cache) {
+            if (describe_output_cache_key(ctx, vm, file_name, out_name,
+                    instring, cache_key))
+            {
+                boost::wave::util::output_cache::result cached;
+                if (output_cache.find(cache_key, cached)) {
+                    save_output_cache_statistics(output_cache);
+                    if (vm.count("cachestats"))
+                        errstream << "wave: output cache: hit" << endl;
+                    return write_cached_output(cached, file_name, out_name,
+                        deps_name, vm, base_dir, outstream, errstream);
+                }
+                store_output = true;
+                captured_messages.reset(new stream_capture(errstream));
+                if (out_name.empty() && !vm.count("autooutput"))
+                    captured_output.reset(new stream_capture(outstream));
+            }
+            else {
+                output_cache.count_uncacheable();
+                save_output_cache_statistics(output_cache);
+            }
+        }
+
+        if (scan_only) {
+            // no output is generated
+        }
+        else if (!out_name.empty()) {
             // try to open the file, where to put the preprocessed output
-            fs::path out_file(boost::wave::util::create_path(
-                vm["output"].as<std::string>()));
+            fs::path out_file(boost::wave::util::create_path(out_name));
 
             if (out_file == "-") {
                 allow_output = false;     // inhibit output initially
                 default_outfile = "-";
             }
             else {
-                out_file = boost::wave::util::complete_path(out_file);
+                out_file = boost::wave::util::complete_path(out_file,
+                    base_dir);
                 boost::wave::util::create_directories(
                     boost::wave::util::branch_path(out_file));
                 output.open(out_file.string().c_str());
                 if (!output.is_open()) {
-                    cerr << "wave: could not open output file: "
+                    errstream << "wave: could not open output file: "
                          << out_file.string() << endl;
                     return -1;
                 }
-                if (!license.empty())
-                    output << license;
+                if (!license.empty() && digest)
+                    digest->update(license);
+                else if (!license.empty())
+                    output.write(license);
                 default_outfile = out_file.string();
             }
         }
         else if (!input_is_stdin && vm.count("autooutput")) {
             // generate output in the file <input_base_name>.i
-            fs::path out_file(boost::wave::util::create_path(file_name));
-            std::string basename(boost::wave::util::leaf(out_file));
-            std::string::size_type pos = basename.find_last_of(".");
-
-            if (std::string::npos != pos)
-                basename = basename.substr(0, pos);
-            out_file = boost::wave::util::branch_path(out_file) / (basename + ".i");
+            fs::path out_file(auto_output_name(file_name));
 
             boost::wave::util::create_directories(
                 boost::wave::util::branch_path(out_file));
             output.open(out_file.string().c_str());
             if (!output.is_open()) {
-                cerr << "wave: could not open output file: "
+                errstream << "wave: could not open output file: "
                      << out_file.string() << endl;
                 return -1;
             }
-            if (!license.empty())
-                output << license;
+            if (!license.empty() && digest)
+                digest->update(license);
+            else if (!license.empty())
+                output.write(license);
             default_outfile = out_file.string();
         }
 
         //  we assume the session to be interactive if input is stdin and output is
         //  stdout and the output is not inhibited
-        bool is_interactive = input_is_stdin && !output.is_open() && allow_output;
+        bool is_interactive = input_is_stdin && !output.is_open() &&
+            allow_output && !scan_only && !digest;
 
         if (is_interactive) {
             // if interactive we don't warn for missing endif's etc.
@@ -1174,11 +1968,17 @@ do_actual_work (std::string file_name, std::istream &instream,
                 boost::wave::enable_single_line(ctx.get_language()), false);
         }
 
-        // analyze the input file
-        context_type::iterator_type first = ctx.begin();
-        context_type::iterator_type last = ctx.end();
+        // analyze the input file, its directives are sufficient when scanning
+        // for the dependencies (as for the included files)
+        if (scan_only && !input_is_stdin) {
+            instring = boost::wave::util::minimize_directives(instring,
+                ctx.get_language());
+        }
+        context_type::iterator_type first =
+            ctx.begin(instring.begin(), instring.end());
 
         // preprocess the required include files
+        bool force_include_failed = false;
         if (vm.count("forceinclude")) {
             // add the filenames to force as include files in _reverse_ order
             // the second parameter 'is_last' of the force_include function should
@@ -1190,7 +1990,28 @@ do_actual_work (std::string file_name, std::istream &instream,
                  cit != rend; /**/)
             {
                 std::string filename(*cit);
-                first.force_include(filename.c_str(), ++cit == rend);
+                bool const is_last = (++cit == rend);
+                try {
+                    // the last one retrieves the first token, which means
+                    // preprocessing everything when scanning for dependencies
+                    first.force_include(filename.c_str(), is_last);
+                }
+                catch (boost::wave::cpp_exception const &e) {
+                    if (!boost::wave::is_recoverable(e))
+                        throw;
+                    output.flush();     // keep the order of output and errors
+                    error_count += report_error_message(ctx, e,
+                        treat_warnings_as_error, errstream);
+                    force_include_failed = is_last;
+                }
+                catch (boost::wave::cpplexer::lexing_exception const &e) {
+                    if (!boost::wave::cpplexer::is_recoverable(e))
+                        throw;
+                    output.flush();
+                    error_count += report_error_message(e,
+                        treat_warnings_as_error, errstream);
+                    force_include_failed = is_last;
+                }
             }
         }
 
@@ -1201,7 +2022,7 @@ do_actual_work (std::string file_name, std::istream &instream,
         }
         else if (vm.count("state")) {
             // the option "state" is usable in interactive mode only
-            cerr << "wave: ignoring the command line option 'state', "
+            errstream << "wave: ignoring the command line option 'state', "
                  << "use it in interactive mode only." << endl;
         }
 
@@ -1214,7 +2035,7 @@ do_actual_work (std::string file_name, std::istream &instream,
 
             if (input_is_stdin) {
                 if (is_interactive)
-                    cout << ">>> ";     // prompt if is interactive
+                    outstream << ">>> ";     // prompt if is interactive
 
                 // read next line and continue
                 instring.clear();
@@ -1223,7 +2044,8 @@ do_actual_work (std::string file_name, std::istream &instream,
                 first = ctx.begin(instring.begin(), instring.end());
             }
 
-            bool need_to_advanve = false;
+            bool need_to_advanve = force_include_failed;
+            force_include_failed = false;
 
             do {
                 try {
@@ -1232,34 +2054,17 @@ do_actual_work (std::string file_name, std::istream &instream,
                         need_to_advanve = false;
                     }
 
-                    while (first != last) {
-                        // store the last known good token position
-                        current_position = (*first).get_position();
-
-                        // print out the current token value
-                        if (allow_output) {
-                            if (!output.good()) {
-                                cerr << "wave: problem writing to the current "
-                                     << "output file" << endl;
-                                cerr << report_iostate_error(output.rdstate());
-                                break;
-                            }
-                            if (output.is_open())
-                                output << (*first).get_value();
-                            else
-                                cout << (*first).get_value();
-                        }
-
-                        // advance to the next token
-                        ++first;
-                    }
+                    // pass all generated tokens to the output
+                    first.run(output_writer(output, digest.get(),
+                        allow_output, scan_only, current_position));
                     finished = true;
                 }
                 catch (boost::wave::cpp_exception const &e) {
                     // some preprocessing error
                     if (is_interactive || boost::wave::is_recoverable(e)) {
+                        output.flush();
                         error_count += report_error_message(ctx, e,
-                            treat_warnings_as_error);
+                            treat_warnings_as_error, errstream);
                         need_to_advanve = true;   // advance to the next token
                     }
                     else {
@@ -1271,8 +2076,10 @@ do_actual_work (std::string file_name, std::istream &instream,
                     if (is_interactive ||
                         boost::wave::cpplexer::is_recoverable(e))
                     {
+                        output.flush();
                         error_count +=
-                            report_error_message(e, treat_warnings_as_error);
+                            report_error_message(e, treat_warnings_as_error,
+                                errstream);
                         need_to_advanve = true;   // advance to the next token
                     }
                     else {
@@ -1280,34 +2087,141 @@ do_actual_work (std::string file_name, std::istream &instream,
                     }
                 }
             } while (!finished);
+
+            if (is_interactive)
+                output.flush();     // show the result before the next prompt
         } while (input_is_stdin);
 
         if (is_interactive)
             save_state(vm, ctx);    // write the internal tables to disc
 
-        // list all defined macros at the end of the preprocessing
-        if (vm.count("macronames")) {
-            if (!list_macro_names(ctx, vm["macronames"].as<std::string>()))
-                return -1;
+        // the digest takes the place of the output
+        if (digest)
+            output.write(digest->finish() + "\n");
+        output.flush();
+        if (!output.good()) {
+            errstream << "wave: problem writing to the current output file"
+                 << endl;
+            errstream << report_write_error(output.error());
+            return -1;
+        }
+
+        // write the list of the files the input depends on
+        std::string dependencies_text;      // if written to a file
+        if (scan_only || vm.count("MD")) {
+            std::vector<std::string> dependencies;
+            if (!input_is_stdin)
+                dependencies.push_back(file_name);
+            std::vector<std::string> const &included =
+                ctx.get_hooks().get_dependencies();
+            dependencies.insert(dependencies.end(), included.begin(),
+                included.end());
+
+            ofstream depsout;
+            if (!deps_name.empty() && "-" != deps_name) {
+                fs::path deps_file(boost::wave::util::create_path(deps_name));
+                boost::wave::util::create_directories(
+                    boost::wave::util::branch_path(deps_file));
+                depsout.open(deps_file.string().c_str());
+                if (!depsout.is_open()) {
+                    errstream << "wave: could not open dependency file: "
+                         << deps_file.string() << endl;
+                    return -1;
+                }
+            }
+
+            std::ostringstream deps_text;
+            if ("json" == deps_format)
+                write_json_dependencies(deps_text, file_name, deps_target, dependencies);
+            else
+                write_make_dependencies(deps_text, deps_target, dependencies);
+            (depsout.is_open() ? depsout : outstream) << deps_text.str();
+            if (depsout.is_open())
+                dependencies_text = deps_text.str();
         }
-        if (vm.count("macrocounts")) {
-            if (!list_macro_counts(ctx, vm["macrocounts"].as<std::string>()))
-                return -1;
+
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+        // store the include file lookups for the next run
+        if (vm.count("include-db") && !include_db.save()) {
+            errstream << "wave: could not write the include database: "
+                 << include_db.get_filename() << endl;
         }
-    }
-    catch (boost::wave::cpp_exception const &e) {
-        // some preprocessing error
-        report_error_message(e, treat_warnings_as_error);
-        return 1;
-    }
-    catch (boost::wave::cpplexer::lexing_exception const &e) {
-        // some lexing error
-        report_error_message(e, treat_warnings_as_error);
-        return 2;
+#endif
+
+        // store the result for the next run with the same inputs, if it
+        // doesn't depend on anything else (f.e. the current time)
+        if (store_output) {
+            bool stored = false;
+            if (0 == error_count && ctx.get_hooks().is_reproducible()) {
+                boost::wave::util::output_cache::result result;
+                if (output.is_open()) {
+                    output.close();
+                    ifstream written(default_outfile.c_str(),
+                        std::ios::in | std::ios::binary);
+                    result.output = read_entire_file(written);
+                }
+                else if (captured_output) {
+                    result.output = captured_output->get_text();
+                }
+                result.dependencies = dependencies_text;
+                result.messages = captured_messages->get_text();
+
+                std::vector<std::string> files(
+                    ctx.get_hooks().get_input_files());
+                std::vector<std::string> inputs;
+                if (vm.count("license"))
+                    inputs.push_back(vm["license"].as<std::string>());
+                if (vm.count("headermap")) {
+                    std::vector<std::string> const &maps =
+                        vm["headermap"].as<std::vector<std::string> >();
+                    inputs.insert(inputs.end(), maps.begin(), maps.end());
+                }
+                for (std::size_t i = 0; i < inputs.size(); ++i) {
+                    files.push_back(boost::wave::util::complete_path(
+                        boost::wave::util::create_path(inputs[i]),
+                        base_dir).string());
+                }
+
+                stored = output_cache.insert(cache_key, files, result, started);
+            }
+            else {
+                output_cache.count_uncacheable();
+            }
+            save_output_cache_statistics(output_cache);
+            if (vm.count("cachestats")) {
+                errstream << "wave: output cache: miss ("
+                    << (stored ? "result stored" : "result not stored")
+                    << ")" << endl;
+            }
+        }
+
+        // list all defined macros at the end of the preprocessing
+        if (vm.count("macronames")) {
+            if (!list_macro_names(ctx, vm["macronames"].as<std::string>(),
+                    outstream, errstream))
+                return -1;
+        }
+        if (vm.count("macrocounts")) {
+            if (!list_macro_counts(ctx, vm["macrocounts"].as<std::string>(),
+                    outstream, errstream))
+                return -1;
+        }
+        if (vm.count("cachestats"))
+            print_cache_statistics(ctx, errstream);
+    }
+    catch (boost::wave::cpp_exception const &e) {
+        // some preprocessing error
+        report_error_message(e, treat_warnings_as_error, errstream);
+        return 1;
+    }
+    catch (boost::wave::cpplexer::lexing_exception const &e) {
+        // some lexing error
+        report_error_message(e, treat_warnings_as_error, errstream);
+        return 2;
     }
     catch (std::exception const &e) {
         // use last recognized token to retrieve the error position
-        cerr
+        errstream
             << current_position << ": "
             << "exception caught: " << e.what()
             << endl;
@@ -1315,7 +2229,7 @@ do_actual_work (std::string file_name, std::istream &instream,
     }
     catch (...) {
         // use last recognized token to retrieve the error position
-        cerr
+        errstream
             << current_position << ": "
             << "unexpected exception caught." << endl;
         return 4;
@@ -1324,21 +2238,840 @@ do_actual_work (std::string file_name, std::istream &instream,
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-//  main entry point
+//  batch mode: preprocess a list of input files in one process, possibly
+//  using several threads
+namespace {
+
+    struct batch_job
+    {
+        batch_job(std::string const &input_, std::string const &output_)
+        :   input(input_), output(output_), result(0), done(false)
+        {}
+
+        std::string input;
+        std::string output;         // empty: <input_base_name>.i
+        std::string outbuffer;      // the text this job wrote to std::cout
+        std::string errbuffer;      // the text this job wrote to std::cerr
+        int result;
+        bool done;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // split a line of a batch list into its (optionally double quoted) fields
+    std::vector<std::string> split_batch_line(std::string const &line)
+    {
+        std::vector<std::string> fields;
+        std::string::size_type pos = 0;
+
+        while (pos < line.size()) {
+            if (std::isspace(static_cast<unsigned char>(line[pos]))) {
+                ++pos;
+                continue;
+            }
+
+            std::string field;
+            if ('"' == line[pos]) {
+                std::string::size_type end = line.find('"', pos+1);
+                if (std::string::npos == end)
+                    end = line.size();
+                field = line.substr(pos+1, end-pos-1);
+                pos = end+1;
+            }
+            else {
+                std::string::size_type end = pos;
+                while (end < line.size() &&
+                       !std::isspace(static_cast<unsigned char>(line[end])))
+                {
+                    ++end;
+                }
+                field = line.substr(pos, end-pos);
+                pos = end;
+            }
+            fields.push_back(field);
+        }
+        return fields;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // read the jobs from a batch list file: every line names an input file
+    // and optionally the corresponding output file, empty lines and lines
+    // starting with a '#' are ignored
+    bool read_batch_list(std::string const &filename,
+        std::vector<batch_job> &jobs, std::ostream &errstream)
+    {
+        ifstream listfile(filename.c_str());
+        if (!listfile.is_open()) {
+            errstream << "wave: could not open batch list file: " << filename
+                 << endl;
+            return false;
+        }
+
+        std::string line;
+        unsigned int lineno = 0;
+        while (std::getline(listfile, line)) {
+            ++lineno;
+            std::vector<std::string> fields(split_batch_line(line));
+            if (fields.empty() || '#' == fields[0][0])
+                continue;
+
+            if (fields.size() > 2) {
+                errstream << filename << "(" << lineno << "): "
+                     << "expected an input file name optionally followed by "
+                     << "an output file name" << endl;
+                return false;
+            }
+            jobs.push_back(batch_job(fields[0],
+                fields.size() > 1 ? fields[1] : std::string()));
+        }
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // preprocess a single file of a batch, keeping all of the generated
+    // diagnostics
+    void run_batch_job(batch_job &job, po::variables_map const &vm,
+        boost::wave::shared_resources &resources, fs::path const &base_dir)
+    {
+        std::ostringstream outstream;
+        std::ostringstream errstream;
+
+        ifstream instream(job.input.c_str());
+        if (!instream.is_open()) {
+            errstream << "wave: could not open input file: " << job.input
+                      << endl;
+            job.result = -1;
+        }
+        else {
+            // when scanning for the dependencies only, these are printed to
+            // stdout (in the order of the jobs) by default
+            std::string output_name(job.output);
+            if (output_name.empty() && !vm.count("scan-deps"))
+                output_name = auto_output_name(job.input).string();
+
+            job.result = do_actual_work(job.input, instream, vm, false,
+                output_name, outstream, errstream, &resources, base_dir);
+        }
+        job.outbuffer = outstream.str();
+        job.errbuffer = errstream.str();
+    }
+
+    // print the diagnostics of a finished job
+    void print_batch_job(batch_job &job, std::ostream &outstream,
+        std::ostream &errstream)
+    {
+        outstream << job.outbuffer << std::flush;
+        errstream << job.errbuffer << std::flush;
+        job.outbuffer.clear();
+        job.errbuffer.clear();
+    }
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+    ///////////////////////////////////////////////////////////////////////////
+    // the jobs of a batch shared between the worker threads
+    class batch_queue
+    {
+    public:
+        batch_queue(std::vector<batch_job> &jobs_, po::variables_map const &vm_,
+                boost::wave::shared_resources &resources_,
+                fs::path const &base_dir_)
+        :   jobs(jobs_), vm(vm_), resources(resources_), base_dir(base_dir_),
+            next(0)
+        {}
+
+        // worker thread: preprocess jobs until none are left
+        void work()
+        {
+            for (;;) {
+                std::size_t current = 0;
+                {
+                    boost::lock_guard<boost::mutex> lock(mtx);
+                    if (next == jobs.size())
+                        return;
+                    current = next++;
+                }
+
+                run_batch_job(jobs[current], vm, resources, base_dir);
+
+                boost::lock_guard<boost::mutex> lock(mtx);
+                jobs[current].done = true;
+                finished.notify_all();
+            }
+        }
+
+        // main thread: print the diagnostics in the order of the jobs
+        void print(std::ostream &outstream, std::ostream &errstream)
+        {
+            for (std::size_t i = 0; i < jobs.size(); ++i) {
+                {
+                    boost::unique_lock<boost::mutex> lock(mtx);
+                    while (!jobs[i].done)
+                        finished.wait(lock);
+                }
+                print_batch_job(jobs[i], outstream, errstream);
+            }
+        }
+
+    private:
+        std::vector<batch_job> &jobs;
+        po::variables_map const &vm;
+        boost::wave::shared_resources &resources;
+        fs::path const &base_dir;
+        std::size_t next;
+        boost::mutex mtx;
+        boost::condition_variable finished;
+    };
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    // preprocess all jobs using the given number of threads, the files of a
+    // batch share the included files and the include file lookups
+    int run_batch(std::vector<batch_job> &jobs, po::variables_map const &vm,
+        unsigned int threads, boost::wave::shared_resources &resources,
+        fs::path const &base_dir, std::ostream &outstream,
+        std::ostream &errstream)
+    {
+        if (threads > jobs.size())
+            threads = static_cast<unsigned int>(jobs.size());
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        if (threads > 1) {
+            batch_queue queue(jobs, vm, resources, base_dir);
+            boost::thread_group workers;
+            for (unsigned int i = 0; i < threads; ++i)
+                workers.create_thread(boost::bind(&batch_queue::work, &queue));
+            queue.print(outstream, errstream);
+            workers.join_all();
+        }
+        else
+#else
+        if (threads > 1) {
+            errstream << "wave: warning: this executable was compiled without "
+                 << "threading support, preprocessing the files sequentially"
+                 << endl;
+        }
+#endif
+        {
+            for (std::size_t i = 0; i < jobs.size(); ++i) {
+                run_batch_job(jobs[i], vm, resources, base_dir);
+                print_batch_job(jobs[i], outstream, errstream);
+            }
+        }
+
+        // the result is the one of the first failing job, if any
+        int result = 0;
+        std::size_t failed = 0;
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            if (0 != jobs[i].result) {
+                if (0 == failed++)
+                    result = jobs[i].result;
+            }
+        }
+        if (0 != failed) {
+            errstream << "wave: " << failed << " of " << jobs.size()
+                 << " input files failed" << endl;
+        }
+        return result;
+    }
+}   // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////
+//  server mode: a server listening on a local socket preprocesses the files
+//  for its clients, all of its requests share the included files and the
+//  include file lookups, which are checked for modifications before every
+//  request
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+int run_wave (std::vector<std::string> const &args, std::ostream &outstream,
+    std::ostream &errstream, boost::wave::shared_resources *resources,
+    std::string const &directory);
+
+namespace {
+
+    typedef boost::asio::local::stream_protocol protocol_type;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the messages consist of fields, each preceded by its length and a ':'
+    void append_field(std::string &message, std::string const &field)
+    {
+        message += boost::lexical_cast<std::string>(field.size());
+        message += ':';
+        message += field;
+    }
+
+    void append_fields(std::string &message,
+        std::vector<std::string> const &fields)
+    {
+        append_field(message, boost::lexical_cast<std::string>(fields.size()));
+        for (std::size_t i = 0; i < fields.size(); ++i)
+            append_field(message, fields[i]);
+    }
+
+    // read a field of the response of a server
+    bool read_field(protocol_type::socket &socket, std::string &field)
+    {
+        boost::system::error_code ec;
+        std::size_t length = 0;
+        for (std::size_t digits = 0; /**/; ++digits) {
+            char c = 0;
+            boost::asio::read(socket, boost::asio::buffer(&c, 1), ec);
+            if (ec || digits > 10)
+                return false;
+            if (':' == c && 0 != digits)
+                break;
+            if (c < '0' || c > '9')
+                return false;
+            length = 10 * length + (c - '0');
+        }
+
+        try {
+            field.resize(length);
+        }
+        catch (std::exception const &) {
+            return false;
+        }
+        if (0 != length)
+            boost::asio::read(socket, boost::asio::buffer(&field[0], length), ec);
+        return !ec;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the limits of the requests accepted by a server, the connections
+    // sending anything else are closed
+    std::size_t const max_field_size = 1024 * 1024;
+    std::size_t const max_field_count = 65536;
+    std::size_t const max_request_size = 64 * 1024 * 1024;
+
+    // the connections idle for this long (in seconds) are closed
+    long const idle_timeout = 30;
+
+    enum parse_result { parse_incomplete, parse_complete, parse_invalid };
+
+    // parse the field starting at the given position of the message received
+    // so far, on success the position is advanced past the field
+    parse_result parse_field(std::string const &message, std::size_t &pos,
+        std::string &field)
+    {
+        std::size_t length = 0;
+        std::size_t start = pos;
+        for (std::size_t digits = 0; /**/; ++digits, ++start) {
+            if (start == message.size())
+                return parse_incomplete;
+            char c = message[start];
+            if (':' == c && 0 != digits)
+                break;
+            if (c < '0' || c > '9')
+                return parse_invalid;
+            length = 10 * length + (c - '0');
+            if (length > max_field_size)
+                return parse_invalid;
+        }
+
+        ++start;        // skip the ':'
+        if (message.size() - start < length)
+            return parse_incomplete;
+        field.assign(message, start, length);
+        pos = start + length;
+        return parse_complete;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the request of a client, which is parsed as its pieces arrive: the
+    // current directory, followed by the number of the variables of the
+    // environment, these variables, the number of arguments and the
+    // arguments
+    class request_parser
+    {
+    public:
+        request_parser()
+        :   pos(0), part(0), count(0)
+        {}
+
+        parse_result parse(std::string const &message)
+        {
+            for (;;) {
+                std::vector<std::string> *list = get_list();
+                if (0 != list && list->size() == count) {
+                    if (4 == part)
+                        return parse_complete;
+                    ++part;
+                    continue;
+                }
+
+                std::string field;
+                parse_result result = parse_field(message, pos, field);
+                if (parse_complete != result)
+                    return result;
+
+                if (0 != list) {
+                    list->push_back(field);
+                    continue;
+                }
+
+                if (0 == part) {
+                    directory = field;
+                }
+                else {
+                    // the number of fields of the following list
+                    try {
+                        count = boost::lexical_cast<std::size_t>(field);
+                    }
+                    catch (boost::bad_lexical_cast const &) {
+                        return parse_invalid;
+                    }
+                    if (count > max_field_count)
+                        return parse_invalid;
+                }
+                ++part;
+            }
+        }
+
+        std::string directory;
+        std::vector<std::string> environment;
+        std::vector<std::string> args;
+
+    private:
+        std::vector<std::string> *get_list()
+        {
+            if (2 == part)
+                return &environment;
+            if (4 == part)
+                return &args;
+            return 0;
+        }
+
+        std::size_t pos;        // the position of the next field
+        int part;               // the part of the request parsed next
+        std::size_t count;      // the number of fields of the current list
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // client: send the arguments, the current directory and the environment
+    // to the server, print the output of the request
+    int run_client(std::string const &name,
+        std::vector<std::string> const &args, std::ostream &outstream,
+        std::ostream &errstream)
+    {
+        boost::asio::io_context io;
+        protocol_type::socket socket(io);
+        boost::system::error_code ec;
+        socket.connect(protocol_type::endpoint(name), ec);
+        if (ec) {
+            errstream << "wave: could not connect to the server at " << name
+                      << ": " << ec.message() << endl;
+            return -1;
+        }
+
+        std::vector<std::string> environment;
+        for (char **var = environ; 0 != *var; ++var)
+            environment.push_back(*var);
+
+        std::string request;
+        append_field(request, fs::current_path().string());
+        append_fields(request, environment);
+        append_fields(request, args);
+        boost::asio::write(socket, boost::asio::buffer(request), ec);
+
+        std::string result;
+        std::string outbuffer;
+        std::string errbuffer;
+        if (ec || !read_field(socket, result) ||
+            !read_field(socket, outbuffer) || !read_field(socket, errbuffer))
+        {
+            errstream << "wave: the server at " << name
+                      << " didn't answer the request" << endl;
+            return -1;
+        }
+
+        outstream << outbuffer << std::flush;
+        errstream << errbuffer << std::flush;
+        return std::atoi(result.c_str());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The requests run in the current directory and with the environment of
+    // their client (these matter for the relative paths and the commands run
+    // by '#pragma wave system()'). As these are process wide, requests run
+    // concurrently only, if they have the same ones, the other ones wait.
+    class request_gate
+    {
+    public:
+        request_gate()
+        :   directory(fs::current_path().string()), active(0), waiting(0),
+            admissions(0)
+        {
+            for (char **var = environ; 0 != *var; ++var)
+                environment.push_back(*var);
+        }
+
+        // returns false, if the directory of the client doesn't exist
+        bool enter(std::string const &directory_,
+            std::vector<std::string> const &environment_)
+        {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+            // the waiting requests are admitted, when the running ones are
+            // done, after that the ones having the same setting join them
+            boost::unique_lock<boost::mutex> lock(mtx);
+            if (0 != active &&
+                (!is_current(directory_, environment_) || 0 != waiting))
+            {
+                unsigned long const started = admissions;
+                ++waiting;
+                while (0 != active && (admissions == started ||
+                       !is_current(directory_, environment_)))
+                {
+                    released.wait(lock);
+                }
+                --waiting;
+                ++admissions;
+                released.notify_all();
+            }
+#endif
+            if (directory != directory_) {
+                boost::system::error_code ec;
+                fs::current_path(fs::path(directory_), ec);
+                if (ec) {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+                    released.notify_all();
+#endif
+                    return false;
+                }
+                directory = directory_;
+            }
+            if (environment != environment_) {
+                set_environment(environment_);
+                environment = environment_;
+            }
+            ++active;
+            return true;
+        }
+
+        void leave()
+        {
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+            boost::lock_guard<boost::mutex> lock(mtx);
+            if (0 == --active)
+                released.notify_all();
+#else
+            --active;
+#endif
+        }
+
+    private:
+        static void set_environment(std::vector<std::string> const &variables)
+        {
+            std::vector<std::string> names;
+            for (char **var = environ; 0 != *var; ++var) {
+                std::string name(*var);
+                names.push_back(name.substr(0, name.find('=')));
+            }
+            for (std::size_t i = 0; i < names.size(); ++i)
+                unsetenv(names[i].c_str());
+
+            for (std::size_t i = 0; i < variables.size(); ++i) {
+                std::string::size_type pos = variables[i].find('=');
+                if (std::string::npos != pos && 0 != pos) {
+                    setenv(variables[i].substr(0, pos).c_str(),
+                        variables[i].substr(pos+1).c_str(), 1);
+                }
+            }
+        }
+
+        bool is_current(std::string const &directory_,
+            std::vector<std::string> const &environment_) const
+        {
+            return directory == directory_ && environment == environment_;
+        }
+
+        std::string directory;
+        std::vector<std::string> environment;
+        unsigned int active;        // the number of running requests
+        unsigned int waiting;       // the number of waiting requests
+        unsigned long admissions;   // the number of admitted waiting requests
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+        boost::mutex mtx;
+        boost::condition_variable released;
+#endif
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the server accepts the connections and receives the requests on all of
+    // its threads, every request runs on the thread completing its receipt
+    class server
+    {
+    public:
+        server(std::string const &name_, std::size_t max_cache_size,
+                std::ostream &errstream_)
+        :   name(name_), errstream(errstream_), acceptor(io), signals(io)
+        {
+            resources.set_max_size(max_cache_size);
+        }
+
+        int run(unsigned int threads)
+        {
+            // remove a socket left over by a server, which didn't shut down
+            boost::system::error_code ec;
+            if (fs::exists(fs::path(name), ec)) {
+                protocol_type::socket probe(io);
+                probe.connect(protocol_type::endpoint(name), ec);
+                if (!ec) {
+                    errstream << "wave: there is a server listening at "
+                              << name << " already" << endl;
+                    return -1;
+                }
+                fs::remove(fs::path(name), ec);
+            }
+
+            acceptor.open(protocol_type(), ec);
+            if (!ec)
+                acceptor.bind(protocol_type::endpoint(name), ec);
+            if (!ec)
+                acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+            if (ec) {
+                errstream << "wave: could not listen at " << name << ": "
+                          << ec.message() << endl;
+                return -1;
+            }
+
+            // shut down on SIGINT and SIGTERM
+            signals.add(SIGINT);
+            signals.add(SIGTERM);
+            signals.async_wait(boost::bind(&server::shutdown, this));
+            accept();
+
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+            if (0 == threads)
+                threads = (std::max)(boost::thread::hardware_concurrency(), 1u);
+
+            boost::thread_group workers;
+            for (unsigned int i = 1; i < threads; ++i) {
+                workers.create_thread(boost::bind(
+                    static_cast<std::size_t (boost::asio::io_context::*)()>(
+                        &boost::asio::io_context::run), &io));
+            }
+            io.run();
+            workers.join_all();
+#else
+            if (threads > 1) {
+                errstream << "wave: warning: this executable was compiled "
+                          << "without threading support, handling the "
+                          << "requests sequentially" << endl;
+            }
+            io.run();
+#endif
+
+            fs::remove(fs::path(name), ec);
+            return 0;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        // a connection of a client: the request is received asynchronously,
+        // so clients sending their requests slowly don't block the other
+        // ones, the connections idle for longer than the idle_timeout are
+        // closed, every failure closes the connection only
+        class connection
+        :   public boost::enable_shared_from_this<connection>
+        {
+        public:
+            explicit connection(server &owner_)
+            :   owner(owner_), strand(boost::asio::make_strand(owner_.io)),
+                socket(strand), timer(strand)
+            {}
+
+            protocol_type::socket &get_socket() { return socket; }
+
+            void start()
+            {
+                set_deadline();
+                read();
+            }
+
+        private:
+            void set_deadline()
+            {
+                timer.expires_after(boost::asio::chrono::seconds(idle_timeout));
+                timer.async_wait(boost::bind(&connection::on_deadline,
+                    shared_from_this(), boost::asio::placeholders::error));
+            }
+
+            void on_deadline(boost::system::error_code const &ec)
+            {
+                // the deadline may have been moved meanwhile
+                if (!ec && timer.expiry() <=
+                    boost::asio::steady_timer::clock_type::now())
+                {
+                    close();
+                }
+            }
+
+            void read()
+            {
+                socket.async_read_some(boost::asio::buffer(chunk),
+                    boost::bind(&connection::on_read, shared_from_this(),
+                        boost::asio::placeholders::error,
+                        boost::asio::placeholders::bytes_transferred));
+            }
+
+            void on_read(boost::system::error_code const &ec,
+                std::size_t bytes)
+            {
+                if (ec) {
+                    close();
+                    return;
+                }
+
+                try {
+                    message.append(chunk, bytes);
+                    parse_result result = request.parse(message);
+                    if (parse_incomplete == result &&
+                        message.size() < max_request_size)
+                    {
+                        set_deadline();
+                        read();
+                        return;
+                    }
+                    if (parse_complete != result) {
+                        close();        // not a client
+                        return;
+                    }
+
+                    // the deadline doesn't apply while the request runs
+                    timer.cancel();
+                    response = owner.process(request);
+
+                    set_deadline();
+                    boost::asio::async_write(socket,
+                        boost::asio::buffer(response),
+                        boost::bind(&connection::on_write, shared_from_this(),
+                            boost::asio::placeholders::error));
+                }
+                catch (...) {
+                    close();
+                }
+            }
+
+            void on_write(boost::system::error_code const &)
+            {
+                close();
+            }
+
+            void close()
+            {
+                boost::system::error_code ec;
+                timer.cancel();
+                socket.close(ec);
+            }
+
+            server &owner;
+            boost::asio::strand<boost::asio::io_context::executor_type> strand;
+            protocol_type::socket socket;
+            boost::asio::steady_timer timer;
+            char chunk[16384];
+            std::string message;        // the request received so far
+            request_parser request;
+            std::string response;
+        };
+
+        void accept()
+        {
+            boost::shared_ptr<connection> client(new connection(*this));
+            acceptor.async_accept(client->get_socket(),
+                boost::bind(&server::handle, this, client,
+                    boost::asio::placeholders::error));
+        }
+
+        void shutdown()
+        {
+            boost::system::error_code ec;
+            acceptor.close(ec);
+        }
+
+        void handle(boost::shared_ptr<connection> client,
+            boost::system::error_code const &ec)
+        {
+            if (!acceptor.is_open())
+                return;         // the server shuts down
+
+            if (!ec) {
+                try {
+                    client->start();
+                }
+                catch (...) {
+                    // drop this connection only
+                }
+            }
+            accept();
+        }
+
+        // run the request of a client, returns the response
+        std::string process(request_parser const &request)
+        {
+            // every request has its own context, the failing ones leave the
+            // shared caches alone
+            std::ostringstream outstream;
+            std::ostringstream errstream;
+            int result = -1;
+            if (gate.enter(request.directory, request.environment)) {
+                resources.revalidate();
+                try {
+                    result = run_wave(request.args, outstream, errstream,
+                        &resources, request.directory);
+                }
+                catch (...) {
+                    errstream << "wave: unexpected exception caught." << endl;
+                    result = 7;
+                }
+                gate.leave();
+            }
+            else {
+                errstream << "wave: could not change to the directory: "
+                          << request.directory << endl;
+            }
+
+            std::string response;
+            append_field(response, boost::lexical_cast<std::string>(result));
+            append_field(response, outstream.str());
+            append_field(response, errstream.str());
+            return response;
+        }
+
+        std::string name;
+        std::ostream &errstream;
+        boost::asio::io_context io;
+        protocol_type::acceptor acceptor;
+        boost::asio::signal_set signals;
+        boost::wave::shared_resources resources;
+        request_gate gate;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // run a server using the given number of threads (0: one per core),
+    // every one of its caches is limited to the given size (0: no limit)
+    int run_server(std::string const &name, unsigned int threads,
+        std::size_t max_cache_size, std::ostream &errstream)
+    {
+        server the_server(name, max_cache_size, errstream);
+        return the_server.run(threads);
+    }
+}   // anonymous namespace
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+//  analyze the command line options and arguments and act as required, the
+//  output goes to the given streams (a server runs the requests of its
+//  clients this way, these use the caches of the server and pass the
+//  directory of the client, the relative paths are completed against)
 int
-main (int argc, char *argv[])
+run_wave (std::vector<std::string> const &args, std::ostream &outstream,
+    std::ostream &errstream, boost::wave::shared_resources *resources,
+    std::string const &directory)
 {
-    const std::string accepted_w_args[] = {"error"};
+    bool const is_request = !directory.empty();
+    fs::path const base_dir(is_request ?
+        boost::wave::util::create_path(directory) :
+        boost::wave::util::initial_path());
 
-    // test Wave compilation configuration
-    if (!BOOST_WAVE_TEST_CONFIGURATION()) {
-        cout << "wave: warning: the library this application was linked against was compiled "
-             << endl
-             << "               using a different configuration (see wave_config.hpp)."
-             << endl;
-    }
+    const std::string accepted_w_args[] = {"error"};
 
-    // analyze the command line options and arguments
     try {
     // declare the options allowed on the command line only
     po::options_description desc_cmdline ("Options allowed on the command line only");
@@ -1349,6 +3082,30 @@ main (int argc, char *argv[])
             ("copyright", "print out the copyright statement")
             ("config-file", po::value<vector<std::string> >()->composing(),
                 "specify a config file (alternatively: @filepath)")
+            ("batch", "preprocess all of the given input files, each into a "
+                "file named <input_basename>.i")
+            ("batch-list", po::value<std::string>(),
+                "preprocess the files listed in [arg], each line holding an "
+                "input file name optionally followed by an output file name")
+            ("jobs,j", po::value<unsigned int>(),
+                "use [arg] threads to preprocess the files of a batch (or the "
+                "requests of the clients of a server)")
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            ("serve", po::value<std::string>(),
+                "run as a server preprocessing the files for the clients "
+                "connecting to the local socket [arg], all requests share "
+                "the cached files and include file lookups")
+            ("connect", po::value<std::string>(),
+                "let the server listening on the local socket [arg] "
+                "preprocess the input, passing all other options, the "
+                "current directory and the environment to it")
+            ("serve-cache-size", po::value<unsigned int>(),
+                "limit every one of the caches of a server to [arg] MB "
+                "(default: 256, 0: unlimited), the least recently used "
+                "entries are removed first")
+#endif
+            ("output-cache-stats", "print the statistics of the output cache "
+                "given by --output-cache")
         ;
 
     const std::string w_arg_desc = "Warning settings. Currently supported: -W" +
@@ -1363,12 +3120,21 @@ main (int argc, char *argv[])
                 "disable output [-]")
             ("autooutput,E",
                 "output goes into a file named <input_basename>.i")
+#if BOOST_WAVE_SUPPORT_THREADING != 0
+            ("async-output", "write the output file on a background thread "
+                "while preprocessing")
+#endif
             ("license", po::value<std::string>(),
                 "prepend the content of the specified file to each created file")
             ("include,I", po::value<cmd_line_utils::include_paths>()->composing(),
                 "specify an additional include directory")
             ("sysinclude,S", po::value<vector<std::string> >()->composing(),
                 "specify an additional system include directory")
+#if BOOST_WAVE_SUPPORT_HEADER_MAPS != 0
+            ("headermap", po::value<vector<std::string> >()->composing(),
+                "specify a header map (see wave-headermap) to search for\n"
+                "include files before the system include directories")
+#endif
             ("forceinclude,F", po::value<std::vector<std::string> >()->composing(),
                 "force inclusion of the given file")
             ("define,D", po::value<std::vector<std::string> >()->composing(),
@@ -1392,6 +3158,7 @@ main (int argc, char *argv[])
                 "output macro expansion tracing information to a file [arg] "
                 "or to stderr [-]")
             ("timer", "output overall elapsed computing time to stderr")
+            ("cachestats", "output statistics of the internal caches to stderr")
             ("long_long", "enable long long support in C++ mode")
 #if BOOST_WAVE_SUPPORT_VARIADICS_PLACEMARKERS != 0
             ("variadics", "enable certain C99 extensions in C++ mode")
@@ -1411,6 +3178,26 @@ main (int argc, char *argv[])
 #endif
             ("listincludes,l", po::value<std::string>(),
                 "list names of included files to a file [arg] or to stdout [-]")
+            ("scan-deps", "evaluate the directives only and list the files "
+                "the input depends on to stdout or to the output file, no "
+                "preprocessed output is generated (same as -M)")
+            ("MD", "list the files the input depends on to a file named "
+                "<output_basename>.d while preprocessing")
+            ("MF", po::value<std::string>(),
+                "write the list of dependencies to a file [arg] or to "
+                "stdout [-]")
+            ("MT", po::value<std::string>(),
+                "use [arg] as the target of the generated make rule, by "
+                "default the output file or <input_basename>.o")
+            ("deps-format", po::value<std::string>(),
+                "list the dependencies as a make rule [make] (default) or as "
+                "a JSON object [json]")
+            ("directives-only", "evaluate the directives, but don't expand "
+                "any macros in the text, the macro definitions are part of "
+                "the output")
+            ("hash-output", po::value<std::string>(),
+                "write the digest of the preprocessed output only, computed "
+                "by the algorithm [arg]: sha256 or fnv1a (64 bit)")
             ("macronames,m", po::value<std::string>(),
                 "list all defined macros to a file [arg] or to stdout [-]")
             ("macrocounts,c", po::value<std::string>(),
@@ -1435,10 +3222,26 @@ main (int argc, char *argv[])
             ("extended,x", "enable the #pragma wave system() directive")
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
             ("noguard,G", "disable include guard detection")
+            ("nosnapshots", "don't use snapshots of the include directories "
+                "nor cached include file lookups (needed, if headers are "
+                "generated while preprocessing)")
             ("listguards,g", po::value<std::string>(),
                 "list names of files flagged as 'include once' to a file [arg] "
                 "or to stdout [-]")
 #endif
+#if BOOST_WAVE_CACHE_INCLUDE_LOOKUPS != 0
+            ("include-db", po::value<std::string>(),
+                "keep the include file lookups across runs in the given "
+                "database file [arg]")
+#endif
+            ("output-cache", po::value<std::string>(),
+                "keep the output in the directory [arg] and reuse it for "
+                "the runs with the same input files, options and initial "
+                "macro definitions")
+            ("output-cache-size", po::value<unsigned int>(),
+                "limit the size of the output cache to [arg] MB (default: "
+                "1024, 0: unlimited), the least recently used results are "
+                "removed first")
 #if BOOST_WAVE_SERIALIZATION != 0
             ("state,s", po::value<std::string>(),
                 "load and save state information from/to the given file [arg] "
@@ -1456,13 +3259,50 @@ main (int argc, char *argv[])
         // parse command line and store results
         using namespace boost::program_options::command_line_style;
 
-        po::parsed_options opts(po::parse_command_line(argc, argv,
-            desc_overall_cmdline, unix_style, cmd_line_utils::at_option_parser));
+        po::parsed_options opts(po::command_line_parser(args)
+            .options(desc_overall_cmdline).style(unix_style)
+            .extra_parser(cmd_line_utils::at_option_parser)
+            .extra_style_parser(cmd_line_utils::dependency_option_parser)
+            .run());
         po::variables_map vm;
 
         po::store(opts, vm);
         po::notify(vm);
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        if (vm.count("serve") || vm.count("connect")) {
+            if (is_request) {
+                errstream << "wave: the " << (vm.count("serve") ? "--serve" :
+                    "--connect") << " option can't be used in the request "
+                    << "of a client" << endl;
+                return -1;
+            }
+
+            // the client passes all of the other options to the server
+            if (vm.count("connect")) {
+                std::vector<std::string> client_args;
+                for (std::size_t i = 0; i < opts.options.size(); ++i) {
+                    if ("connect" != opts.options[i].string_key) {
+                        client_args.insert(client_args.end(),
+                            opts.options[i].original_tokens.begin(),
+                            opts.options[i].original_tokens.end());
+                    }
+                }
+                return run_client(vm["connect"].as<std::string>(),
+                    client_args, outstream, errstream);
+            }
+
+            unsigned int threads = 0;       // as many as there are cores
+            if (vm.count("jobs"))
+                threads = (std::max)(vm["jobs"].as<unsigned int>(), 1u);
+            std::size_t max_cache_size = 256;
+            if (vm.count("serve-cache-size"))
+                max_cache_size = vm["serve-cache-size"].as<unsigned int>();
+            return run_server(vm["serve"].as<std::string>(), threads,
+                max_cache_size * 1024 * 1024, errstream);
+        }
+#endif
+
 //     // Try to find a wave.cfg in the same directory as the executable was
 //     // started from. If this exists, treat it as a wave config file
 //     fs::path filename(argv[0]);
@@ -1483,7 +3323,8 @@ main (int argc, char *argv[])
         if (arguments.size() > 0 && arguments[0].value[0] != "-") {
             // construct full path of input file
             fs::path input_dir(boost::wave::util::complete_path(
-                boost::wave::util::create_path(arguments[0].value[0])));
+                boost::wave::util::create_path(arguments[0].value[0]),
+                base_dir));
 
             // chop of file name
             input_dir = boost::wave::util::branch_path(
@@ -1493,7 +3334,7 @@ main (int argc, char *argv[])
             while (!input_dir.empty()) {
                 fs::path filename = input_dir / "wave.cfg";
                 if (cmd_line_utils::read_config_file_options(filename.string(),
-                    desc_overall_cfgfile, vm, true))
+                    desc_overall_cfgfile, vm, true, errstream))
                 {
                     break;    // break on the first cfg file found
                 }
@@ -1512,7 +3353,7 @@ main (int argc, char *argv[])
             {
                 // parse a single config file and store the results
                 cmd_line_utils::read_config_file_options(*cit,
-                    desc_overall_cfgfile, vm);
+                    desc_overall_cfgfile, vm, false, errstream);
             }
         }
 
@@ -1525,7 +3366,7 @@ main (int argc, char *argv[])
                 if (boost::range::find(accepted_w_args, arg) ==
                     boost::end(accepted_w_args))
                 {
-                    cerr << "wave: Invalid warning setting: " << arg << endl;
+                    errstream << "wave: Invalid warning setting: " << arg << endl;
                     return -1;
                 }
             }
@@ -1537,30 +3378,83 @@ main (int argc, char *argv[])
                 "Usage: wave [options] [@config-file(s)] [file]");
 
             desc_help.add(desc_cmdline).add(desc_generic).add(desc_ext);
-            cout << desc_help << endl;
+            outstream << desc_help << endl;
             return 1;
         }
 
         if (vm.count("version")) {
-            cout << get_version() << endl;
+            outstream << get_version() << endl;
             return 0;
         }
 
         if (vm.count("copyright")) {
-            return print_copyright();
+            return print_copyright(outstream);
+        }
+
+        if (vm.count("output-cache-stats")) {
+            if (!vm.count("output-cache")) {
+                errstream << "wave: the --output-cache-stats option needs the "
+                     << "directory of the cache given by --output-cache" << endl;
+                return -1;
+            }
+            print_output_cache_statistics(vm["output-cache"].as<std::string>(),
+                outstream);
+            return 0;
+        }
+
+        // preprocess a batch of input files, if requested
+        if (vm.count("batch") || vm.count("batch-list")) {
+            if (vm.count("output") || vm.count("MF")) {
+                errstream << "wave: the " << (vm.count("output") ? "--output" : "-MF")
+                     << " option can't be used together with --batch or "
+                     << "--batch-list" << endl;
+                return -1;
+            }
+
+            std::vector<batch_job> jobs;
+            if (vm.count("batch-list") &&
+                !read_batch_list(vm["batch-list"].as<std::string>(), jobs,
+                    errstream))
+            {
+                return -1;
+            }
+            for (std::size_t i = 0; i < arguments.size(); ++i) {
+                for (std::size_t j = 0; j < arguments[i].value.size(); ++j)
+                    jobs.push_back(batch_job(arguments[i].value[j], ""));
+            }
+
+            unsigned int threads = 1;
+            if (vm.count("jobs"))
+                threads = (std::max)(vm["jobs"].as<unsigned int>(), 1u);
+
+            // the files of a batch share the caches
+            if (0 == resources) {
+                boost::wave::shared_resources batch_resources;
+                return run_batch(jobs, vm, threads, batch_resources,
+                    base_dir, outstream, errstream);
+            }
+            return run_batch(jobs, vm, threads, *resources, base_dir,
+                outstream, errstream);
         }
 
         // if there is no input file given, then take input from stdin
         if (0 == arguments.size() || 0 == arguments[0].value.size() ||
             arguments[0].value[0] == "-")
         {
+            if (is_request) {
+                errstream << "wave: the server can't read the input from "
+                     << "stdin" << endl;
+                return -1;
+            }
+
             // preprocess the given input from stdin
-            return do_actual_work("<stdin>", std::cin, vm, true);
+            return do_actual_work("<stdin>", std::cin, vm, true,
+                std::string(), outstream, errstream, resources, base_dir);
         }
         else {
             if (arguments.size() > 1) {
                 // this driver understands to parse one input file only
-                cerr << "wave: more than one input file specified, "
+                errstream << "wave: more than one input file specified, "
                      << "ignoring all but the first!" << endl;
             }
 
@@ -1569,18 +3463,36 @@ main (int argc, char *argv[])
 
             // preprocess the given input file
             if (!instream.is_open()) {
-                cerr << "wave: could not open input file: " << file_name << endl;
+                errstream << "wave: could not open input file: " << file_name << endl;
                 return -1;
             }
-            return do_actual_work(file_name, instream, vm, false);
+            return do_actual_work(file_name, instream, vm, false,
+                std::string(), outstream, errstream, resources, base_dir);
         }
     }
     catch (std::exception const &e) {
-        cout << "wave: exception caught: " << e.what() << endl;
+        outstream << "wave: exception caught: " << e.what() << endl;
         return 6;
     }
     catch (...) {
-        cerr << "wave: unexpected exception caught." << endl;
+        errstream << "wave: unexpected exception caught." << endl;
         return 7;
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+//  main entry point
+int
+main (int argc, char *argv[])
+{
+    // test Wave compilation configuration
+    if (!BOOST_WAVE_TEST_CONFIGURATION()) {
+        cout << "wave: warning: the library this application was linked against was compiled "
+             << endl
+             << "               using a different configuration (see wave_config.hpp)."
+             << endl;
+    }
+
+    return run_wave(std::vector<std::string>(argv + 1, argv + argc), cout,
+        cerr, 0, std::string());
+}
@@ -0,0 +1,143 @@
+/*=============================================================================
+    Boost.Wave: A Standard compliant C++ preprocessor library
+
+    wave-headermap: generate a header map from a list of include directories
+
+    http://www.boost.org/
+
+    Copyright (c) 2026 Jeff Trull. Distributed under the Boost
+    Software License, Version 1.0. (See accompanying file
+    LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+=============================================================================*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+
+#include <boost/wave/util/cpp_header_map.hpp>
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+///////////////////////////////////////////////////////////////////////////////
+//  Add all files found below the given include directory to the header map,
+//  mapping the file names relative to the directory (spelled with '/', as in
+//  an #include directive) to the absolute file names. The directories are
+//  processed in the order given, so the files in the earlier directories
+//  take precedence, just like in an include path search. Returns false (after
+//  reporting the error) if the directory couldn't be read completely.
+static bool
+add_directory(boost::wave::util::header_map_builder &builder,
+    fs::path const &dir, std::size_t &added, std::size_t &shadowed)
+{
+    boost::system::error_code ec;
+    fs::recursive_directory_iterator it(dir, ec), end;
+    for (/**/; !ec && it != end; it.increment(ec)) {
+        boost::system::error_code status_ec;
+        if (!fs::is_regular_file((*it).status(status_ec)) || status_ec)
+            continue;
+
+        // build the name relative to the include directory
+        std::string name;
+        fs::path const &file = (*it).path();
+        fs::path::const_iterator dir_end = dir.end();
+        fs::path::const_iterator fit = file.begin();
+        for (fs::path::const_iterator dit = dir.begin(); dit != dir_end; ++dit)
+            ++fit;
+        for (/**/; fit != file.end(); ++fit) {
+            if (!name.empty())
+                name += '/';
+            name += (*fit).string();
+        }
+
+        if (builder.add(name, file.string()))
+            ++added;
+        else
+            ++shadowed;
+    }
+
+    if (ec) {
+        std::cerr << "wave-headermap: could not read directory: "
+            << dir.string() << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[])
+{
+    po::options_description desc("Usage: wave-headermap [options] dir...");
+    desc.add_options()
+        ("help,h", "print out program usage (this message)")
+        ("output,o", po::value<std::string>(),
+            "the header map file to generate")
+        ("verbose,v", "print the number of files found per directory")
+        ;
+
+    po::options_description hidden;
+    hidden.add_options()
+        ("directory", po::value<std::vector<std::string> >()->composing(),
+            "include directories")
+        ;
+
+    po::options_description all;
+    all.add(desc).add(hidden);
+
+    po::positional_options_description positional;
+    positional.add("directory", -1);
+
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv)
+            .options(all).positional(positional).run(), vm);
+        po::notify(vm);
+    }
+    catch (std::exception const &e) {
+        std::cerr << "wave-headermap: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help") || !vm.count("output") || !vm.count("directory")) {
+        std::cout << desc << std::endl;
+        return vm.count("help") ? 0 : 1;
+    }
+
+    boost::wave::util::header_map_builder builder;
+    std::vector<std::string> const &dirs =
+        vm["directory"].as<std::vector<std::string> >();
+    std::vector<std::string>::const_iterator end = dirs.end();
+    for (std::vector<std::string>::const_iterator it = dirs.begin();
+         it != end; ++it)
+    {
+        boost::system::error_code ec;
+        fs::path dir = fs::canonical(fs::path(*it), ec);
+        if (ec || !fs::is_directory(dir)) {
+            std::cerr << "wave-headermap: not a directory: " << *it
+                << std::endl;
+            return 1;
+        }
+
+        std::size_t added = 0, shadowed = 0;
+        if (!add_directory(builder, dir, added, shadowed))
+            return 1;           // don't write an incomplete header map
+        if (vm.count("verbose")) {
+            std::cout << dir.string() << ": " << added << " files";
+            if (0 != shadowed)
+                std::cout << " (" << shadowed << " shadowed)";
+            std::cout << std::endl;
+        }
+    }
+
+    std::string const output = vm["output"].as<std::string>();
+    if (!builder.write(output)) {
+        std::cerr << "wave-headermap: could not write header map: "
+            << output << std::endl;
+        return 1;
+    }
+    return 0;
+}
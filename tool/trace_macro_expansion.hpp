@@ -17,6 +17,7 @@
 #include <string>
 #include <stack>
 #include <set>
+#include <vector>
 
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
@@ -26,6 +27,7 @@
 #include <boost/wave/token_ids.hpp>
 #include <boost/wave/util/macro_helpers.hpp>
 #include <boost/wave/util/filesystem_compatibility.hpp>
+#include <boost/wave/util/output_sink.hpp>
 #include <boost/wave/preprocessing_hooks.hpp>
 #include <boost/wave/whitespace_handling.hpp>
 #include <boost/wave/language_support.hpp>
@@ -55,7 +57,10 @@ enum trace_flags {
     trace_macros = 1,       // enable macro tracing
     trace_macro_counts = 2, // enable invocation counting
     trace_includes = 4,     // enable include file tracing
-    trace_guards = 8        // enable include guard tracing
+    trace_guards = 8,       // enable include guard tracing
+    trace_dependencies = 16,    // collect the names of all included files
+    trace_inputs = 32       // collect the opened files and detect the use of
+                            // the current time (for the output cache)
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -146,7 +151,7 @@ class trace_macro_expansion
 public:
     trace_macro_expansion(
             bool preserve_whitespace_, bool preserve_bol_whitespace_,
-            std::ofstream &output_, std::ostream &tracestrm_,
+            boost::wave::util::output_sink &output_, std::ostream &tracestrm_,
             std::ostream &includestrm_, std::ostream &guardstrm_,
             trace_flags flags_, bool enable_system_command_,
             bool& generate_output_, std::string const& default_outfile_)
@@ -158,7 +163,7 @@ public:
         preserve_bol_whitespace(preserve_bol_whitespace_),
         generate_output(generate_output_),
         default_outfile(default_outfile_),
-        emit_relative_filenames(false)
+        emit_relative_filenames(false), uses_volatile_input(false)
     {
     }
     ~trace_macro_expansion()
@@ -174,6 +179,25 @@ public:
         return counts;
     }
 
+    // the names of all opened include files in the order of their first
+    // inclusion (trace_dependencies only)
+    std::vector<std::string> const& get_dependencies() const
+    {
+        return dependencies;
+    }
+
+    // the complete names of all opened include files and whether the output
+    // depends on anything else than the input files, i.e. the current time
+    // or the effects of #pragma wave directives (trace_inputs only)
+    std::vector<std::string> const& get_input_files() const
+    {
+        return input_files;
+    }
+    bool is_reproducible() const
+    {
+        return !uses_volatile_input;
+    }
+
     void enable_relative_names_in_line_directives(bool flag)
     {
         emit_relative_filenames = flag;
@@ -347,6 +371,12 @@ public:
         TokenT const &macrodef, ContainerT const &definition,
         TokenT const &macrocall)
     {
+        if ((flags & trace_inputs) && !uses_volatile_input &&
+            (macrodef.get_value() == "__DATE__" ||
+             macrodef.get_value() == "__TIME__"))
+        {
+            uses_volatile_input = true;
+        }
         if (enabled_macro_counting() || !noexpandmacros.empty()) {
             std::string name (macrodef.get_value().c_str());
 
@@ -477,6 +507,11 @@ public:
         ContainerT values(valuetokens);
         boost::wave::util::impl::trim_sequence(values);    // trim whitespace
 
+        // the effects of most of these (the timer, trace, system and output
+        // options) can't be reproduced from the input files
+        if (flags & trace_inputs)
+            uses_volatile_input = true;
+
         if (option.get_value() == "timer") {
             // #pragma wave timer(value)
             if (0 == values.size()) {
@@ -630,6 +665,15 @@ public:
 
             includestrm << std::endl;
         }
+        if ((flags & trace_dependencies) && dependency_names.insert(relname).second)
+            dependencies.push_back(relname);
+        if (flags & trace_inputs) {
+            std::string name(boost::wave::util::complete_path(
+                boost::wave::util::create_path(absname),
+                ctx.get_base_directory()).string());
+            if (input_file_names.insert(name).second)
+                input_files.push_back(name);
+        }
     }
 
 #if BOOST_WAVE_SUPPORT_PRAGMA_ONCE != 0
@@ -1015,7 +1059,7 @@ protected:
 
         // write license text, if file was created and if requested
         if (mode == std::ios::out && !license_info.empty())
-            outputstrm << license_info;
+            outputstrm.write(license_info);
 
         generate_output = true;
         current_outfile = fpath;
@@ -1398,7 +1442,7 @@ protected:
     }
 
 private:
-    std::ofstream &outputstrm;      // main output stream
+    boost::wave::util::output_sink &outputstrm;     // main output stream
     std::ostream &tracestrm;        // trace output stream
     std::ostream &includestrm;      // included list output stream
     std::ostream &guardstrm;        // include guard output stream
@@ -1425,6 +1469,12 @@ private:
 
     std::set<std::string> noexpandmacros;   // list of macros not to expand
 
+    std::vector<std::string> dependencies;  // all included files
+    std::set<std::string> dependency_names; // dito, for fast lookup
+    std::vector<std::string> input_files;   // all opened files (complete names)
+    std::set<std::string> input_file_names; // dito, for fast lookup
+    bool uses_volatile_input;       // output depends on more than the input
+
     std::string license_info;       // text to pre-pend to all generated output files
 };
 